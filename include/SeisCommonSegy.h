@@ -9,6 +9,7 @@
 #define SEIS_COMMON_SEGY_H
 
 #include <SeisTrace.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -70,6 +71,21 @@ typedef struct SeisSegyBinHdr {
         int32_t num_of_trailer_stanza;
 } SeisSegyBinHdr;
 
+/**
+ * \struct SeisSegyRawTrace
+ * \brief Trace record as it is stored in file. Memory is owned by reader
+ * and stays valid until next reading call.
+ */
+typedef struct SeisSegyRawTrace {
+        char const *headers; /**< main header and additional headers */
+        size_t headers_size;
+        char const *samples; /**< samples in file format and byte order */
+        size_t samples_size;
+        long long samp_num;
+        int format_code;
+        bool big_endian;
+} SeisSegyRawTrace;
+
 /**
  * \enum SeisSegyErrCode
  * \brief Enumeration for error codes.
@@ -86,6 +102,33 @@ typedef enum SeisSegyErrCode {
         SEIS_SEGY_ERR_BAD_PARAMS,
 } SeisSegyErrCode;
 
+/**
+ * \enum SeisSegyIOMode
+ * \brief How reader gets bytes from file.
+ * SEIS_SEGY_IO_STDIO reads file by large blocks into internal buffer.
+ * SEIS_SEGY_IO_MMAP maps whole file and decodes straight from the mapping.
+ * SEIS_SEGY_IO_DIRECT reads blocks bypassing page cache. Use it for single
+ * pass over big files to keep cache for other users.
+ */
+typedef enum SeisSegyIOMode {
+        SEIS_SEGY_IO_STDIO,
+        SEIS_SEGY_IO_MMAP,
+        SEIS_SEGY_IO_DIRECT,
+} SeisSegyIOMode;
+
+/**
+ * \enum SeisSegyAccessHint
+ * \brief Expected access pattern. Passed to kernel as advice.
+ * SEIS_SEGY_ACCESS_WILLNEED and SEIS_SEGY_ACCESS_DONTNEED are meant for ranges.
+ */
+typedef enum SeisSegyAccessHint {
+        SEIS_SEGY_ACCESS_NORMAL,
+        SEIS_SEGY_ACCESS_SEQUENTIAL,
+        SEIS_SEGY_ACCESS_RANDOM,
+        SEIS_SEGY_ACCESS_WILLNEED,
+        SEIS_SEGY_ACCESS_DONTNEED,
+} SeisSegyAccessHint;
+
 /**
  * \struct SeisSegyErr
  * \brief Type for SEGY manipulations error checking.
@@ -102,7 +145,7 @@ typedef struct SeisSegyErr {
 typedef struct SeisCommonSegy {
         struct SeisSegyBinHdr bin_hdr;
         struct SeisSegyErr err;
-        FILE *file;
+        struct SeisSegyBackend *backend;
         char *samp_buf, *hdr_buf;
         int bytes_per_sample;
         long samp_per_tr;
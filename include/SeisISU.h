@@ -9,6 +9,10 @@
 #define SEIS_ISU_H
 
 #include "SeisCommonSegy.h"
+#include "SeisSegyBackend.h"
+#include "SeisSegyFloatTrace.h"
+#include "SeisSegyLazyHeader.h"
+#include "SeisSegyStdHeader.h"
 #include <SeisTrace.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -48,15 +52,76 @@ void seis_isu_unref(SeisISU **su);
  */
 SeisSegyErr const *seis_isu_get_error(SeisISU const *su);
 
+/**
+ * \fn seis_isu_set_io_mode
+ * \brief Sets the way file is read. Must be called before open.
+ * \param su SeisISU instance.
+ * \param mode IO mode. SEIS_SEGY_IO_STDIO by default.
+ */
+void seis_isu_set_io_mode(SeisISU *su, SeisSegyIOMode mode);
+
+/**
+ * \fn seis_isu_set_buffer_size
+ * \brief Sets size of read buffer for SEIS_SEGY_IO_STDIO and DIRECT modes.
+ * Headers and samples are served from buffer, file is read only when buffer
+ * is exhausted. Must be called before open.
+ * \param su SeisISU instance.
+ * \param size Buffer size in bytes. 4 MiB by default, 0 resets to default.
+ */
+void seis_isu_set_buffer_size(SeisISU *su, size_t size);
+
+/**
+ * \fn seis_isu_set_read_ahead
+ * \brief Enables background reading of next buffer. Not used with mmap.
+ * Separate thread fills second buffer of the same size while current one is
+ * decoded. Offset change restarts read ahead at new position.
+ * Must be called before open.
+ * \param su SeisISU instance.
+ * \param enable Disabled by default.
+ */
+void seis_isu_set_read_ahead(SeisISU *su, bool enable);
+
+/**
+ * \fn seis_isu_set_seek_index
+ * \brief Sets file to keep seek index of gzip compressed input in.
+ * Must be called before open.
+ * \param su SeisISU instance.
+ * \param file_name NULLable. Index is kept in memory only by default.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isu_set_seek_index(SeisISU *su, char const *file_name);
+
+/**
+ * \fn seis_isu_set_access_hint
+ * \brief Tells kernel how traces are going to be read.
+ * Sequential is used after open. Switch to random for indexed access.
+ * \param su SeisISU instance.
+ * \param hint Expected access pattern.
+ */
+void seis_isu_set_access_hint(SeisISU *su, SeisSegyAccessHint hint);
+
 /**
  * \fn seis_isu_open
  * \brief Opens file, prepares for trace reading.
+ * Pipes and other files without size are read as stream, forward only.
+ * Gzip compressed files are decompressed on the fly.
  * \param sgy SeisISU instance.
- * \param file_name Name of file to open.
+ * \param file_name Name of file to open. "-" means standard input.
  * \return Error code.
  */
 SeisSegyErrCode seis_isu_open(SeisISU *su, char const *file_name);
 
+/**
+ * \fn seis_isu_open_backend
+ * \brief Same as open, but data comes from backend instead of file.
+ * IO mode is ignored. Backend with view is read without copying.
+ * Backend of unknown size is read as stream.
+ * \param su SeisISU instance.
+ * \param backend Storage to read from. Reader keeps reference to it.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isu_open_backend(SeisISU *su, SeisSegyBackend *backend);
+
 /**
  * \fn seis_isu_read_trace
  * \brief Reads current trace from file.
@@ -65,6 +130,56 @@ SeisSegyErrCode seis_isu_open(SeisISU *su, char const *file_name);
  */
 SeisTrace *seis_isu_read_trace(SeisISU *su);
 
+/**
+ * \fn seis_isu_read_trace_float
+ * \brief Reads current trace from file with samples converted to float.
+ * Values of 64 bit formats are rounded.
+ * \param sgy SeisISU instance.
+ * \return NULLable. You should free this memory.
+ */
+SeisSegyFloatTrace *seis_isu_read_trace_float(SeisISU *su);
+
+/**
+ * \fn seis_isu_read_trace_into
+ * \brief Reads current trace into caller storage. Nothing is allocated, so
+ * same header and buffer can be used for all traces.
+ * \param su SeisISU instance.
+ * \param hdr Header to fill. Values from previous trace are overwritten.
+ * \param samples Buffer for samples.
+ * \param capacity Number of samples buffer can hold.
+ * \param samp_num Receives number of samples in trace. It is set even if
+ * buffer is too small, then SEIS_SEGY_ERR_BAD_PARAMS is returned.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isu_read_trace_into(SeisISU *su, SeisTraceHeader *hdr,
+                                         double *samples, size_t capacity,
+                                         size_t *samp_num);
+
+/**
+ * \fn seis_isu_read_trace_into_float
+ * \brief Same as seis_isu_read_trace_into with float samples.
+ * \param su SeisISU instance.
+ * \param hdr Header to fill. Values from previous trace are overwritten.
+ * \param samples Buffer for samples.
+ * \param capacity Number of samples buffer can hold.
+ * \param samp_num Receives number of samples in trace.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isu_read_trace_into_float(SeisISU *su,
+                                               SeisTraceHeader *hdr,
+                                               float *samples, size_t capacity,
+                                               size_t *samp_num);
+
+/**
+ * \fn seis_isu_read_raw_trace
+ * \brief Reads current trace without decoding. Header values and samples
+ * are left as they are in file, so records could be forwarded unchanged.
+ * \param su SeisISU instance.
+ * \param raw Receives pointers to record parts and its format.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isu_read_raw_trace(SeisISU *su, SeisSegyRawTrace *raw);
+
 /**
  * \fn seis_isu_read_trace_header
  * \brief Reads current trace header from file.
@@ -73,6 +188,25 @@ SeisTrace *seis_isu_read_trace(SeisISU *su);
  */
 SeisTraceHeader *seis_isu_read_trace_header(SeisISU *su);
 
+/**
+ * \fn seis_isu_read_lazy_header
+ * \brief Reads current trace header without decoding and skips samples.
+ * Fields are decoded when asked for.
+ * \param su SeisISU instance.
+ * \return NULLable. You should free this memory.
+ */
+SeisSegyLazyHeader *seis_isu_read_lazy_header(SeisISU *su);
+
+/**
+ * \fn seis_isu_read_std_header
+ * \brief Reads current trace header into standard layout struct and skips
+ * samples. Nothing is allocated and trace header map is not used.
+ * \param su SeisISU instance.
+ * \param hdr Pointer to SeisSegyStdHeader to fill.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isu_read_std_header(SeisISU *su, SeisSegyStdHeader *hdr);
+
 /**
  * \fn seis_isu_end_of_data
  * \brief Checks if it is possible to read one more trace.
@@ -101,4 +235,17 @@ void seis_isu_rewind(SeisISU *su);
 SeisSegyErrCode seis_isu_remap_trace_header(SeisISU *su, char const *hdr_name,
                                             int offset, enum FORMAT fmt);
 
+/**
+ * \fn seis_isu_set_header_fields
+ * \brief Limits trace header decoding to given fields. Samples number is
+ * always decoded.
+ * \param su SeisISU instance.
+ * \param names Names of fields to decode. NULL to decode all fields.
+ * \param num Number of names.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isu_set_header_fields(SeisISU *su,
+                                           char const *const *names,
+                                           size_t num);
+
 #endif /* SEIS_ISU_H */
@@ -9,6 +9,10 @@
 #define SEIS_ISEGY_H
 
 #include "SeisCommonSegy.h"
+#include "SeisSegyBackend.h"
+#include "SeisSegyFloatTrace.h"
+#include "SeisSegyLazyHeader.h"
+#include "SeisSegyStdHeader.h"
 #include <SeisTrace.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -48,15 +52,82 @@ void seis_isegy_unref(SeisISegy **sgy);
  */
 SeisSegyErr const *seis_isegy_get_error(SeisISegy const *sgy);
 
+/**
+ * \fn seis_isegy_set_io_mode
+ * \brief Sets the way file is read. Must be called before open.
+ * \param sgy SeisISegy instance.
+ * \param mode IO mode. SEIS_SEGY_IO_STDIO by default.
+ */
+void seis_isegy_set_io_mode(SeisISegy *sgy, SeisSegyIOMode mode);
+
+/**
+ * \fn seis_isegy_set_buffer_size
+ * \brief Sets size of read buffer for SEIS_SEGY_IO_STDIO and DIRECT modes.
+ * Headers and samples are served from buffer, file is read only when buffer
+ * is exhausted. Must be called before open.
+ * \param sgy SeisISegy instance.
+ * \param size Buffer size in bytes. 4 MiB by default, 0 resets to default.
+ */
+void seis_isegy_set_buffer_size(SeisISegy *sgy, size_t size);
+
+/**
+ * \fn seis_isegy_set_read_ahead
+ * \brief Enables background reading of next buffer. Not used with mmap.
+ * Separate thread fills second buffer of the same size while current one is
+ * decoded. Offset change restarts read ahead at new position.
+ * Must be called before open.
+ * \param sgy SeisISegy instance.
+ * \param enable Disabled by default.
+ */
+void seis_isegy_set_read_ahead(SeisISegy *sgy, bool enable);
+
+/**
+ * \fn seis_isegy_set_seek_index
+ * \brief Sets file to keep seek index of gzip compressed input in. Index is
+ * built on first open and loaded on next ones, so random access doesn't
+ * need whole file decompression. Must be called before open.
+ * \param sgy SeisISegy instance.
+ * \param file_name NULLable. Index is kept in memory only by default.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isegy_set_seek_index(SeisISegy *sgy,
+                                          char const *file_name);
+
+/**
+ * \fn seis_isegy_set_access_hint
+ * \brief Tells kernel how traces are going to be read.
+ * Sequential is used after open. Switch to random for indexed access.
+ * \param sgy SeisISegy instance.
+ * \param hint Expected access pattern.
+ */
+void seis_isegy_set_access_hint(SeisISegy *sgy, SeisSegyAccessHint hint);
+
 /**
  * \fn seis_isegy_open
  * \brief Opens file, loads headers, prepares for trace reading.
+ * Pipes and other files without size are read as stream: traces go forward
+ * only, end of data is found when input ends or when num_of_tr_in_file
+ * traces are read, trailer stanzas become available after last trace.
+ * Positional and asynchronous reading is not possible for streams.
+ * Gzip compressed files are decompressed on the fly in any IO mode.
  * \param sgy SeisISegy instance.
- * \param file_name Name of file to open.
+ * \param file_name Name of file to open. "-" means standard input.
  * \return Error code.
  */
 SeisSegyErrCode seis_isegy_open(SeisISegy *sgy, char const *file_name);
 
+/**
+ * \fn seis_isegy_open_backend
+ * \brief Same as open, but data comes from backend instead of file.
+ * IO mode is ignored. Backend with view is read without copying.
+ * Backend of unknown size is read as stream.
+ * \param sgy SeisISegy instance.
+ * \param backend Storage to read from. Reader keeps reference to it.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isegy_open_backend(SeisISegy *sgy,
+                                        SeisSegyBackend *backend);
+
 /**
  * \fn seis_isegy_read_trace
  * \brief Reads current trace from file.
@@ -65,6 +136,58 @@ SeisSegyErrCode seis_isegy_open(SeisISegy *sgy, char const *file_name);
  */
 SeisTrace *seis_isegy_read_trace(SeisISegy *sgy);
 
+/**
+ * \fn seis_isegy_read_trace_float
+ * \brief Reads current trace from file with samples converted to float.
+ * Values of 64 bit formats are rounded.
+ * \param sgy SeisISegy instance.
+ * \return NULLable. You should free this memory.
+ */
+SeisSegyFloatTrace *seis_isegy_read_trace_float(SeisISegy *sgy);
+
+/**
+ * \fn seis_isegy_read_trace_into
+ * \brief Reads current trace into caller storage. Nothing is allocated, so
+ * same header and buffer can be used for all traces.
+ * \param sgy SeisISegy instance.
+ * \param hdr Header to fill. Values from previous trace are overwritten.
+ * \param samples Buffer for samples.
+ * \param capacity Number of samples buffer can hold.
+ * \param samp_num Receives number of samples in trace. It is set even if
+ * buffer is too small, then SEIS_SEGY_ERR_BAD_PARAMS is returned.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isegy_read_trace_into(SeisISegy *sgy, SeisTraceHeader *hdr,
+                                           double *samples, size_t capacity,
+                                           size_t *samp_num);
+
+/**
+ * \fn seis_isegy_read_trace_into_float
+ * \brief Same as seis_isegy_read_trace_into with float samples.
+ * \param sgy SeisISegy instance.
+ * \param hdr Header to fill. Values from previous trace are overwritten.
+ * \param samples Buffer for samples.
+ * \param capacity Number of samples buffer can hold.
+ * \param samp_num Receives number of samples in trace.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isegy_read_trace_into_float(SeisISegy *sgy,
+                                                 SeisTraceHeader *hdr,
+                                                 float *samples,
+                                                 size_t capacity,
+                                                 size_t *samp_num);
+
+/**
+ * \fn seis_isegy_read_raw_trace
+ * \brief Reads current trace without decoding. Header values and samples
+ * are left as they are in file, so records could be forwarded unchanged.
+ * \param sgy SeisISegy instance.
+ * \param raw Receives pointers to record parts and its format.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isegy_read_raw_trace(SeisISegy *sgy,
+                                          SeisSegyRawTrace *raw);
+
 /**
  * \fn seis_isegy_read_trace_header
  * \brief Reads current trace header from file.
@@ -73,6 +196,26 @@ SeisTrace *seis_isegy_read_trace(SeisISegy *sgy);
  */
 SeisTraceHeader *seis_isegy_read_trace_header(SeisISegy *sgy);
 
+/**
+ * \fn seis_isegy_read_lazy_header
+ * \brief Reads current trace header without decoding and skips samples.
+ * Fields are decoded when asked for.
+ * \param sgy SeisISegy instance.
+ * \return NULLable. You should free this memory.
+ */
+SeisSegyLazyHeader *seis_isegy_read_lazy_header(SeisISegy *sgy);
+
+/**
+ * \fn seis_isegy_read_std_header
+ * \brief Reads current trace header into standard layout struct and skips
+ * samples. Nothing is allocated and trace header map is not used.
+ * \param sgy SeisISegy instance.
+ * \param hdr Pointer to SeisSegyStdHeader to fill.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isegy_read_std_header(SeisISegy *sgy,
+                                           SeisSegyStdHeader *hdr);
+
 /**
  * \fn seis_isegy_get_text_headers_num
  * \brief gets number of text headers in SEGY
@@ -93,6 +236,7 @@ char const *seis_isegy_get_text_header(SeisISegy const *sgy, size_t idx);
 /**
  * \fn seis_isegy_get_stanzas_num
  * \brief gets number of trailer stanzas in SEGY
+ * Streams have stanzas read only after end of data is reached.
  * \param sgy SeisISegy instance.
  * return number of trailer stanzas in file.
  */
@@ -145,6 +289,20 @@ SeisSegyErrCode seis_isegy_remap_trace_header(SeisISegy *sgy,
                                               char const *hdr_name, int hdr_num,
                                               int offset, enum FORMAT fmt);
 
+/**
+ * \fn seis_isegy_set_header_fields
+ * \brief Limits trace header decoding to given fields. Other fields are
+ * not set in read headers. Samples number and number of additional headers
+ * are always decoded, reader needs them.
+ * \param sgy SeisISegy instance.
+ * \param names Names of fields to decode. NULL to decode all fields.
+ * \param num Number of names.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isegy_set_header_fields(SeisISegy *sgy,
+                                             char const *const *names,
+                                             size_t num);
+
 /**
  * \fn seis_isegy_get_offset
  * \brief gets current file offset to come back later and read the same trace
@@ -162,4 +320,45 @@ size_t seis_isegy_get_offset(SeisISegy *sgy);
  */
 void seis_isegy_set_offset(SeisISegy *sgy, size_t offset);
 
+/**
+ * \fn seis_isegy_get_trace_offset
+ * \brief gets file offset of trace by its index
+ * Valid for fixed trace length files only. For variable trace length files
+ * walk traces with next_offset of positional reads.
+ * \param sgy SeisISegy instance
+ * \param idx index of trace. First trace has index 0.
+ * \return file offset
+ */
+size_t seis_isegy_get_trace_offset(SeisISegy const *sgy, size_t idx);
+
+/**
+ * \fn seis_isegy_read_trace_at
+ * \brief Reads trace located at file offset.
+ * Doesn't change current position and shared buffers, so the same instance
+ * could be used from many threads at once.
+ * \param sgy SeisISegy instance.
+ * \param offset file offset of trace.
+ * \param next_offset NULLable. Receives file offset of next trace.
+ * \param err Per call error. Filled with error code and message.
+ * \return NULLable. You should free this memory.
+ */
+SeisTrace *seis_isegy_read_trace_at(SeisISegy const *sgy, size_t offset,
+                                    size_t *next_offset, SeisSegyErr *err);
+
+/**
+ * \fn seis_isegy_read_trace_header_at
+ * \brief Reads trace header located at file offset.
+ * Doesn't change current position and shared buffers, so the same instance
+ * could be used from many threads at once.
+ * \param sgy SeisISegy instance.
+ * \param offset file offset of trace.
+ * \param next_offset NULLable. Receives file offset of next trace.
+ * \param err Per call error. Filled with error code and message.
+ * \return NULLable. You should free this memory.
+ */
+SeisTraceHeader *seis_isegy_read_trace_header_at(SeisISegy const *sgy,
+                                                 size_t offset,
+                                                 size_t *next_offset,
+                                                 SeisSegyErr *err);
+
 #endif /* SEIS_ISEGY_H */
@@ -0,0 +1,109 @@
+/**
+ * \file SeisISegyAsync.h
+ * \brief Batched asynchronous trace reading.
+ * \author andalevor
+ * \date 2026\10\17
+ */
+
+#ifndef SEIS_ISEGY_ASYNC_H
+#define SEIS_ISEGY_ASYNC_H
+
+#include "SeisCommonSegy.h"
+#include "SeisISegy.h"
+#include <SeisTrace.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * \struct SeisISegyAsync
+ * \brief Keeps many trace reads in flight and hands back decoded traces.
+ * Uses io_uring when library is built with liburing and kernel supports it.
+ * Otherwise pool of threads with positional reads is used.
+ */
+typedef struct SeisISegyAsync SeisISegyAsync;
+
+/**
+ * \fn seis_isegy_async_new
+ * \brief Initiates SeisISegyAsync instance for opened SeisISegy.
+ * \param sgy Opened SeisISegy instance. Engine keeps reference to it.
+ * \param queue_depth Max number of reads in flight.
+ * \return NULLable.
+ */
+SeisISegyAsync *seis_isegy_async_new(SeisISegy *sgy, unsigned queue_depth);
+
+/**
+ * \fn seis_isegy_async_ref
+ * \brief Makes rc increment.
+ * \param as Pointer to SeisISegyAsync object.
+ * \return nonNULL. Pointer to SeisISegyAsync object.
+ */
+SeisISegyAsync *seis_isegy_async_ref(SeisISegyAsync *as);
+
+/**
+ * \fn seis_isegy_async_unref
+ * \brief Decrements rc. Waits for reads in flight and frees memory.
+ * \param as Pointer to SeisISegyAsync object.
+ */
+void seis_isegy_async_unref(SeisISegyAsync **as);
+
+/**
+ * \fn seis_isegy_async_get_error
+ * \brief Gets SeisSegyErr structure for error checking.
+ * \return nonNULL. You should not free this memory.
+ */
+SeisSegyErr const *seis_isegy_async_get_error(SeisISegyAsync const *as);
+
+/**
+ * \fn seis_isegy_async_uses_io_uring
+ * \brief Checks which engine serves the reads.
+ * \param as SeisISegyAsync instance.
+ * \return true for io_uring, false for thread pool.
+ */
+bool seis_isegy_async_uses_io_uring(SeisISegyAsync const *as);
+
+/**
+ * \fn seis_isegy_async_submit_offsets
+ * \brief Queues reads of traces located at file offsets.
+ * Every request gets sequence number. First request ever submitted gets 0.
+ * \param as SeisISegyAsync instance.
+ * \param offsets Array of file offsets.
+ * \param num Number of offsets.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isegy_async_submit_offsets(SeisISegyAsync *as,
+                                                size_t const *offsets,
+                                                size_t num);
+
+/**
+ * \fn seis_isegy_async_submit_indices
+ * \brief Queues reads of traces by their indices.
+ * Works for fixed trace length files only.
+ * \param as SeisISegyAsync instance.
+ * \param indices Array of trace indices. First trace has index 0.
+ * \param num Number of indices.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isegy_async_submit_indices(SeisISegyAsync *as,
+                                                size_t const *indices,
+                                                size_t num);
+
+/**
+ * \fn seis_isegy_async_pending
+ * \brief Gets number of submitted traces which are not reaped yet.
+ * \param as SeisISegyAsync instance.
+ * \return number of pending traces.
+ */
+size_t seis_isegy_async_pending(SeisISegyAsync const *as);
+
+/**
+ * \fn seis_isegy_async_reap
+ * \brief Waits for any submitted trace and returns it.
+ * Traces come in order of completion, not submission.
+ * \param as SeisISegyAsync instance.
+ * \param seq NULLable. Receives sequence number of request.
+ * \return NULLable. NULL on error or if nothing is pending. You should free
+ * this memory.
+ */
+SeisTrace *seis_isegy_async_reap(SeisISegyAsync *as, size_t *seq);
+
+#endif /* SEIS_ISEGY_ASYNC_H */
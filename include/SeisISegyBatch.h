@@ -0,0 +1,78 @@
+/**
+ * \file SeisISegyBatch.h
+ * \brief Reading of consecutive traces with parallel decoding.
+ * \author andalevor
+ * \date 2026\10\17
+ */
+
+#ifndef SEIS_ISEGY_BATCH_H
+#define SEIS_ISEGY_BATCH_H
+
+#include "SeisCommonSegy.h"
+#include "SeisISegy.h"
+#include <SeisTrace.h>
+#include <stddef.h>
+
+/**
+ * \struct SeisISegyBatch
+ * \brief Reads many trace records with single file read and decodes their
+ * headers and samples with pool of threads. Works for fixed trace length
+ * files only.
+ */
+typedef struct SeisISegyBatch SeisISegyBatch;
+
+/**
+ * \fn seis_isegy_batch_new
+ * \brief Initiates SeisISegyBatch instance for opened SeisISegy.
+ * \param sgy Opened SeisISegy instance. Batch keeps reference to it.
+ * \param threads_num Number of decoding threads including calling one.
+ * 0 means number of online processors.
+ * \return NULLable.
+ */
+SeisISegyBatch *seis_isegy_batch_new(SeisISegy *sgy, unsigned threads_num);
+
+/**
+ * \fn seis_isegy_batch_ref
+ * \brief Makes rc increment.
+ * \param batch Pointer to SeisISegyBatch object.
+ * \return nonNULL. Pointer to SeisISegyBatch object.
+ */
+SeisISegyBatch *seis_isegy_batch_ref(SeisISegyBatch *batch);
+
+/**
+ * \fn seis_isegy_batch_unref
+ * \brief Decrements rc. Stops threads and frees memory.
+ * \param batch Pointer to SeisISegyBatch object.
+ */
+void seis_isegy_batch_unref(SeisISegyBatch **batch);
+
+/**
+ * \fn seis_isegy_batch_get_error
+ * \brief Gets SeisSegyErr structure for error checking.
+ * \return nonNULL. You should not free this memory.
+ */
+SeisSegyErr const *seis_isegy_batch_get_error(SeisISegyBatch const *batch);
+
+/**
+ * \fn seis_isegy_batch_get_threads_num
+ * \brief Gets number of decoding threads including calling one.
+ * \param batch SeisISegyBatch instance.
+ * \return number of threads.
+ */
+unsigned seis_isegy_batch_get_threads_num(SeisISegyBatch const *batch);
+
+/**
+ * \fn seis_isegy_batch_read
+ * \brief Reads num consecutive traces and decodes them in parallel.
+ * Doesn't change sequential reading position of SeisISegy.
+ * \param batch SeisISegyBatch instance.
+ * \param first Index of first trace. First trace in file has index 0.
+ * \param num Number of traces.
+ * \param traces Array of num pointers. Receives decoded traces in file order.
+ * You should free them. On error all pointers are set to NULL.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isegy_batch_read(SeisISegyBatch *batch, size_t first,
+                                      size_t num, SeisTrace **traces);
+
+#endif /* SEIS_ISEGY_BATCH_H */
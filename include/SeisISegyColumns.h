@@ -0,0 +1,53 @@
+/**
+ * \file SeisISegyColumns.h
+ * \brief Extraction of trace header fields of whole file into arrays.
+ * \author andalevor
+ * \date 2026\10\17
+ */
+
+#ifndef SEIS_ISEGY_COLUMNS_H
+#define SEIS_ISEGY_COLUMNS_H
+
+#include "SeisCommonSegy.h"
+#include "SeisISegy.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * \struct SeisSegyHeaderColumn
+ * \brief Values of one trace header field for all traces of file. Only
+ * name is set by caller, other members are filled by extraction. Type of
+ * column is type of last field with name in trace header map. Traces
+ * without such field get 0.
+ */
+typedef struct SeisSegyHeaderColumn {
+        char const *name; /**< name of trace header field */
+        bool is_real;     /**< reals is filled instead of ints */
+        long long *ints;  /**< one value per trace, free with free() */
+        double *reals;    /**< one value per trace, free with free() */
+} SeisSegyHeaderColumn;
+
+/**
+ * \fn seis_isegy_extract_header_columns
+ * \brief Reads selected trace header fields of all traces. Only header
+ * bytes are read, samples are skipped. Reading doesn't change current
+ * position of reader and needs seekable input. Headers of fixed trace
+ * length files are read by pool of threads, variable trace length files
+ * are walked from trace to trace by calling thread.
+ * \param sgy Opened SeisISegy instance.
+ * \param columns Array of columns with names set.
+ * \param columns_num Number of columns.
+ * \param threads_num Number of reading threads including calling one.
+ * 0 means number of online processors.
+ * \param traces_num Receives number of traces, it is size of every array.
+ * \param err Receives error. Arrays are freed and set to NULL on error.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_isegy_extract_header_columns(SeisISegy const *sgy,
+                                                  SeisSegyHeaderColumn *columns,
+                                                  size_t columns_num,
+                                                  unsigned threads_num,
+                                                  size_t *traces_num,
+                                                  SeisSegyErr *err);
+
+#endif /* SEIS_ISEGY_COLUMNS_H */
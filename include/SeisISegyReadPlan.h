@@ -0,0 +1,88 @@
+/**
+ * \file SeisISegyReadPlan.h
+ * \brief Reading of scattered traces with merged file reads.
+ * \author andalevor
+ * \date 2026\10\17
+ */
+
+#ifndef SEIS_ISEGY_READ_PLAN_H
+#define SEIS_ISEGY_READ_PLAN_H
+
+#include "SeisCommonSegy.h"
+#include "SeisISegy.h"
+#include <SeisTrace.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * \struct SeisISegyReadPlan
+ * \brief Set of requested traces sorted by file offset and merged into big
+ * reads. Traces are handed back in requested order.
+ * Works for fixed trace length files only.
+ */
+typedef struct SeisISegyReadPlan SeisISegyReadPlan;
+
+/**
+ * \fn seis_isegy_read_plan_new
+ * \brief Builds plan and asks kernel to start reading merged ranges.
+ * \param sgy Opened SeisISegy instance. Plan keeps reference to it.
+ * \param indices Array of trace indices. First trace has index 0.
+ * \param num Number of indices.
+ * \param max_gap Records separated by not more than max_gap bytes are read
+ * with single request. Bytes between them are read and dropped.
+ * \return NULLable. Plan errors are reported by
+ * seis_isegy_read_plan_get_error.
+ */
+SeisISegyReadPlan *seis_isegy_read_plan_new(SeisISegy *sgy,
+                                            size_t const *indices, size_t num,
+                                            size_t max_gap);
+
+/**
+ * \fn seis_isegy_read_plan_ref
+ * \brief Makes rc increment.
+ * \param plan Pointer to SeisISegyReadPlan object.
+ * \return nonNULL. Pointer to SeisISegyReadPlan object.
+ */
+SeisISegyReadPlan *seis_isegy_read_plan_ref(SeisISegyReadPlan *plan);
+
+/**
+ * \fn seis_isegy_read_plan_unref
+ * \brief Decrements rc and frees memory.
+ * \param plan Pointer to SeisISegyReadPlan object.
+ */
+void seis_isegy_read_plan_unref(SeisISegyReadPlan **plan);
+
+/**
+ * \fn seis_isegy_read_plan_get_error
+ * \brief Gets SeisSegyErr structure for error checking.
+ * \return nonNULL. You should not free this memory.
+ */
+SeisSegyErr const *
+seis_isegy_read_plan_get_error(SeisISegyReadPlan const *plan);
+
+/**
+ * \fn seis_isegy_read_plan_get_ranges_num
+ * \brief Gets number of file reads plan needs.
+ * \param plan SeisISegyReadPlan instance.
+ * \return number of merged ranges.
+ */
+size_t seis_isegy_read_plan_get_ranges_num(SeisISegyReadPlan const *plan);
+
+/**
+ * \fn seis_isegy_read_plan_end
+ * \brief Checks if all planned traces are read.
+ * \param plan SeisISegyReadPlan instance.
+ * \return true if nothing is left.
+ */
+bool seis_isegy_read_plan_end(SeisISegyReadPlan const *plan);
+
+/**
+ * \fn seis_isegy_read_plan_next
+ * \brief Reads next trace in requested order.
+ * \param plan SeisISegyReadPlan instance.
+ * \return NULLable. NULL on error or at the end of plan. You should free this
+ * memory.
+ */
+SeisTrace *seis_isegy_read_plan_next(SeisISegyReadPlan *plan);
+
+#endif /* SEIS_ISEGY_READ_PLAN_H */
@@ -9,6 +9,9 @@
 #define SEIS_OSU_H
 
 #include "SeisCommonSegy.h"
+#include "SeisSegyBackend.h"
+#include "SeisSegyFloatTrace.h"
+#include "SeisSegyStdHeader.h"
 #include <SeisTrace.h>
 
 /**
@@ -56,6 +59,15 @@ SeisSegyErr const *seis_osu_get_error(SeisOSU const *su);
  */
 SeisSegyErrCode seis_osu_open(SeisOSU *su, char const *file_name);
 
+/**
+ * \fn seis_osu_open_backend
+ * \brief Same as open, but data goes to backend instead of file.
+ * \param su SeisOSU instance.
+ * \param backend Storage to write to. Writer keeps reference to it.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_osu_open_backend(SeisOSU *su, SeisSegyBackend *backend);
+
 /**
  * \fn seis_osu_write_trace
  * \brief Writes given trace to the file.
@@ -65,6 +77,31 @@ SeisSegyErrCode seis_osu_open(SeisOSU *su, char const *file_name);
  */
 SeisSegyErrCode seis_osu_write_trace(SeisOSU *su, SeisTrace *trc);
 
+/**
+ * \fn seis_osu_write_trace_float
+ * \brief Writes trace with float samples to the file.
+ * \param su pointer to SeisOSU instance.
+ * \param trc Pointer to trace to write.
+ * \return error code to check
+ */
+SeisSegyErrCode seis_osu_write_trace_float(SeisOSU *su,
+                                           SeisSegyFloatTrace *trc);
+
+/**
+ * \fn seis_osu_write_trace_std
+ * \brief Writes trace with standard layout header. Trace header map is not
+ * used.
+ * \param su pointer to SeisOSU instance.
+ * \param hdr Pointer to header to write.
+ * \param samples Samples of trace.
+ * \param samp_num Number of samples.
+ * \return error code to check
+ */
+SeisSegyErrCode seis_osu_write_trace_std(SeisOSU *su,
+                                         SeisSegyStdHeader const *hdr,
+                                         double const *samples,
+                                         long long samp_num);
+
 /**
  * \fn seis_osu_remap_trace_header
  * \brief changes header reading parameters
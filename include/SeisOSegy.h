@@ -9,6 +9,9 @@
 #define SEIS_OSEGY_H
 
 #include "SeisCommonSegy.h"
+#include "SeisSegyBackend.h"
+#include "SeisSegyFloatTrace.h"
+#include "SeisSegyStdHeader.h"
 #include <SeisTrace.h>
 
 /**
@@ -72,6 +75,16 @@ void seis_osegy_set_text_header(SeisOSegy *sgy, char const *hdr);
  */
 SeisSegyErrCode seis_osegy_open(SeisOSegy *sgy, char const *file_name);
 
+/**
+ * \fn seis_osegy_open_backend
+ * \brief Same as open, but data goes to backend instead of file.
+ * \param sgy SeisOSegy instance.
+ * \param backend Storage to write to. Writer keeps reference to it.
+ * \return Error code.
+ */
+SeisSegyErrCode seis_osegy_open_backend(SeisOSegy *sgy,
+                                        SeisSegyBackend *backend);
+
 /**
  * \fn seis_osegy_add_ext_text_header
  * \brief adds additional SEGY text header
@@ -97,6 +110,32 @@ void seis_osegy_add_trailer_stanza(SeisOSegy *sgy, char const *buf);
  */
 SeisSegyErrCode seis_osegy_write_trace(SeisOSegy *sgy, SeisTrace *trc);
 
+/**
+ * \fn seis_osegy_write_trace_float
+ * \brief Writes trace with float samples to the file.
+ * \param sgy pointer to SeisOSegy instance.
+ * \param trc Pointer to trace to write.
+ * \return error code to check
+ */
+SeisSegyErrCode seis_osegy_write_trace_float(SeisOSegy *sgy,
+                                             SeisSegyFloatTrace *trc);
+
+/**
+ * \fn seis_osegy_write_trace_std
+ * \brief Writes trace with standard layout header. Trace header map is not
+ * used. If binary header has additional headers, first one is written from
+ * struct and others are zeros.
+ * \param sgy pointer to SeisOSegy instance.
+ * \param hdr Pointer to header to write.
+ * \param samples Samples of trace.
+ * \param samp_num Number of samples.
+ * \return error code to check
+ */
+SeisSegyErrCode seis_osegy_write_trace_std(SeisOSegy *sgy,
+                                           SeisSegyStdHeader const *hdr,
+                                           double const *samples,
+                                           long long samp_num);
+
 /**
  * \fn seis_osegy_remap_trace_header
  * \brief changes header reading parameters
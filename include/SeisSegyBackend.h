@@ -0,0 +1,197 @@
+/**
+ * \file SeisSegyBackend.h
+ * \brief Storage layer used by readers and writers.
+ * \author andalevor
+ * \date 2026\10\17
+ */
+
+#ifndef SEIS_SEGY_BACKEND_H
+#define SEIS_SEGY_BACKEND_H
+
+#include "SeisCommonSegy.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * \struct SeisSegyBackendOps
+ * \brief Functions backend provides. Unsupported ones are NULL.
+ * data is pointer given to seis_segy_backend_new.
+ * read_at is called from many threads by positional and asynchronous reads.
+ */
+typedef struct SeisSegyBackendOps {
+        /** Returns number of bytes read, less than num only at end of data.
+         * Stream backends may return less at any time, 0 means end of data.
+         * -1 on error. */
+        long long (*read_at)(void *data, void *buf, size_t num, size_t offset);
+        /** Returns number of bytes written or -1 on error. */
+        long long (*write_at)(void *data, void const *buf, size_t num,
+                              size_t offset);
+        /** Returns size of data or -1 if it is unknown. */
+        long long (*size)(void *data);
+        /** Advice about access to range. Zero num means up to the end. */
+        void (*hint)(void *data, SeisSegyAccessHint hint, size_t offset,
+                     size_t num);
+        /** Whole data if it is resident in memory. Pointer must be valid
+         * while backend lives. */
+        char const *(*view)(void *data);
+        /** Called when last reference is dropped. */
+        void (*close)(void *data);
+} SeisSegyBackendOps;
+
+/**
+ * \struct SeisSegyBackend
+ * \brief Reference counted storage with positional access.
+ */
+typedef struct SeisSegyBackend SeisSegyBackend;
+
+/**
+ * \fn seis_segy_backend_new
+ * \brief Makes backend from user functions.
+ * \param ops Functions table. Copied.
+ * \param data User data passed to every function.
+ * \return NULLable.
+ */
+SeisSegyBackend *seis_segy_backend_new(SeisSegyBackendOps const *ops,
+                                       void *data);
+
+/**
+ * \fn seis_segy_backend_stdio_new
+ * \brief Opens file with fopen. Buffered writes make it good for writers.
+ * \param file_name Name of file.
+ * \param mode fopen mode.
+ * \return NULLable.
+ */
+SeisSegyBackend *seis_segy_backend_stdio_new(char const *file_name,
+                                             char const *mode);
+
+/**
+ * \fn seis_segy_backend_fd_new
+ * \brief Makes backend from opened file descriptor. Uses pread and pwrite.
+ * \param fd File descriptor.
+ * \param owner Close descriptor with backend.
+ * \return NULLable.
+ */
+SeisSegyBackend *seis_segy_backend_fd_new(int fd, bool owner);
+
+/**
+ * \fn seis_segy_backend_stream_new
+ * \brief Makes backend for pipes, sockets and terminals. Data is read
+ * forward only, offsets before current one are errors and bytes before
+ * requested offset are skipped. Size is unknown.
+ * \param fd File descriptor. Use STDIN_FILENO to read standard input.
+ * \param owner Close descriptor with backend.
+ * \return NULLable.
+ */
+SeisSegyBackend *seis_segy_backend_stream_new(int fd, bool owner);
+
+/**
+ * \fn seis_segy_backend_gzip_new
+ * \brief Reads gzip compressed file. Whole file is decompressed once to
+ * build index of decompressor states, so reads at any offset start from
+ * nearest saved state. Sequential reads continue decompression without
+ * going back to saved state. Needs library built with zlib.
+ * \param file_name Name of compressed file.
+ * \param index_name NULLable. File to keep index in. Index is loaded from it
+ * if it matches compressed file, otherwise it is built and saved there.
+ * \param span Bytes of uncompressed data between saved states. Each state
+ * takes 32 KiB of memory. 0 means 4 MiB.
+ * \return NULLable.
+ */
+SeisSegyBackend *seis_segy_backend_gzip_new(char const *file_name,
+                                            char const *index_name,
+                                            size_t span);
+
+/**
+ * \fn seis_segy_backend_mmap_new
+ * \brief Maps whole file to memory for reading.
+ * \param file_name Name of file.
+ * \return NULLable.
+ */
+SeisSegyBackend *seis_segy_backend_mmap_new(char const *file_name);
+
+/**
+ * \fn seis_segy_backend_memory_new
+ * \brief Reads from buffer in memory. Buffer is not copied.
+ * \param buf Buffer with SEGY data. Must live longer than backend.
+ * \param size Buffer size.
+ * \return NULLable.
+ */
+SeisSegyBackend *seis_segy_backend_memory_new(void const *buf, size_t size);
+
+/**
+ * \fn seis_segy_backend_memory_new_writable
+ * \brief Makes growing buffer in memory for writers.
+ * \return NULLable.
+ */
+SeisSegyBackend *seis_segy_backend_memory_new_writable(void);
+
+/**
+ * \fn seis_segy_backend_memory_get_data
+ * \brief Gets content of writable memory backend.
+ * \param b SeisSegyBackend instance.
+ * \param size Receives data size.
+ * \return NULLable. NULL for other backends. Valid until next write.
+ */
+char const *seis_segy_backend_memory_get_data(SeisSegyBackend const *b,
+                                              size_t *size);
+
+/**
+ * \fn seis_segy_backend_ref
+ * \brief Makes rc increment.
+ * \param b Pointer to SeisSegyBackend object.
+ * \return nonNULL. Pointer to SeisSegyBackend object.
+ */
+SeisSegyBackend *seis_segy_backend_ref(SeisSegyBackend *b);
+
+/**
+ * \fn seis_segy_backend_unref
+ * \brief Decrements rc. Closes backend and frees memory.
+ * \param b Pointer to SeisSegyBackend object.
+ */
+void seis_segy_backend_unref(SeisSegyBackend **b);
+
+/**
+ * \fn seis_segy_backend_read_at
+ * \brief Reads bytes at offset.
+ * \return Number of bytes read or -1 on error or if not supported.
+ */
+long long seis_segy_backend_read_at(SeisSegyBackend const *b, void *buf,
+                                    size_t num, size_t offset);
+
+/**
+ * \fn seis_segy_backend_write_at
+ * \brief Writes bytes at offset.
+ * \return Number of bytes written or -1 on error or if not supported.
+ */
+long long seis_segy_backend_write_at(SeisSegyBackend *b, void const *buf,
+                                     size_t num, size_t offset);
+
+/**
+ * \fn seis_segy_backend_size
+ * \brief Gets data size.
+ * \return Size or -1 if unknown.
+ */
+long long seis_segy_backend_size(SeisSegyBackend const *b);
+
+/**
+ * \fn seis_segy_backend_hint
+ * \brief Passes access advice to backend. Does nothing if not supported.
+ */
+void seis_segy_backend_hint(SeisSegyBackend const *b, SeisSegyAccessHint hint,
+                            size_t offset, size_t num);
+
+/**
+ * \fn seis_segy_backend_view
+ * \brief Gets whole data if it is resident in memory.
+ * \return NULLable.
+ */
+char const *seis_segy_backend_view(SeisSegyBackend const *b);
+
+/**
+ * \fn seis_segy_backend_get_fd
+ * \brief Gets file descriptor of built-in file backends.
+ * \return File descriptor or -1 for other backends.
+ */
+int seis_segy_backend_get_fd(SeisSegyBackend const *b);
+
+#endif /* SEIS_SEGY_BACKEND_H */
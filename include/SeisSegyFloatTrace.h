@@ -0,0 +1,90 @@
+/**
+ * \file SeisSegyFloatTrace.h
+ * \brief Trace with single precision samples.
+ * \author andalevor
+ * \date 2026\10\17
+ */
+
+#ifndef SEIS_SEGY_FLOAT_TRACE_H
+#define SEIS_SEGY_FLOAT_TRACE_H
+
+#include <SeisTrace.h>
+
+/**
+ * \struct SeisSegyFloatTrace
+ * \brief Trace header with float samples. Takes half of memory of SeisTrace
+ * and is enough for 32 bit and narrower sample formats.
+ */
+typedef struct SeisSegyFloatTrace SeisSegyFloatTrace;
+
+/**
+ * \fn seis_segy_float_trace_new_with_header
+ * \brief Creates trace with given samples number. Samples are not
+ * initialized.
+ * \param samp_num Number of samples.
+ * \param hdr Trace header. Trace takes ownership of it on success.
+ * \return NULLable.
+ */
+SeisSegyFloatTrace *seis_segy_float_trace_new_with_header(long long samp_num,
+                                                          SeisTraceHeader *hdr);
+
+/**
+ * \fn seis_segy_float_trace_ref
+ * \brief Makes rc increment.
+ * \param trc Pointer to SeisSegyFloatTrace object.
+ * \return nonNULL. Pointer to SeisSegyFloatTrace object.
+ */
+SeisSegyFloatTrace *seis_segy_float_trace_ref(SeisSegyFloatTrace *trc);
+
+/**
+ * \fn seis_segy_float_trace_unref
+ * \brief Decrements rc and frees memory.
+ * \param trc Pointer to SeisSegyFloatTrace object.
+ */
+void seis_segy_float_trace_unref(SeisSegyFloatTrace **trc);
+
+/**
+ * \fn seis_segy_float_trace_get_header
+ * \brief Gets trace header.
+ * \param trc Pointer to SeisSegyFloatTrace object.
+ * \return nonNULL. You should not free this memory.
+ */
+SeisTraceHeader *seis_segy_float_trace_get_header(SeisSegyFloatTrace *trc);
+
+/**
+ * \fn seis_segy_float_trace_get_header_const
+ * \brief Gets trace header.
+ * \param trc Pointer to SeisSegyFloatTrace object.
+ * \return nonNULL. You should not free this memory.
+ */
+SeisTraceHeader const *
+seis_segy_float_trace_get_header_const(SeisSegyFloatTrace const *trc);
+
+/**
+ * \fn seis_segy_float_trace_get_samples
+ * \brief Gets trace samples.
+ * \param trc Pointer to SeisSegyFloatTrace object.
+ * \return NULLable for trace without samples. You should not free this
+ * memory.
+ */
+float *seis_segy_float_trace_get_samples(SeisSegyFloatTrace *trc);
+
+/**
+ * \fn seis_segy_float_trace_get_samples_const
+ * \brief Gets trace samples.
+ * \param trc Pointer to SeisSegyFloatTrace object.
+ * \return NULLable for trace without samples. You should not free this
+ * memory.
+ */
+float const *
+seis_segy_float_trace_get_samples_const(SeisSegyFloatTrace const *trc);
+
+/**
+ * \fn seis_segy_float_trace_get_samples_num
+ * \brief Gets number of samples.
+ * \param trc Pointer to SeisSegyFloatTrace object.
+ * \return Number of samples.
+ */
+long long seis_segy_float_trace_get_samples_num(SeisSegyFloatTrace const *trc);
+
+#endif /* SEIS_SEGY_FLOAT_TRACE_H */
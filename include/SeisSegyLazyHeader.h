@@ -0,0 +1,78 @@
+/**
+ * \file SeisSegyLazyHeader.h
+ * \brief Trace header decoded on demand from raw bytes.
+ * \author andalevor
+ * \date 2026\10\17
+ */
+
+#ifndef SEIS_SEGY_LAZY_HEADER_H
+#define SEIS_SEGY_LAZY_HEADER_H
+
+#include <SeisTrace.h>
+#include <stddef.h>
+
+/**
+ * \struct SeisSegyLazyHeader
+ * \brief Copy of raw trace header blocks with layout of reader. Field is
+ * decoded at first request and cached. Header stays valid after remap or
+ * destruction of reader and keeps layout it was read with.
+ */
+typedef struct SeisSegyLazyHeader SeisSegyLazyHeader;
+
+/**
+ * \fn seis_segy_lazy_header_ref
+ * \brief Makes rc increment.
+ * \param hdr Pointer to SeisSegyLazyHeader object.
+ * \return nonNULL. Pointer to SeisSegyLazyHeader object.
+ */
+SeisSegyLazyHeader *seis_segy_lazy_header_ref(SeisSegyLazyHeader *hdr);
+
+/**
+ * \fn seis_segy_lazy_header_unref
+ * \brief Decrements rc and frees memory.
+ * \param hdr Pointer to SeisSegyLazyHeader object.
+ */
+void seis_segy_lazy_header_unref(SeisSegyLazyHeader **hdr);
+
+/**
+ * \fn seis_segy_lazy_header_get_int
+ * \brief Gets integer field. Value is the same as in eagerly decoded
+ * header.
+ * \param hdr Pointer to SeisSegyLazyHeader object.
+ * \param name Name of field.
+ * \return NULLable if there is no such integer field. You should not free
+ * this memory.
+ */
+long long const *seis_segy_lazy_header_get_int(SeisSegyLazyHeader *hdr,
+                                               char const *name);
+
+/**
+ * \fn seis_segy_lazy_header_get_real
+ * \brief Gets floating point field.
+ * \param hdr Pointer to SeisSegyLazyHeader object.
+ * \param name Name of field.
+ * \return NULLable if there is no such floating point field. You should not
+ * free this memory.
+ */
+double const *seis_segy_lazy_header_get_real(SeisSegyLazyHeader *hdr,
+                                             char const *name);
+
+/**
+ * \fn seis_segy_lazy_header_decode
+ * \brief Decodes all fields into new trace header.
+ * \param hdr Pointer to SeisSegyLazyHeader object.
+ * \return NULLable. You should free this memory.
+ */
+SeisTraceHeader *seis_segy_lazy_header_decode(SeisSegyLazyHeader const *hdr);
+
+/**
+ * \fn seis_segy_lazy_header_get_raw
+ * \brief Gets raw bytes of main and additional headers as in file.
+ * \param hdr Pointer to SeisSegyLazyHeader object.
+ * \param size Receives size of bytes.
+ * \return nonNULL. You should not free this memory.
+ */
+char const *seis_segy_lazy_header_get_raw(SeisSegyLazyHeader const *hdr,
+                                          size_t *size);
+
+#endif /* SEIS_SEGY_LAZY_HEADER_H */
@@ -0,0 +1,172 @@
+/**
+ * \file SeisSegyStdHeader.h
+ * \brief Standard trace header as plain struct.
+ * \author andalevor
+ * \date 2026\10\17
+ */
+
+#ifndef SEIS_SEGY_STD_HEADER_H
+#define SEIS_SEGY_STD_HEADER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * \struct SeisSegyStdHeader
+ * \brief SEG-Y rev 2 standard trace header and first additional header
+ * with fields of default trace header map. Members are named after map
+ * fields in lower case, INLINE is iline. Fields of additional header have
+ * ext_ prefix. Layout is fixed, remapping of reader or writer doesn't
+ * change it.
+ */
+typedef struct SeisSegyStdHeader {
+        int32_t trc_seq_line;
+        int32_t trc_seq_sgy;
+        int32_t ffid;
+        int32_t chan;
+        int32_t esp;
+        int32_t ens_no;
+        int32_t seq_no;
+        int16_t trace_id;
+        int16_t vert_sum;
+        int16_t hor_sum;
+        int16_t data_use;
+        int32_t offset;
+        int32_t r_elev;
+        int32_t s_elev;
+        int32_t s_depth;
+        int32_t r_datum;
+        int32_t s_datum;
+        int32_t s_water;
+        int32_t r_water;
+        int16_t elev_scalar;
+        int16_t coord_scalar;
+        int32_t sou_x;
+        int32_t sou_y;
+        int32_t rec_x;
+        int32_t rec_y;
+        int16_t coord_units;
+        int16_t weath_vel;
+        int16_t subweath_vel;
+        int16_t s_uphole;
+        int16_t r_uphole;
+        int16_t s_stat;
+        int16_t r_stat;
+        int16_t tot_stat;
+        int16_t lag_a;
+        int16_t lag_b;
+        int16_t delay_time;
+        int16_t mute_start;
+        int16_t mute_end;
+        int16_t samp_num;
+        int16_t samp_int;
+        int16_t gain_type;
+        int16_t gain_const;
+        int16_t init_gain;
+        int16_t correlated;
+        int16_t sw_start;
+        int16_t sw_end;
+        int16_t sw_length;
+        int16_t sw_type;
+        int16_t sw_taper_start;
+        int16_t sw_taper_end;
+        int16_t taper_type;
+        int16_t alias_filt_freq;
+        int16_t alias_filt_slope;
+        int16_t notch_filt_freq;
+        int16_t notch_filt_slope;
+        int16_t low_cut_freq;
+        int16_t high_cut_freq;
+        int16_t low_cut_slope;
+        int16_t high_cut_slope;
+        int16_t year;
+        int16_t day;
+        int16_t hour;
+        int16_t minute;
+        int16_t second;
+        int16_t time_basis_code;
+        int16_t trace_weight;
+        int16_t group_num_roll;
+        int16_t group_num_first;
+        int16_t group_num_last;
+        int16_t gap_size;
+        int16_t over_travel;
+        int32_t cdp_x;
+        int32_t cdp_y;
+        int32_t iline;
+        int32_t xline;
+        int32_t sp_num;
+        int16_t sp_num_scalar;
+        int16_t tr_val_unit;
+        int32_t trans_const_mant;
+        int16_t trans_const_exp;
+        int16_t trans_units;
+        int16_t device_id;
+        int16_t time_scalar;
+        int16_t source_type;
+        int16_t sou_v_dir;
+        int16_t sou_x_dir;
+        int16_t sou_i_dir;
+        int32_t sou_meas_mant;
+        int16_t sou_meas_exp;
+        int16_t sou_meas_unit;
+        char seg00000[8];
+        /* first additional header */
+        bool has_ext;
+        uint64_t ext_trc_seq_line;
+        uint64_t ext_trc_seq_sgy;
+        int64_t ext_ffid;
+        int64_t ext_ens_no;
+        double ext_r_elev_r;
+        double ext_r_depth_r;
+        double ext_s_elev_r;
+        double ext_s_depth_r;
+        double ext_r_datum_r;
+        double ext_s_datum_r;
+        double ext_s_water_r;
+        double ext_r_water_r;
+        double ext_sou_x_r;
+        double ext_sou_y_r;
+        double ext_rec_x_r;
+        double ext_rec_y_r;
+        double ext_offset_r;
+        uint32_t ext_samp_num;
+        int32_t ext_nanosec;
+        double ext_samp_int_r;
+        int32_t ext_sens_id;
+        uint16_t ext_add_trc_hdr;
+        uint16_t ext_last_tr_flag;
+        double ext_cdp_x_r;
+        double ext_cdp_y_r;
+        char seg00001[8];
+} SeisSegyStdHeader;
+
+/**
+ * \fn seis_segy_std_header_decode
+ * \brief Fills struct from raw trace headers. Additional header fields are
+ * zeros if headers have no additional header.
+ * \param hdr Pointer to SeisSegyStdHeader to fill.
+ * \param headers Raw main header followed by additional headers.
+ * \param size Size of headers in bytes.
+ * \param big_endian Byte order of headers.
+ * \return false if size is less than one trace header.
+ */
+bool seis_segy_std_header_decode(SeisSegyStdHeader *hdr, char const *headers,
+                                 size_t size, bool big_endian);
+
+/**
+ * \fn seis_segy_std_header_encode
+ * \brief Writes struct into raw trace headers. Additional header is
+ * written if has_ext is set and size has room for it. Bytes without
+ * fields are zeros, bytes after written headers are left untouched.
+ * \param hdr Pointer to SeisSegyStdHeader.
+ * \param headers Buffer for raw headers.
+ * \param size Size of buffer in bytes.
+ * \param big_endian Byte order of headers.
+ * \return false if size is less than one trace header.
+ */
+bool seis_segy_std_header_encode(SeisSegyStdHeader const *hdr, char *headers,
+                                 size_t size, bool big_endian);
+
+#endif /* SEIS_SEGY_STD_HEADER_H */
@@ -1,5 +1,6 @@
 #include "SeisCommonSegy.h"
 #include "SeisCommonSegyPrivate.h"
+#include "SeisSegyBackend.h"
 #include "m-string.h"
 #include <SeisTrace.h>
 #include <assert.h>
@@ -8,6 +9,10 @@
 #include <string.h>
 
 static void fill_hdr_map(SeisCommonSegyPrivate *sgy);
+static void add_schema_fields(SeisCommonSegyPrivate *priv,
+                              SeisSegyHdrSchema *s, single_hdr_fmt_t *block,
+                              size_t idx, char **names, bool swap);
+static bool is_field_wanted(SeisCommonSegyPrivate *priv, char const *name);
 
 SeisCommonSegy *seis_common_segy_new(void) {
         SeisCommonSegyPrivate *priv = (SeisCommonSegyPrivate *)malloc(
@@ -21,11 +26,13 @@ SeisCommonSegy *seis_common_segy_new(void) {
         if (!priv->com.hdr_buf)
                 return NULL;
         priv->com.samp_buf = NULL;
-        priv->com.file = NULL;
+        priv->com.backend = NULL;
         priv->com.samp_per_tr = 0;
         str_arr_init(priv->text_hdrs);
         str_arr_init(priv->end_stanzas);
+        str_arr_init(priv->hdr_fields);
         mult_hdr_fmt_init(priv->trc_hdr_map);
+        priv->schema = NULL;
         fill_hdr_map(priv);
         return (SeisCommonSegy *)priv;
 }
@@ -36,12 +43,12 @@ void seis_common_segy_unref(SeisCommonSegy **sgy) {
                 free(psgy->com.hdr_buf);
                 if (psgy->com.samp_buf)
                         free(psgy->com.samp_buf);
-                if (psgy->com.file) {
-                        fclose(psgy->com.file);
-                }
+                seis_segy_backend_unref(&psgy->com.backend);
                 str_arr_clear(psgy->text_hdrs);
                 str_arr_clear(psgy->end_stanzas);
+                str_arr_clear(psgy->hdr_fields);
                 mult_hdr_fmt_clear(psgy->trc_hdr_map);
+                seis_segy_hdr_schema_unref(&psgy->schema);
                 free(psgy);
                 *sgy = NULL;
         }
@@ -102,9 +109,68 @@ SeisSegyErrCode seis_common_remap_trace_header(SeisCommonSegy *sgy,
         fmt->format = format;
         single_hdr_fmt_push_back(*h, fmt);
         hdr_fmt_clear(fmt);
+        if (priv->schema)
+                seis_common_segy_compile_schema(sgy, priv->schema->swap);
 error:
         return sgy->err.code;
 }
+
+SeisSegyErrCode seis_common_segy_compile_schema(SeisCommonSegy *com,
+                                                bool swap) {
+        SeisCommonSegyPrivate *priv = (SeisCommonSegyPrivate *)com;
+        SeisSegyHdrSchema *s = seis_segy_hdr_schema_new();
+        if (!s)
+                goto error;
+        size_t fields_num = 0, names_size = 0;
+        s->blocks_num = mult_hdr_fmt_size(priv->trc_hdr_map);
+        for
+                M_EACH(block, priv->trc_hdr_map, M_OPL_mult_hdr_fmt_t())
+                for
+                        M_EACH(item, *block, M_OPL_single_hdr_fmt_t()) {
+                                ++fields_num;
+                                names_size += string_size((*item)->name) + 1;
+                        }
+        s->fields = (SeisSegyHdrField *)malloc(
+            (fields_num ? fields_num : 1) * sizeof(SeisSegyHdrField));
+        s->blocks = (size_t *)malloc((s->blocks_num + 1) * sizeof(size_t));
+        s->names = (char *)malloc(names_size ? names_size : 1);
+        if (!s->fields || !s->blocks || !s->names)
+                goto error;
+        char *names = s->names;
+        size_t b = 0;
+        for
+                M_EACH(block, priv->trc_hdr_map, M_OPL_mult_hdr_fmt_t()) {
+                        s->blocks[b++] = s->fields_num;
+                        add_schema_fields(priv, s, block, b - 1, &names,
+                                          swap);
+                }
+        s->blocks[b] = s->fields_num;
+        s->add_hdr_num_slot = seis_segy_hdr_schema_slot(s, "ADD_HDR_NUM");
+        s->samp_num_slot = seis_segy_hdr_schema_slot(s, "SAMP_NUM");
+        s->swap = swap;
+        /* headers made with old schema keep it */
+        seis_segy_hdr_schema_unref(&priv->schema);
+        priv->schema = s;
+        return com->err.code;
+error:
+        seis_segy_hdr_schema_unref(&s);
+        com->err.code = SEIS_SEGY_ERR_NO_MEM;
+        com->err.message = "can't get memory for trace header schema";
+        return com->err.code;
+}
+
+SeisSegyErrCode seis_common_segy_set_header_fields(SeisCommonSegy *com,
+                                                   char const *const *names,
+                                                   size_t num) {
+        SeisCommonSegyPrivate *priv = (SeisCommonSegyPrivate *)com;
+        str_arr_reset(priv->hdr_fields);
+        for (size_t i = 0; names && i < num; ++i)
+                str_arr_emplace_back(priv->hdr_fields, names[i]);
+        if (priv->schema)
+                seis_common_segy_compile_schema(com, priv->schema->swap);
+        return com->err.code;
+}
+
 void seis_common_segy_set_text_header(SeisCommonSegy *com, size_t idx,
                                       char const *hdr) {
         SeisCommonSegyPrivate *priv = (SeisCommonSegyPrivate *)com;
@@ -633,6 +699,41 @@ void fill_hdr_map(SeisCommonSegyPrivate *psgy) {
         hdr_fmt_clear(fmt);
 }
 
+void add_schema_fields(SeisCommonSegyPrivate *priv, SeisSegyHdrSchema *s,
+                       single_hdr_fmt_t *block, size_t idx, char **names,
+                       bool swap) {
+        for
+                M_EACH(item, *block, M_OPL_single_hdr_fmt_t()) {
+                        if (!is_field_wanted(priv,
+                                             string_get_cstr((*item)->name)))
+                                continue;
+                        SeisSegyHdrField *f = s->fields + s->fields_num;
+                        strcpy(*names, string_get_cstr((*item)->name));
+                        f->name = *names;
+                        *names += strlen(*names) + 1;
+                        f->block = (int)idx;
+                        f->offset = (*item)->offset;
+                        f->format = (*item)->format;
+                        seis_segy_hdr_field_bind(f, swap);
+                        f->slot = seis_segy_hdr_schema_slot(s, f->name);
+                        if (f->slot < 0)
+                                f->slot = s->slots_num++;
+                        ++s->fields_num;
+                }
+}
+
+bool is_field_wanted(SeisCommonSegyPrivate *priv, char const *name) {
+        if (!str_arr_size(priv->hdr_fields) || !strcmp(name, "SAMP_NUM") ||
+            !strcmp(name, "ADD_HDR_NUM"))
+                return true;
+        size_t num = str_arr_size(priv->hdr_fields);
+        for (size_t i = 0; i < num; ++i)
+                if (!strcmp(string_get_cstr(*str_arr_get(priv->hdr_fields, i)),
+                            name))
+                        return true;
+        return false;
+}
+
 char const *seis_segy_default_text_header_rev0 =
     "C 1 CLIENT                        COMPANY                       CREW NO   "
     "      "
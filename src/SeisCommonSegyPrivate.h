@@ -2,6 +2,7 @@
 #define SEIS_COMMON_SEGY_PRIVATE
 
 #include "SeisCommonSegy.h"
+#include "SeisSegyHdrSchema.h"
 #include "m-array.h"
 #include "m-string.h"
 #include "m-tuple.h"
@@ -22,6 +23,19 @@ typedef struct SeisCommonSegyPrivate {
         struct SeisCommonSegy com;
         str_arr_t text_hdrs, end_stanzas;
         mult_hdr_fmt_t trc_hdr_map;
+        /* fields to compile into schema, empty means all */
+        str_arr_t hdr_fields;
+        SeisSegyHdrSchema *schema;
 } SeisCommonSegyPrivate;
 
+/* compiles trace header map for byte order, map changes recompile it */
+SeisSegyErrCode seis_common_segy_compile_schema(SeisCommonSegy *com,
+                                                bool swap);
+
+/* limits schema to named fields, NULL names return all of them. Samples
+ * number and number of additional headers are always kept. */
+SeisSegyErrCode seis_common_segy_set_header_fields(SeisCommonSegy *com,
+                                                   char const *const *names,
+                                                   size_t num);
+
 #endif
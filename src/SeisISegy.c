@@ -1,38 +1,78 @@
+#define _GNU_SOURCE
+
 #include "SeisISegy.h"
 #include "SeisCommonSegy.h"
 #include "SeisCommonSegyPrivate.h"
 #include "SeisISU.h"
+#include "SeisISegyPrivate.h"
+#include "SeisSegyBackend.h"
+#include "SeisSegyBytes.h"
+#include "SeisSegyConvert.h"
+#include "SeisSegyFloatTrace.h"
+#include "SeisSegyHdrSchema.h"
+#include "SeisSegyLazyHeaderPrivate.h"
 #include "TRY.h"
 #include <SeisTrace.h>
 #include <assert.h>
+#include <fcntl.h>
 #include <float.h>
+#include <limits.h>
 #include <math.h>
+#include <pthread.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #define UNUSED(x) (void)(x)
+#define DEFAULT_BLOCK_SIZE (4 * 1024 * 1024)
+#define DIRECT_ALIGN 4096
+
+enum AHEAD_STATE { AHEAD_NONE, AHEAD_QUEUED, AHEAD_RUNNING, AHEAD_READY };
 
 struct SeisISegy {
         SeisCommonSegy *com;
-        long curr_pos, first_trace_pos, end_of_data;
-        int8_t (*read_i8)(char const **buf);
+        long curr_pos, first_trace_pos, end_of_data, file_size;
+        SeisSegyIOMode io_mode;
+        char *index_name;
+        char const *map;
+        size_t map_size;
+        char *block;
+        size_t block_size, block_len, block_align;
+        long block_pos;
+        SeisSegyBackend *block_backend;
+        bool drop_cache;
+        bool streaming;
+        uint64_t traces_read;
+        char *raw_buf;
+        size_t raw_size;
+        bool read_ahead, io_started, io_stop;
+        pthread_t io_thread;
+        pthread_mutex_t io_lock;
+        pthread_cond_t io_cond;
+        char *ahead;
+        size_t ahead_len;
+        long ahead_pos;
+        unsigned ahead_gen;
+        enum AHEAD_STATE ahead_state;
+        SeisSegyErrCode (*fetch)(SeisISegy *sgy, char *buf, size_t num,
+                                 char const **res);
+        void (*seek)(SeisISegy *sgy, long pos);
         uint8_t (*read_u8)(char const **buf);
         int16_t (*read_i16)(char const **buf);
         uint16_t (*read_u16)(char const **buf);
-        int32_t (*read_i24)(char const **buf);
-        uint32_t (*read_u24)(char const **buf);
         int32_t (*read_i32)(char const **buf);
         uint32_t (*read_u32)(char const **buf);
         int64_t (*read_i64)(char const **buf);
         uint64_t (*read_u64)(char const **buf);
-        double (*dbl_from_IEEE_float)(SeisISegy *sgy, char const **buf);
-        double (*dbl_from_IEEE_double)(SeisISegy *sgy, char const **buf);
-        double (*read_sample)(SeisISegy *sgy, char const **buf);
-        SeisSegyErrCode (*read_trc_smpls)(SeisISegy *sgy, SeisTraceHeader *hdr,
-                                          SeisTrace **trc);
+        double (*dbl_from_IEEE_double)(SeisISegy const *sgy, char const **buf);
+        SeisSegyConvertFunc convert;
+        SeisSegyConvertFloatFunc convert_f;
+        SeisSegyErrCode (*fetch_trc_smpls)(SeisISegy *sgy, SeisTraceHeader *hdr,
+                                           char const **ptr, long long *num);
         SeisSegyErrCode (*skip_trc_smpls)(SeisISegy *sgy, SeisTraceHeader *hdr);
         int rc;
 };
@@ -42,8 +82,32 @@ struct SeisISU {
         int rc;
 };
 
-static SeisSegyErrCode fill_from_file(SeisISegy *sgy, char *buf, size_t num);
-static void file_skip_bytes(SeisISegy *sgy, size_t num);
+static SeisSegyErrCode open_file(SeisISegy *sgy, char const *file_name);
+static SeisSegyErrCode attach_backend(SeisISegy *sgy,
+                                      SeisSegyBackend *backend);
+static SeisSegyErrCode read_headers(SeisISegy *sgy);
+static SeisSegyErrCode read_su_headers(SeisISegy *sgy);
+static SeisSegyErrCode file_fetch(SeisISegy *sgy, char *buf, size_t num,
+                                  char const **res);
+static SeisSegyErrCode map_fetch(SeisISegy *sgy, char *buf, size_t num,
+                                 char const **res);
+static void file_seek(SeisISegy *sgy, long pos);
+static void map_seek(SeisISegy *sgy, long pos);
+static void skip_bytes(SeisISegy *sgy, size_t num);
+static size_t read_full(SeisSegyBackend const *b, char *buf, size_t num,
+                        long pos);
+static SeisSegyErrCode open_direct(SeisISegy *sgy, char const *file_name);
+static bool is_gzip(char const *file_name);
+static char *alloc_block(SeisISegy const *sgy);
+static size_t read_block(SeisISegy const *sgy, char *buf, long pos);
+static SeisSegyErrCode stream_fill(SeisISegy *sgy, size_t num);
+static SeisSegyErrCode stream_check_end(SeisISegy *sgy);
+static SeisSegyErrCode read_end_text_stanzas(SeisISegy *sgy);
+static bool in_block(SeisISegy const *sgy, long pos, size_t num);
+static bool ahead_covers(SeisISegy const *sgy, long pos, size_t num);
+static void take_ahead(SeisISegy *sgy, size_t num);
+static void request_ahead(SeisISegy *sgy, long pos);
+static void *read_ahead_worker(void *arg);
 static SeisSegyErrCode
 read_text_header(SeisISegy *sgy,
                  void (*add_func)(SeisCommonSegy *, char const *), int num);
@@ -53,55 +117,82 @@ static SeisSegyErrCode assign_sample_reader(SeisISegy *sgy);
 static SeisSegyErrCode assign_bytes_per_sample(SeisISegy *sgy);
 static SeisSegyErrCode read_ext_text_headers(SeisISegy *sgy);
 static SeisSegyErrCode read_trailer_stanzas(SeisISegy *sgy);
-static SeisSegyErrCode read_trc_smpls_fix(SeisISegy *sgy, SeisTraceHeader *hdr,
-                                          SeisTrace **trc);
-static SeisSegyErrCode read_trc_smpls_var(SeisISegy *sgy, SeisTraceHeader *hdr,
-                                          SeisTrace **trc);
+static SeisSegyErrCode fetch_trc_smpls_fix(SeisISegy *sgy,
+                                           SeisTraceHeader *hdr,
+                                           char const **ptr, long long *num);
+static SeisSegyErrCode fetch_trc_smpls_var(SeisISegy *sgy,
+                                           SeisTraceHeader *hdr,
+                                           char const **ptr, long long *num);
+static SeisSegyErrCode read_trc_smpls(SeisISegy *sgy, SeisTraceHeader *hdr,
+                                      SeisTrace **trc);
+static SeisSegyErrCode read_trc_smpls_float(SeisISegy *sgy,
+                                            SeisTraceHeader *hdr,
+                                            SeisSegyFloatTrace **trc);
+static SeisSegyErrCode fetch_smpls(SeisISegy *sgy, long long num,
+                                   char const **ptr);
+static SeisSegyErrCode read_raw_headers(SeisISegy *sgy, size_t *hdrs_num);
+static SeisSegyErrCode read_raw_trace(SeisISegy *sgy, SeisSegyRawTrace *raw);
+static SeisSegyErrCode read_lazy_hdr(SeisISegy *sgy,
+                                     SeisSegyLazyHeader **hdr);
+static SeisSegyErrCode read_std_hdr(SeisISegy *sgy, SeisSegyStdHeader *hdr);
+static bool is_big_endian(SeisISegy const *sgy);
+static SeisSegyErrCode reserve_raw(SeisISegy *sgy, size_t size);
+static SeisSegyErrCode read_trace_into(SeisISegy *sgy, SeisTraceHeader *hdr,
+                                       double *samples, float *fsamples,
+                                       size_t capacity, size_t *samp_num);
 static SeisSegyErrCode read_trc_hdr(SeisISegy *sgy, SeisTraceHeader *hdr);
 static SeisSegyErrCode skip_trc_smpls_fix(SeisISegy *sgy, SeisTraceHeader *hdr);
 static SeisSegyErrCode skip_trc_smpls_var(SeisISegy *sgy, SeisTraceHeader *hdr);
-static void fill_hdr_from_fmt_arr(SeisISegy *sgy, single_hdr_fmt_t *arr,
-                                  SeisTraceHeader *hdr);
+static int add_hdrs_left(SeisISegy const *sgy, SeisTraceHeader const *hdr);
+static SeisSegyErrCode fetch_at(SeisISegy const *sgy, char *buf, size_t num,
+                                long pos, char const **res, SeisSegyErr *err);
+static SeisSegyErrCode read_trc_hdr_at(SeisISegy const *sgy, long *pos,
+                                       SeisTraceHeader *hdr, SeisSegyErr *err);
+static SeisSegyErrCode read_trc_smpls_at(SeisISegy const *sgy, long *pos,
+                                         SeisTraceHeader *hdr, SeisTrace **trc,
+                                         SeisSegyErr *err);
+
 
-static int8_t read_i8(char const **buf);
 static uint8_t read_u8(char const **buf);
 static int16_t read_i16(char const **buf);
 static uint16_t read_u16(char const **buf);
-static int32_t read_i24(char const **buf);
-static uint32_t read_u24(char const **buf);
 static int32_t read_i32(char const **buf);
 static uint32_t read_u32(char const **buf);
 static int64_t read_i64(char const **buf);
 static uint64_t read_u64(char const **buf);
 static int16_t read_i16_sw(char const **buf);
 static uint16_t read_u16_sw(char const **buf);
-static int32_t read_i24_sw(char const **buf);
-static uint32_t read_u24_sw(char const **buf);
 static int32_t read_i32_sw(char const **buf);
 static uint32_t read_u32_sw(char const **buf);
 static int64_t read_i64_sw(char const **buf);
 static uint64_t read_u64_sw(char const **buf);
-static double dbl_from_IBM_float(SeisISegy *sgy, char const **buf);
-static double dbl_from_IEEE_float(SeisISegy *sgy, char const **buf);
-static double dbl_from_IEEE_double(SeisISegy *sgy, char const **buf);
-static double dbl_from_IEEE_float_native(SeisISegy *sgy, char const **buf);
-static double dbl_from_IEEE_double_native(SeisISegy *sgy, char const **buf);
-static double dbl_from_i8(SeisISegy *sgy, char const **buf);
-static double dbl_from_u8(SeisISegy *sgy, char const **buf);
-static double dbl_from_i16(SeisISegy *sgy, char const **buf);
-static double dbl_from_u16(SeisISegy *sgy, char const **buf);
-static double dbl_from_i24(SeisISegy *sgy, char const **buf);
-static double dbl_from_u24(SeisISegy *sgy, char const **buf);
-static double dbl_from_i32(SeisISegy *sgy, char const **buf);
-static double dbl_from_u32(SeisISegy *sgy, char const **buf);
-static double dbl_from_i64(SeisISegy *sgy, char const **buf);
-static double dbl_from_u64(SeisISegy *sgy, char const **buf);
+static double dbl_from_IEEE_double(SeisISegy const *sgy, char const **buf);
+static double dbl_from_IEEE_double_native(SeisISegy const *sgy,
+                                          char const **buf);
 
 SeisISegy *seis_isegy_new(void) {
         SeisISegy *sgy = (SeisISegy *)malloc(sizeof(struct SeisISegy));
         if (!sgy)
                 goto error;
         sgy->com = seis_common_segy_new();
+        sgy->io_mode = SEIS_SEGY_IO_STDIO;
+        sgy->index_name = NULL;
+        sgy->map = NULL;
+        sgy->map_size = 0;
+        sgy->block = NULL;
+        sgy->block_size = DEFAULT_BLOCK_SIZE;
+        sgy->block_len = 0;
+        sgy->block_pos = 0;
+        sgy->block_align = 1;
+        sgy->block_backend = NULL;
+        sgy->drop_cache = false;
+        sgy->streaming = false;
+        sgy->traces_read = 0;
+        sgy->raw_buf = NULL;
+        sgy->raw_size = 0;
+        sgy->read_ahead = false;
+        sgy->io_started = false;
+        sgy->ahead = NULL;
         sgy->rc = 1;
         return sgy;
 error:
@@ -116,6 +207,21 @@ SeisISegy *seis_isegy_ref(SeisISegy *sgy) {
 void seis_isegy_unref(SeisISegy **sgy) {
         if (*sgy)
                 if (--(*sgy)->rc == 0) {
+                        if ((*sgy)->io_started) {
+                                SeisISegy *s = *sgy;
+                                pthread_mutex_lock(&s->io_lock);
+                                s->io_stop = true;
+                                pthread_cond_broadcast(&s->io_cond);
+                                pthread_mutex_unlock(&s->io_lock);
+                                pthread_join(s->io_thread, NULL);
+                                pthread_cond_destroy(&s->io_cond);
+                                pthread_mutex_destroy(&s->io_lock);
+                        }
+                        free((*sgy)->index_name);
+                        free((*sgy)->raw_buf);
+                        free((*sgy)->ahead);
+                        free((*sgy)->block);
+                        seis_segy_backend_unref(&(*sgy)->block_backend);
                         seis_common_segy_unref(&(*sgy)->com);
                         free(*sgy);
                         *sgy = NULL;
@@ -130,15 +236,60 @@ SeisSegyErr const *seis_isegy_get_error(SeisISegy const *sgy) {
         return &sgy->com->err;
 }
 
-SeisSegyErrCode seis_isegy_open(SeisISegy *sgy, char const *file_name) {
+void seis_isegy_set_io_mode(SeisISegy *sgy, SeisSegyIOMode mode) {
+        sgy->io_mode = mode;
+}
+
+void seis_isegy_set_buffer_size(SeisISegy *sgy, size_t size) {
+        sgy->block_size = size ? size : DEFAULT_BLOCK_SIZE;
+}
+
+void seis_isegy_set_read_ahead(SeisISegy *sgy, bool enable) {
+        sgy->read_ahead = enable;
+}
+
+SeisSegyErrCode seis_isegy_set_seek_index(SeisISegy *sgy,
+                                          char const *file_name) {
         SeisCommonSegy *com = sgy->com;
-        assert(!com->file); /* open func must be called only once */
-        com->file = fopen(file_name, "r");
-        if (!com->file) {
-                com->err.code = SEIS_SEGY_ERR_FILE_OPEN;
-                com->err.message = "file open error";
-                goto error;
+        free(sgy->index_name);
+        sgy->index_name = NULL;
+        if (file_name) {
+                sgy->index_name = (char *)malloc(strlen(file_name) + 1);
+                if (!sgy->index_name) {
+                        com->err.code = SEIS_SEGY_ERR_NO_MEM;
+                        com->err.message = "can't get memory for index name";
+                        goto error;
+                }
+                strcpy(sgy->index_name, file_name);
         }
+error:
+        return com->err.code;
+}
+
+void seis_isegy_set_access_hint(SeisISegy *sgy, SeisSegyAccessHint hint) {
+        if (sgy->com->backend)
+                seis_segy_backend_hint(sgy->com->backend, hint, 0, 0);
+}
+
+SeisSegyErrCode seis_isegy_open(SeisISegy *sgy, char const *file_name) {
+        SeisCommonSegy *com = sgy->com;
+        TRY(open_file(sgy, file_name));
+        TRY(read_headers(sgy));
+error:
+        return com->err.code;
+}
+
+SeisSegyErrCode seis_isegy_open_backend(SeisISegy *sgy,
+                                        SeisSegyBackend *backend) {
+        SeisCommonSegy *com = sgy->com;
+        TRY(attach_backend(sgy, backend));
+        TRY(read_headers(sgy));
+error:
+        return com->err.code;
+}
+
+SeisSegyErrCode read_headers(SeisISegy *sgy) {
+        SeisCommonSegy *com = sgy->com;
         TRY(read_text_header(sgy, seis_common_segy_add_text_header, 1));
         TRY(read_bin_header(sgy));
         TRY(assign_sample_reader(sgy));
@@ -146,25 +297,27 @@ SeisSegyErrCode seis_isegy_open(SeisISegy *sgy, char const *file_name) {
         TRY(read_ext_text_headers(sgy));
         if (com->bin_hdr.byte_off_of_first_tr) {
                 sgy->first_trace_pos = com->bin_hdr.byte_off_of_first_tr;
-                fseek(com->file, sgy->first_trace_pos, SEEK_SET);
+                sgy->seek(sgy, sgy->first_trace_pos);
         } else {
-                sgy->first_trace_pos = ftell(com->file);
+                sgy->first_trace_pos = sgy->curr_pos;
         }
         com->samp_per_tr = com->bin_hdr.ext_samp_per_tr
                                ? com->bin_hdr.ext_samp_per_tr
                                : com->bin_hdr.samp_per_tr;
-        TRY(read_trailer_stanzas(sgy));
-        fseek(com->file, sgy->first_trace_pos, SEEK_SET);
-        sgy->curr_pos = sgy->first_trace_pos;
+        /* stream stanzas are read when trace data is over */
+        if (!sgy->streaming)
+                TRY(read_trailer_stanzas(sgy));
+        sgy->seek(sgy, sgy->first_trace_pos);
         com->samp_buf =
             (char *)malloc(com->samp_per_tr * com->bytes_per_sample);
         if (com->bin_hdr.fixed_tr_length || !com->bin_hdr.SEGY_rev_major_ver) {
-                sgy->read_trc_smpls = read_trc_smpls_fix;
+                sgy->fetch_trc_smpls = fetch_trc_smpls_fix;
                 sgy->skip_trc_smpls = skip_trc_smpls_fix;
         } else {
-                sgy->read_trc_smpls = read_trc_smpls_var;
+                sgy->fetch_trc_smpls = fetch_trc_smpls_var;
                 sgy->skip_trc_smpls = skip_trc_smpls_var;
         }
+        TRY(stream_check_end(sgy));
 error:
         return com->err.code;
 }
@@ -178,13 +331,55 @@ SeisTrace *seis_isegy_read_trace(SeisISegy *sgy) {
         }
         TRY(read_trc_hdr(sgy, hdr));
         SeisTrace *trc;
-        TRY(sgy->read_trc_smpls(sgy, hdr, &trc));
+        TRY(read_trc_smpls(sgy, hdr, &trc));
+        ++sgy->traces_read;
+        if (stream_check_end(sgy))
+                seis_trace_unref(&trc);
         return trc;
 error:
         seis_trace_header_unref(&hdr);
         return NULL;
 }
 
+SeisSegyFloatTrace *seis_isegy_read_trace_float(SeisISegy *sgy) {
+        SeisTraceHeader *hdr = seis_trace_header_new();
+        if (!hdr) {
+                sgy->com->err.code = SEIS_SEGY_ERR_NO_MEM;
+                sgy->com->err.message = "can't get memory at trace reading";
+                goto error;
+        }
+        TRY(read_trc_hdr(sgy, hdr));
+        SeisSegyFloatTrace *trc;
+        TRY(read_trc_smpls_float(sgy, hdr, &trc));
+        ++sgy->traces_read;
+        if (stream_check_end(sgy))
+                seis_segy_float_trace_unref(&trc);
+        return trc;
+error:
+        seis_trace_header_unref(&hdr);
+        return NULL;
+}
+
+SeisSegyErrCode seis_isegy_read_trace_into(SeisISegy *sgy,
+                                           SeisTraceHeader *hdr,
+                                           double *samples, size_t capacity,
+                                           size_t *samp_num) {
+        return read_trace_into(sgy, hdr, samples, NULL, capacity, samp_num);
+}
+
+SeisSegyErrCode seis_isegy_read_trace_into_float(SeisISegy *sgy,
+                                                 SeisTraceHeader *hdr,
+                                                 float *samples,
+                                                 size_t capacity,
+                                                 size_t *samp_num) {
+        return read_trace_into(sgy, hdr, NULL, samples, capacity, samp_num);
+}
+
+SeisSegyErrCode seis_isegy_read_raw_trace(SeisISegy *sgy,
+                                          SeisSegyRawTrace *raw) {
+        return read_raw_trace(sgy, raw);
+}
+
 SeisTraceHeader *seis_isegy_read_trace_header(SeisISegy *sgy) {
         SeisTraceHeader *hdr = seis_trace_header_new();
         if (!hdr) {
@@ -195,12 +390,25 @@ SeisTraceHeader *seis_isegy_read_trace_header(SeisISegy *sgy) {
         }
         TRY(read_trc_hdr(sgy, hdr));
         sgy->skip_trc_smpls(sgy, hdr);
+        ++sgy->traces_read;
+        TRY(stream_check_end(sgy));
         return hdr;
 error:
         seis_trace_header_unref(&hdr);
         return NULL;
 }
 
+SeisSegyLazyHeader *seis_isegy_read_lazy_header(SeisISegy *sgy) {
+        SeisSegyLazyHeader *hdr = NULL;
+        read_lazy_hdr(sgy, &hdr);
+        return hdr;
+}
+
+SeisSegyErrCode seis_isegy_read_std_header(SeisISegy *sgy,
+                                           SeisSegyStdHeader *hdr) {
+        return read_std_hdr(sgy, hdr);
+}
+
 SeisSegyBinHdr const *seis_isegy_get_binary_header(SeisISegy const *sgy) {
         return &sgy->com->bin_hdr;
 }
@@ -212,6 +420,12 @@ SeisSegyErrCode seis_isegy_remap_trace_header(SeisISegy *sgy,
                                               offset, fmt);
 }
 
+SeisSegyErrCode seis_isegy_set_header_fields(SeisISegy *sgy,
+                                             char const *const *names,
+                                             size_t num) {
+        return seis_common_segy_set_header_fields(sgy->com, names, num);
+}
+
 size_t seis_isegy_get_text_headers_num(SeisISegy const *sgy) {
         return seis_common_segy_get_text_headers_num(sgy->com);
 }
@@ -229,14 +443,73 @@ char const *seis_isegy_get_stanza(SeisISegy const *sgy, size_t idx) {
 }
 
 void seis_isegy_rewind(SeisISegy *sgy) {
-        fseek(sgy->com->file, sgy->first_trace_pos, SEEK_SET);
-        sgy->curr_pos = sgy->first_trace_pos;
+        sgy->seek(sgy, sgy->first_trace_pos);
+        sgy->traces_read = 0;
+        stream_check_end(sgy);
 }
 
-size_t seis_isegy_get_offset(SeisISegy *sgy) { return ftell(sgy->com->file); }
+size_t seis_isegy_get_offset(SeisISegy *sgy) { return sgy->curr_pos; }
 
 void seis_isegy_set_offset(SeisISegy *sgy, size_t offset) {
-        fseek(sgy->com->file, offset, SEEK_SET);
+        sgy->seek(sgy, offset);
+        stream_check_end(sgy);
+}
+
+size_t seis_isegy_get_trace_offset(SeisISegy const *sgy, size_t idx) {
+        SeisCommonSegy const *com = sgy->com;
+        size_t trc_size = SEIS_SEGY_TRACE_HEADER_SIZE *
+                              (1 + com->bin_hdr.max_num_add_tr_headers) +
+                          com->samp_per_tr * com->bytes_per_sample;
+        return sgy->first_trace_pos + idx * trc_size;
+}
+
+SeisTrace *seis_isegy_read_trace_at(SeisISegy const *sgy, size_t offset,
+                                    size_t *next_offset, SeisSegyErr *err) {
+        err->code = SEIS_SEGY_ERR_OK;
+        err->message = "";
+        long pos = offset;
+        SeisTrace *trc = NULL;
+        SeisTraceHeader *hdr = seis_trace_header_new();
+        if (!hdr) {
+                err->code = SEIS_SEGY_ERR_NO_MEM;
+                err->message = "can't get memory at trace reading";
+                goto error;
+        }
+        TRY(read_trc_hdr_at(sgy, &pos, hdr, err));
+        TRY(read_trc_smpls_at(sgy, &pos, hdr, &trc, err));
+        if (next_offset)
+                *next_offset = pos;
+        return trc;
+error:
+        if (trc)
+                seis_trace_unref(&trc);
+        else
+                seis_trace_header_unref(&hdr);
+        return NULL;
+}
+
+SeisTraceHeader *seis_isegy_read_trace_header_at(SeisISegy const *sgy,
+                                                 size_t offset,
+                                                 size_t *next_offset,
+                                                 SeisSegyErr *err) {
+        err->code = SEIS_SEGY_ERR_OK;
+        err->message = "";
+        long pos = offset;
+        SeisTraceHeader *hdr = seis_trace_header_new();
+        if (!hdr) {
+                err->code = SEIS_SEGY_ERR_NO_MEM;
+                err->message = "can't get memory at trace header reading";
+                goto error;
+        }
+        TRY(read_trc_hdr_at(sgy, &pos, hdr, err));
+        long long samp_num;
+        TRY(seis_isegy_get_samples_num(sgy, hdr, &samp_num, err));
+        if (next_offset)
+                *next_offset = pos + samp_num * sgy->com->bytes_per_sample;
+        return hdr;
+error:
+        seis_trace_header_unref(&hdr);
+        return NULL;
 }
 
 SeisISU *seis_isu_new(void) {
@@ -264,27 +537,58 @@ void seis_isu_unref(SeisISU **su) {
                 }
 }
 
+void seis_isu_set_io_mode(SeisISU *su, SeisSegyIOMode mode) {
+        seis_isegy_set_io_mode(su->sgy, mode);
+}
+
+void seis_isu_set_buffer_size(SeisISU *su, size_t size) {
+        seis_isegy_set_buffer_size(su->sgy, size);
+}
+
+void seis_isu_set_read_ahead(SeisISU *su, bool enable) {
+        seis_isegy_set_read_ahead(su->sgy, enable);
+}
+
+SeisSegyErrCode seis_isu_set_seek_index(SeisISU *su, char const *file_name) {
+        return seis_isegy_set_seek_index(su->sgy, file_name);
+}
+
+void seis_isu_set_access_hint(SeisISU *su, SeisSegyAccessHint hint) {
+        seis_isegy_set_access_hint(su->sgy, hint);
+}
+
 SeisSegyErrCode seis_isu_open(SeisISU *su, char const *file_name) {
-        SeisISegy *sgy = su->sgy;
+        SeisCommonSegy *com = su->sgy->com;
+        TRY(open_file(su->sgy, file_name));
+        TRY(read_su_headers(su->sgy));
+error:
+        return com->err.code;
+}
+
+SeisSegyErrCode seis_isu_open_backend(SeisISU *su, SeisSegyBackend *backend) {
+        SeisCommonSegy *com = su->sgy->com;
+        TRY(attach_backend(su->sgy, backend));
+        TRY(read_su_headers(su->sgy));
+error:
+        return com->err.code;
+}
+
+SeisSegyErrCode read_su_headers(SeisISegy *sgy) {
         SeisCommonSegy *com = sgy->com;
-        assert(!com->file); /* open func must be called only once */
-        com->file = fopen(file_name, "r");
-        if (!com->file) {
-                com->err.code = SEIS_SEGY_ERR_FILE_OPEN;
-                com->err.message = "file open error";
-                goto error;
-        }
+        SeisTraceHeader *hdr = NULL;
 #ifndef SU_BIG_ENDIAN
         com->bin_hdr.endianness = 0x01020304;
 #endif
         TRY(assign_raw_readers(sgy));
         com->bin_hdr.format_code = 5;
-        sgy->read_sample = dbl_from_IEEE_float_native;
+        sgy->convert = seis_segy_get_converter(5, sgy->read_u32 == read_u32_sw);
+        sgy->convert_f =
+            seis_segy_get_float_converter(5, sgy->read_u32 == read_u32_sw);
         com->bytes_per_sample = 4;
-        sgy->first_trace_pos = ftell(com->file);
+        sgy->first_trace_pos = sgy->curr_pos;
         seis_isegy_remap_trace_header(sgy, "SAMP_NUM", 1, 115, u16);
         seis_isegy_remap_trace_header(sgy, "SAMP_INT", 1, 117, u16);
-        SeisTraceHeader *hdr = seis_trace_header_new();
+        hdr = seis_trace_header_new();
         if (!hdr) {
                 com->err.code = SEIS_SEGY_ERR_NO_MEM;
                 com->err.message = "can't get memory at trace reading";
@@ -293,21 +597,20 @@ SeisSegyErrCode seis_isu_open(SeisISU *su, char const *file_name) {
         TRY(read_trc_hdr(sgy, hdr));
         SeisTraceHeaderValue v = seis_trace_header_get(hdr, "SAMP_NUM");
         long long const *samp_num = seis_trace_header_value_get_int(v);
-        com->samp_per_tr = *samp_num;
         if (!samp_num) {
                 com->err.code = SEIS_SEGY_ERR_BROKEN_FILE;
                 com->err.message =
                     "variable trace length and zero samples number";
                 goto error;
         }
-        fseek(com->file, 0, SEEK_END);
-        sgy->end_of_data = ftell(com->file);
-        fseek(com->file, sgy->first_trace_pos, SEEK_SET);
-        sgy->curr_pos = sgy->first_trace_pos;
+        com->samp_per_tr = *samp_num;
+        sgy->end_of_data = sgy->streaming ? -1 : sgy->file_size;
+        sgy->seek(sgy, sgy->first_trace_pos);
         com->samp_buf =
             (char *)malloc(com->samp_per_tr * com->bytes_per_sample);
-        sgy->read_trc_smpls = read_trc_smpls_fix;
+        sgy->fetch_trc_smpls = fetch_trc_smpls_fix;
         sgy->skip_trc_smpls = skip_trc_smpls_fix;
+        TRY(stream_check_end(sgy));
         seis_trace_header_unref(&hdr);
 error:
         seis_trace_header_unref(&hdr);
@@ -322,10 +625,7 @@ SeisSegyErr const *seis_isu_get_error(SeisISU const *su) {
         return &su->sgy->com->err;
 }
 
-void seis_isu_rewind(SeisISU *su) {
-        fseek(su->sgy->com->file, su->sgy->first_trace_pos, SEEK_SET);
-        su->sgy->curr_pos = su->sgy->first_trace_pos;
-}
+void seis_isu_rewind(SeisISU *su) { seis_isegy_rewind(su->sgy); }
 
 SeisTrace *seis_isu_read_trace(SeisISU *su) {
         SeisTraceHeader *hdr = seis_trace_header_new();
@@ -336,13 +636,52 @@ SeisTrace *seis_isu_read_trace(SeisISU *su) {
         }
         TRY(read_trc_hdr(su->sgy, hdr));
         SeisTrace *trc;
-        TRY(su->sgy->read_trc_smpls(su->sgy, hdr, &trc));
+        TRY(read_trc_smpls(su->sgy, hdr, &trc));
+        if (stream_check_end(su->sgy))
+                seis_trace_unref(&trc);
         return trc;
 error:
         seis_trace_header_unref(&hdr);
         return NULL;
 }
 
+SeisSegyFloatTrace *seis_isu_read_trace_float(SeisISU *su) {
+        SeisTraceHeader *hdr = seis_trace_header_new();
+        if (!hdr) {
+                su->sgy->com->err.code = SEIS_SEGY_ERR_NO_MEM;
+                su->sgy->com->err.message = "can't get memory at trace reading";
+                goto error;
+        }
+        TRY(read_trc_hdr(su->sgy, hdr));
+        SeisSegyFloatTrace *trc;
+        TRY(read_trc_smpls_float(su->sgy, hdr, &trc));
+        if (stream_check_end(su->sgy))
+                seis_segy_float_trace_unref(&trc);
+        return trc;
+error:
+        seis_trace_header_unref(&hdr);
+        return NULL;
+}
+
+SeisSegyErrCode seis_isu_read_trace_into(SeisISU *su, SeisTraceHeader *hdr,
+                                         double *samples, size_t capacity,
+                                         size_t *samp_num) {
+        return read_trace_into(su->sgy, hdr, samples, NULL, capacity,
+                               samp_num);
+}
+
+SeisSegyErrCode seis_isu_read_trace_into_float(SeisISU *su,
+                                               SeisTraceHeader *hdr,
+                                               float *samples, size_t capacity,
+                                               size_t *samp_num) {
+        return read_trace_into(su->sgy, hdr, NULL, samples, capacity,
+                               samp_num);
+}
+
+SeisSegyErrCode seis_isu_read_raw_trace(SeisISU *su, SeisSegyRawTrace *raw) {
+        return read_raw_trace(su->sgy, raw);
+}
+
 SeisTraceHeader *seis_isu_read_trace_header(SeisISU *su) {
         SeisTraceHeader *hdr = seis_trace_header_new();
         if (!hdr) {
@@ -352,31 +691,481 @@ SeisTraceHeader *seis_isu_read_trace_header(SeisISU *su) {
         }
         TRY(read_trc_hdr(su->sgy, hdr));
         su->sgy->skip_trc_smpls(su->sgy, hdr);
+        TRY(stream_check_end(su->sgy));
         return hdr;
 error:
         seis_trace_header_unref(&hdr);
         return NULL;
 }
 
+SeisSegyLazyHeader *seis_isu_read_lazy_header(SeisISU *su) {
+        SeisSegyLazyHeader *hdr = NULL;
+        read_lazy_hdr(su->sgy, &hdr);
+        return hdr;
+}
+
+SeisSegyErrCode seis_isu_read_std_header(SeisISU *su, SeisSegyStdHeader *hdr) {
+        return read_std_hdr(su->sgy, hdr);
+}
+
 SeisSegyErrCode seis_isu_remap_trace_header(SeisISU *su, char const *hdr_name,
                                             int offset, enum FORMAT fmt) {
         return seis_isegy_remap_trace_header(su->sgy, hdr_name, 1, offset, fmt);
 }
 
-SeisSegyErrCode fill_from_file(SeisISegy *sgy, char *buf, size_t num) {
+SeisSegyErrCode seis_isu_set_header_fields(SeisISU *su,
+                                           char const *const *names,
+                                           size_t num) {
+        return seis_isegy_set_header_fields(su->sgy, names, num);
+}
+
+SeisSegyErrCode attach_backend(SeisISegy *sgy, SeisSegyBackend *backend) {
         SeisCommonSegy *com = sgy->com;
-        size_t read = fread(buf, 1, num, com->file);
-        if (read != num) {
+        /* open func must be called only once */
+        assert(!com->backend);
+        com->backend = seis_segy_backend_ref(backend);
+        long long size = seis_segy_backend_size(backend);
+        /* data of unknown size can only be read forward */
+        sgy->streaming = size < 0;
+        sgy->file_size = sgy->streaming ? LONG_MAX : size;
+        sgy->end_of_data = -1;
+        sgy->map = sgy->streaming ? NULL : seis_segy_backend_view(backend);
+        if (sgy->map) {
+                sgy->map_size = size;
+                sgy->fetch = map_fetch;
+                sgy->seek = map_seek;
+        } else {
+                if (!sgy->block_backend)
+                        sgy->block_backend = seis_segy_backend_ref(backend);
+                sgy->block = alloc_block(sgy);
+                if (!sgy->block) {
+                        com->err.code = SEIS_SEGY_ERR_NO_MEM;
+                        com->err.message = "can't get memory for read buffer";
+                        goto error;
+                }
+                sgy->block_len = 0;
+                sgy->block_pos = 0;
+                if (sgy->read_ahead && !sgy->streaming) {
+                        sgy->ahead = alloc_block(sgy);
+                        if (!sgy->ahead) {
+                                com->err.code = SEIS_SEGY_ERR_NO_MEM;
+                                com->err.message =
+                                    "can't get memory for read ahead buffer";
+                                goto error;
+                        }
+                        sgy->ahead_gen = 0;
+                        sgy->ahead_state = AHEAD_NONE;
+                        sgy->io_stop = false;
+                        pthread_mutex_init(&sgy->io_lock, NULL);
+                        pthread_cond_init(&sgy->io_cond, NULL);
+                        if (pthread_create(&sgy->io_thread, NULL,
+                                           read_ahead_worker, sgy)) {
+                                pthread_cond_destroy(&sgy->io_cond);
+                                pthread_mutex_destroy(&sgy->io_lock);
+                                com->err.code = SEIS_SEGY_ERR_FILE_OPEN;
+                                com->err.message =
+                                    "can't start read ahead thread";
+                                goto error;
+                        }
+                        sgy->io_started = true;
+                }
+                sgy->fetch = file_fetch;
+                sgy->seek = file_seek;
+        }
+        sgy->curr_pos = 0;
+        seis_isegy_set_access_hint(sgy, SEIS_SEGY_ACCESS_SEQUENTIAL);
+error:
+        return com->err.code;
+}
+
+SeisSegyErrCode open_file(SeisISegy *sgy, char const *file_name) {
+        SeisCommonSegy *com = sgy->com;
+        SeisSegyBackend *backend = NULL;
+        struct stat st;
+        bool stream = !strcmp(file_name, "-"), gzip = false;
+        if (stream) {
+                backend = seis_segy_backend_stream_new(STDIN_FILENO, false);
+        } else if (stat(file_name, &st) != -1 && !S_ISREG(st.st_mode)) {
+                /* pipes and devices are read as stream in any mode */
+                stream = true;
+                int fd = open(file_name, O_RDONLY);
+                if (fd != -1) {
+                        backend = seis_segy_backend_stream_new(fd, true);
+                        if (!backend)
+                                close(fd);
+                }
+        } else if (is_gzip(file_name)) {
+                /* compressed file is read through decompressor in any mode */
+                gzip = true;
+                backend = seis_segy_backend_gzip_new(file_name,
+                                                     sgy->index_name, 0);
+        } else if (sgy->io_mode == SEIS_SEGY_IO_MMAP) {
+                backend = seis_segy_backend_mmap_new(file_name);
+        } else {
+                int fd = open(file_name, O_RDONLY);
+                if (fd != -1) {
+                        backend = seis_segy_backend_fd_new(fd, true);
+                        if (!backend)
+                                close(fd);
+                }
+        }
+        if (!backend) {
+                com->err.code = SEIS_SEGY_ERR_FILE_OPEN;
+                com->err.message = gzip ? "can't open compressed file"
+                                        : "file open error";
+                goto error;
+        }
+        if (sgy->io_mode == SEIS_SEGY_IO_DIRECT && !stream && !gzip)
+                TRY(open_direct(sgy, file_name));
+        TRY(attach_backend(sgy, backend));
+error:
+        seis_segy_backend_unref(&backend);
+        return com->err.code;
+}
+
+/* serves bytes from block and rereads it only when requested range leaves
+ * it. Position is tracked here, stream position is never used. */
+SeisSegyErrCode file_fetch(SeisISegy *sgy, char *buf, size_t num,
+                           char const **res) {
+        SeisCommonSegy *com = sgy->com;
+        if (sgy->streaming && !in_block(sgy, sgy->curr_pos, num)) {
+                TRY(stream_fill(sgy, num));
+                if (!in_block(sgy, sgy->curr_pos, num))
+                        goto read_error;
+        }
+        if (!in_block(sgy, sgy->curr_pos, num)) {
+                /* too big for block, read it directly. Aligned block
+                 * start could take up to alignment bytes more. */
+                if (num + sgy->block_align - 1 > sgy->block_size) {
+                        if (read_full(com->backend, buf, num, sgy->curr_pos) !=
+                            num)
+                                goto read_error;
+                        if (sgy->io_mode == SEIS_SEGY_IO_DIRECT)
+                                seis_segy_backend_hint(
+                                    com->backend, SEIS_SEGY_ACCESS_DONTNEED,
+                                    sgy->curr_pos, num);
+                        sgy->curr_pos += num;
+                        *res = buf;
+                        goto error;
+                }
+                if (sgy->io_started)
+                        take_ahead(sgy, num);
+                if (!in_block(sgy, sgy->curr_pos, num)) {
+                        sgy->block_pos =
+                            sgy->curr_pos & ~(long)(sgy->block_align - 1);
+                        sgy->block_len =
+                            read_block(sgy, sgy->block, sgy->block_pos);
+                }
+                /* next block is read while caller decodes this one */
+                if (sgy->io_started)
+                        request_ahead(sgy, sgy->block_pos + sgy->block_len);
+                if (!in_block(sgy, sgy->curr_pos, num))
+                        goto read_error;
+        }
+        *res = sgy->block + (sgy->curr_pos - sgy->block_pos);
+        sgy->curr_pos += num;
+error:
+        return com->err.code;
+read_error:
+        com->err.code = SEIS_SEGY_ERR_FILE_READ;
+        com->err.message = "read less bytes than should";
+        return com->err.code;
+}
+
+SeisSegyErrCode map_fetch(SeisISegy *sgy, char *buf, size_t num,
+                          char const **res) {
+        UNUSED(buf);
+        SeisCommonSegy *com = sgy->com;
+        if (sgy->curr_pos < 0 || (size_t)sgy->curr_pos + num > sgy->map_size) {
                 com->err.code = SEIS_SEGY_ERR_FILE_READ;
                 com->err.message = "read less bytes than should";
+                goto error;
+        }
+        *res = sgy->map + sgy->curr_pos;
+        sgy->curr_pos += num;
+error:
+        return com->err.code;
+}
+
+void file_seek(SeisISegy *sgy, long pos) {
+        sgy->curr_pos = pos;
+        /* restart read ahead at new position */
+        if (sgy->io_started && !in_block(sgy, pos, 1))
+                request_ahead(sgy, pos);
+}
+
+void map_seek(SeisISegy *sgy, long pos) { sgy->curr_pos = pos; }
+
+void skip_bytes(SeisISegy *sgy, size_t num) {
+        sgy->seek(sgy, sgy->curr_pos + num);
+}
+
+SeisSegyErrCode fetch_at(SeisISegy const *sgy, char *buf, size_t num,
+                         long pos, char const **res, SeisSegyErr *err) {
+        if (sgy->map) {
+                if (pos < 0 || (size_t)pos + num > sgy->map_size) {
+                        err->code = SEIS_SEGY_ERR_FILE_READ;
+                        err->message = "read less bytes than should";
+                        goto error;
+                }
+                *res = sgy->map + pos;
+                goto error;
+        }
+        if (sgy->streaming) {
+                err->code = SEIS_SEGY_ERR_FILE_READ;
+                err->message = "positional reading needs seekable input";
+                goto error;
+        }
+        /* positional read doesn't move sequential reading position */
+        if (read_full(sgy->com->backend, buf, num, pos) != num) {
+                err->code = SEIS_SEGY_ERR_FILE_READ;
+                err->message = "read less bytes than should";
+                goto error;
+        }
+        *res = buf;
+error:
+        return err->code;
+}
+
+bool in_block(SeisISegy const *sgy, long pos, size_t num) {
+        return pos >= sgy->block_pos &&
+               (size_t)(pos - sgy->block_pos) + num <= sgy->block_len;
+}
+
+/* called with io_lock held */
+bool ahead_covers(SeisISegy const *sgy, long pos, size_t num) {
+        return sgy->ahead_state != AHEAD_NONE && pos >= sgy->ahead_pos &&
+               (size_t)(pos - sgy->ahead_pos) + num <= sgy->block_size;
+}
+
+/* makes read ahead block current if it holds requested bytes. Otherwise
+ * read ahead is cancelled, its result will be dropped. */
+void take_ahead(SeisISegy *sgy, size_t num) {
+        pthread_mutex_lock(&sgy->io_lock);
+        if (ahead_covers(sgy, sgy->curr_pos, num)) {
+                while (sgy->ahead_state != AHEAD_READY)
+                        pthread_cond_wait(&sgy->io_cond, &sgy->io_lock);
+                char *block = sgy->block;
+                sgy->block = sgy->ahead;
+                sgy->ahead = block;
+                sgy->block_pos = sgy->ahead_pos;
+                sgy->block_len = sgy->ahead_len;
+        }
+        ++sgy->ahead_gen;
+        sgy->ahead_state = AHEAD_NONE;
+        pthread_mutex_unlock(&sgy->io_lock);
+}
+
+void request_ahead(SeisISegy *sgy, long pos) {
+        pos &= ~(long)(sgy->block_align - 1);
+        pthread_mutex_lock(&sgy->io_lock);
+        if (pos < sgy->file_size && !ahead_covers(sgy, pos, 1)) {
+                ++sgy->ahead_gen;
+                sgy->ahead_pos = pos;
+                sgy->ahead_state = AHEAD_QUEUED;
+                pthread_cond_broadcast(&sgy->io_cond);
+        }
+        pthread_mutex_unlock(&sgy->io_lock);
+}
+
+void *read_ahead_worker(void *arg) {
+        SeisISegy *sgy = (SeisISegy *)arg;
+        pthread_mutex_lock(&sgy->io_lock);
+        while (1) {
+                while (!sgy->io_stop && sgy->ahead_state != AHEAD_QUEUED)
+                        pthread_cond_wait(&sgy->io_cond, &sgy->io_lock);
+                if (sgy->io_stop)
+                        break;
+                unsigned gen = sgy->ahead_gen;
+                long pos = sgy->ahead_pos;
+                char *buf = sgy->ahead;
+                sgy->ahead_state = AHEAD_RUNNING;
+                pthread_mutex_unlock(&sgy->io_lock);
+                size_t len = read_block(sgy, buf, pos);
+                pthread_mutex_lock(&sgy->io_lock);
+                /* result of cancelled or replaced request is dropped */
+                if (gen == sgy->ahead_gen) {
+                        sgy->ahead_len = len;
+                        sgy->ahead_state = AHEAD_READY;
+                        pthread_cond_broadcast(&sgy->io_cond);
+                }
+        }
+        pthread_mutex_unlock(&sgy->io_lock);
+        return NULL;
+}
+
+/* direct mode reads blocks through separate descriptor opened with
+ * O_DIRECT. Main backend keeps serving positional reads. */
+SeisSegyErrCode open_direct(SeisISegy *sgy, char const *file_name) {
+        SeisCommonSegy *com = sgy->com;
+        int fd = -1;
+        sgy->block_align = DIRECT_ALIGN;
+        sgy->block_size = (sgy->block_size + DIRECT_ALIGN - 1) &
+                          ~(size_t)(DIRECT_ALIGN - 1);
+#ifdef O_DIRECT
+        fd = open(file_name, O_RDONLY | O_DIRECT);
+#endif
+        /* file system without O_DIRECT support, drop pages after reading */
+        if (fd == -1) {
+                fd = open(file_name, O_RDONLY);
+                sgy->drop_cache = true;
+        }
+        if (fd != -1) {
+                sgy->block_backend = seis_segy_backend_fd_new(fd, true);
+                if (!sgy->block_backend)
+                        close(fd);
+        }
+        if (!sgy->block_backend) {
+                com->err.code = SEIS_SEGY_ERR_FILE_OPEN;
+                com->err.message = "file open error";
+        }
+        return com->err.code;
+}
+
+bool is_gzip(char const *file_name) {
+        unsigned char magic[2];
+        FILE *file = fopen(file_name, "rb");
+        if (!file)
+                return false;
+        bool res = fread(magic, 1, 2, file) == 2 && magic[0] == 0x1f &&
+                   magic[1] == 0x8b;
+        fclose(file);
+        return res;
+}
+
+char *alloc_block(SeisISegy const *sgy) {
+        void *res = NULL;
+        if (posix_memalign(&res, sgy->block_align < sizeof(void *)
+                                     ? sizeof(void *)
+                                     : sgy->block_align,
+                           sgy->block_size))
+                return NULL;
+        return (char *)res;
+}
+
+size_t read_block(SeisISegy const *sgy, char *buf, long pos) {
+        size_t len = read_full(sgy->block_backend, buf, sgy->block_size, pos);
+        if (sgy->drop_cache)
+                seis_segy_backend_hint(sgy->block_backend,
+                                       SEIS_SEGY_ACCESS_DONTNEED, pos, len);
+        return len;
+}
+
+/* returns number of bytes read. Less than num only at end of file or on
+ * error */
+size_t read_full(SeisSegyBackend const *b, char *buf, size_t num, long pos) {
+        size_t done = 0;
+        while (done < num) {
+                long long got =
+                    seis_segy_backend_read_at(b, buf + done, num - done,
+                                              pos + done);
+                if (got <= 0)
+                        break;
+                done += got;
+        }
+        return done;
+}
+
+/* stream can't be read twice. Bytes not consumed yet are moved to block
+ * start and block is topped up until it holds num bytes or stream ends. */
+SeisSegyErrCode stream_fill(SeisISegy *sgy, size_t num) {
+        SeisCommonSegy *com = sgy->com;
+        long end = sgy->block_pos + sgy->block_len;
+        if (sgy->curr_pos < sgy->block_pos) {
+                com->err.code = SEIS_SEGY_ERR_FILE_READ;
+                com->err.message = "can't go back in stream";
+                goto error;
+        }
+        if (num > sgy->block_size) {
+                char *block = (char *)realloc(sgy->block, num);
+                if (!block) {
+                        com->err.code = SEIS_SEGY_ERR_NO_MEM;
+                        com->err.message = "can't get memory for read buffer";
+                        goto error;
+                }
+                sgy->block = block;
+                sgy->block_size = num;
+        }
+        size_t len = 0;
+        if (sgy->curr_pos < end) {
+                len = end - sgy->curr_pos;
+                memmove(sgy->block,
+                        sgy->block + (sgy->curr_pos - sgy->block_pos), len);
+        }
+        sgy->block_pos = sgy->curr_pos;
+        while (len < num) {
+                long long got = seis_segy_backend_read_at(
+                    com->backend, sgy->block + len, sgy->block_size - len,
+                    sgy->curr_pos + len);
+                if (got < 0) {
+                        com->err.code = SEIS_SEGY_ERR_FILE_READ;
+                        com->err.message = "stream read error";
+                        goto error;
+                }
+                if (!got)
+                        break;
+                len += got;
+        }
+        sgy->block_len = len;
+error:
+        return com->err.code;
+}
+
+/* stream size is unknown, so end of trace data is found by looking at
+ * bytes which follow current position. Trailer stanzas are read as soon
+ * as trace data is over. */
+SeisSegyErrCode stream_check_end(SeisISegy *sgy) {
+        SeisCommonSegy *com = sgy->com;
+        if (!sgy->streaming || sgy->end_of_data == sgy->curr_pos)
+                return com->err.code;
+        int32_t stanz_num = com->bin_hdr.num_of_trailer_stanza;
+        if (stanz_num == -1) {
+                /* stanzas have no known size, traces are counted */
+                if (!com->bin_hdr.num_of_tr_in_file) {
+                        com->err.code = SEIS_SEGY_ERR_BROKEN_FILE;
+                        com->err.message =
+                            "unable to determine end of trace data";
+                        goto error;
+                }
+                if (sgy->traces_read < com->bin_hdr.num_of_tr_in_file)
+                        goto error;
+                sgy->end_of_data = sgy->curr_pos;
+                TRY(read_end_text_stanzas(sgy));
+        } else {
+                size_t tail = stanz_num > 0
+                                  ? (size_t)stanz_num *
+                                        SEIS_SEGY_TEXT_HEADER_SIZE
+                                  : 0;
+                TRY(stream_fill(sgy, tail + 1));
+                if (in_block(sgy, sgy->curr_pos, tail + 1))
+                        goto error;
+                sgy->end_of_data = sgy->curr_pos;
+                if (stanz_num > 0)
+                        TRY(read_text_header(sgy, seis_common_segy_add_stanza,
+                                             stanz_num));
         }
-        sgy->curr_pos = ftell(com->file);
+        sgy->curr_pos = sgy->end_of_data;
+error:
         return com->err.code;
 }
 
-void file_skip_bytes(SeisISegy *sgy, size_t num) {
-        fseek(sgy->com->file, num, SEEK_CUR);
-        sgy->curr_pos = ftell(sgy->com->file);
+/* reads stanzas up to the one with end mark or up to the end of data */
+SeisSegyErrCode read_end_text_stanzas(SeisISegy *sgy) {
+        SeisCommonSegy *com = sgy->com;
+        char *end_stanza = "((SEG: EndText))";
+        while (1) {
+                TRY(stream_fill(sgy, SEIS_SEGY_TEXT_HEADER_SIZE));
+                if (!in_block(sgy, sgy->curr_pos, SEIS_SEGY_TEXT_HEADER_SIZE))
+                        break;
+                TRY(read_text_header(sgy, seis_common_segy_add_stanza, 1));
+                size_t stanz_read = seis_common_segy_get_stanzas_num(com);
+                char const *last_stanz =
+                    seis_common_segy_get_stanza(com, stanz_read - 1);
+                if (strstr(last_stanz, end_stanza))
+                        break;
+        }
+error:
+        return com->err.code;
 }
 
 SeisSegyErrCode
@@ -384,14 +1173,19 @@ read_text_header(SeisISegy *sgy,
                  void (*add_func)(SeisCommonSegy *, char const *), int num) {
         SeisCommonSegy *com = sgy->com;
         char *text_buf = (char *)malloc(SEIS_SEGY_TEXT_HEADER_SIZE + 1);
-        text_buf[SEIS_SEGY_TEXT_HEADER_SIZE] = '\0';
         if (!text_buf) {
                 com->err.code = SEIS_SEGY_ERR_NO_MEM;
                 com->err.message = "no memory for text header buf";
                 goto error;
         }
+        text_buf[SEIS_SEGY_TEXT_HEADER_SIZE] = '\0';
         for (int i = 0; i < num; ++i) {
-                TRY(fill_from_file(sgy, text_buf, SEIS_SEGY_TEXT_HEADER_SIZE));
+                char const *ptr;
+                TRY(sgy->fetch(sgy, text_buf, SEIS_SEGY_TEXT_HEADER_SIZE,
+                               &ptr));
+                /* mapped data is not zero terminated */
+                if (ptr != text_buf)
+                        memcpy(text_buf, ptr, SEIS_SEGY_TEXT_HEADER_SIZE);
                 add_func(sgy->com, text_buf);
         }
         free(text_buf);
@@ -408,11 +1202,12 @@ SeisSegyErrCode read_bin_header(SeisISegy *sgy) {
         if (!bin_buf) {
                 com->err.code = SEIS_SEGY_ERR_NO_MEM;
                 com->err.message = "no memory for bin header";
+                goto error;
         }
-        TRY(fill_from_file(sgy, bin_buf, SEIS_SEGY_BIN_HEADER_SIZE));
-        memcpy(&com->bin_hdr.endianness, bin_buf + 96, sizeof(int32_t));
+        char const *ptr;
+        TRY(sgy->fetch(sgy, bin_buf, SEIS_SEGY_BIN_HEADER_SIZE, &ptr));
+        memcpy(&com->bin_hdr.endianness, ptr + 96, sizeof(int32_t));
         TRY(assign_raw_readers(sgy));
-        char const *ptr = bin_buf;
         com->bin_hdr.job_id = sgy->read_i32(&ptr);
         com->bin_hdr.line_num = sgy->read_i32(&ptr);
         com->bin_hdr.reel_num = sgy->read_i32(&ptr);
@@ -464,14 +1259,11 @@ error:
 
 SeisSegyErrCode assign_raw_readers(SeisISegy *sgy) {
         SeisCommonSegy *com = sgy->com;
-        sgy->read_i8 = read_i8;
         sgy->read_u8 = read_u8;
         switch (com->bin_hdr.endianness) {
         case 0x01020304:
                 sgy->read_i16 = read_i16;
                 sgy->read_u16 = read_u16;
-                sgy->read_i24 = read_i24;
-                sgy->read_u24 = read_u24;
                 sgy->read_i32 = read_i32;
                 sgy->read_u32 = read_u32;
                 sgy->read_i64 = read_i64;
@@ -481,8 +1273,6 @@ SeisSegyErrCode assign_raw_readers(SeisISegy *sgy) {
         case 0x04030201:
                 sgy->read_i16 = read_i16_sw;
                 sgy->read_u16 = read_u16_sw;
-                sgy->read_i24 = read_i24_sw;
-                sgy->read_u24 = read_u24_sw;
                 sgy->read_i32 = read_i32_sw;
                 sgy->read_u32 = read_u32_sw;
                 sgy->read_i64 = read_i64_sw;
@@ -491,60 +1281,24 @@ SeisSegyErrCode assign_raw_readers(SeisISegy *sgy) {
         default:
                 com->err.code = SEIS_SEGY_ERR_UNKNOWN_ENDIANNESS;
                 com->err.message = "unsupported endianness";
+                return com->err.code;
         }
         if (FLT_RADIX == 2 && DBL_MANT_DIG == 53) {
-                sgy->dbl_from_IEEE_float = dbl_from_IEEE_float_native;
                 sgy->dbl_from_IEEE_double = dbl_from_IEEE_double_native;
         } else {
-                sgy->dbl_from_IEEE_float = dbl_from_IEEE_float;
                 sgy->dbl_from_IEEE_double = dbl_from_IEEE_double;
         }
-        return com->err.code;
+        return seis_common_segy_compile_schema(com,
+                                               sgy->read_u32 == read_u32_sw);
 }
 
 SeisSegyErrCode assign_sample_reader(SeisISegy *sgy) {
         SeisCommonSegy *com = sgy->com;
-        switch (com->bin_hdr.format_code) {
-        case 1:
-                sgy->read_sample = dbl_from_IBM_float;
-                break;
-        case 2:
-                sgy->read_sample = dbl_from_i32;
-                break;
-        case 3:
-                sgy->read_sample = dbl_from_i16;
-                break;
-        case 5:
-                sgy->read_sample = sgy->dbl_from_IEEE_float;
-                break;
-        case 6:
-                sgy->read_sample = sgy->dbl_from_IEEE_double;
-                break;
-        case 7:
-                sgy->read_sample = dbl_from_i24;
-                break;
-        case 8:
-                sgy->read_sample = dbl_from_i8;
-                break;
-        case 9:
-                sgy->read_sample = dbl_from_i64;
-                break;
-        case 10:
-                sgy->read_sample = dbl_from_u32;
-                break;
-        case 11:
-                sgy->read_sample = dbl_from_u16;
-                break;
-        case 12:
-                sgy->read_sample = dbl_from_u64;
-                break;
-        case 15:
-                sgy->read_sample = dbl_from_u24;
-                break;
-        case 16:
-                sgy->read_sample = dbl_from_u8;
-                break;
-        default:
+        bool swap = sgy->read_u32 == read_u32_sw;
+        sgy->convert = seis_segy_get_converter(com->bin_hdr.format_code, swap);
+        sgy->convert_f =
+            seis_segy_get_float_converter(com->bin_hdr.format_code, swap);
+        if (!sgy->convert) {
                 com->err.code = SEIS_SEGY_ERR_UNSUPPORTED_FORMAT;
                 com->err.message = "unsupported format code";
         }
@@ -635,14 +1389,13 @@ SeisSegyErrCode read_trailer_stanzas(SeisISegy *sgy) {
                         if (com->bin_hdr.fixed_tr_length) {
                                 /* assums that fixed length trace should have
                                  * fixed additional trace headers */
-                                fseek(
-                                    com->file,
+                                skip_bytes(
+                                    sgy,
                                     (com->bytes_per_sample * com->samp_per_tr +
                                      SEIS_SEGY_TRACE_HEADER_SIZE *
                                          com->bin_hdr.max_num_add_tr_headers) *
-                                        com->bin_hdr.num_of_tr_in_file,
-                                    SEEK_CUR);
-                                sgy->end_of_data = ftell(com->file);
+                                        com->bin_hdr.num_of_tr_in_file);
+                                sgy->end_of_data = sgy->curr_pos;
                                 char *end_stanza = "((SEG: EndText))";
                                 while (1) {
                                         TRY(read_text_header(
@@ -661,21 +1414,23 @@ SeisSegyErrCode read_trailer_stanzas(SeisISegy *sgy) {
                         } else {
                                 for (uint64_t i = 0;
                                      i < com->bin_hdr.num_of_tr_in_file; ++i) {
-                                        TRY(fill_from_file(
+                                        char const *buf;
+                                        TRY(sgy->fetch(
                                             sgy, com->hdr_buf,
-                                            SEIS_SEGY_TRACE_HEADER_SIZE));
-                                        char const *ptr = com->hdr_buf + 114;
+                                            SEIS_SEGY_TRACE_HEADER_SIZE, &buf));
+                                        char const *ptr = buf + 114;
                                         uint32_t trc_samp_num =
                                             sgy->read_i16(&ptr);
                                         if (com->bin_hdr
                                                 .max_num_add_tr_headers) {
-                                                TRY(fill_from_file(
+                                                TRY(sgy->fetch(
                                                     sgy, com->hdr_buf,
-                                                    SEIS_SEGY_TRACE_HEADER_SIZE));
-                                                ptr = com->hdr_buf + 136;
+                                                    SEIS_SEGY_TRACE_HEADER_SIZE,
+                                                    &buf));
+                                                ptr = buf + 136;
                                                 trc_samp_num =
                                                     sgy->read_u32(&ptr);
-                                                ptr = com->hdr_buf + 156;
+                                                ptr = buf + 156;
                                                 uint16_t add_tr_hdr_num =
                                                     sgy->read_i16(&ptr);
                                                 add_tr_hdr_num =
@@ -683,18 +1438,16 @@ SeisSegyErrCode read_trailer_stanzas(SeisISegy *sgy) {
                                                         ? add_tr_hdr_num
                                                         : com->bin_hdr
                                                               .max_num_add_tr_headers;
-                                                fseek(
-                                                    com->file,
+                                                skip_bytes(
+                                                    sgy,
                                                     (add_tr_hdr_num - 1) *
-                                                        SEIS_SEGY_TRACE_HEADER_SIZE,
-                                                    SEEK_CUR);
+                                                        SEIS_SEGY_TRACE_HEADER_SIZE);
                                         }
-                                        fseek(com->file,
-                                              trc_samp_num *
-                                                  com->bytes_per_sample,
-                                              SEEK_CUR);
+                                        skip_bytes(sgy,
+                                                   trc_samp_num *
+                                                       com->bytes_per_sample);
                                 }
-                                sgy->end_of_data = ftell(com->file);
+                                sgy->end_of_data = sgy->curr_pos;
                                 char *end_stanza = "((SEG: EndText))";
                                 while (1) {
                                         TRY(read_text_header(
@@ -712,11 +1465,10 @@ SeisSegyErrCode read_trailer_stanzas(SeisISegy *sgy) {
                         }
                         /* if we know number of stanzas just read them */
                 } else {
-                        fseek(com->file,
-                              com->bin_hdr.num_of_trailer_stanza *
-                                  SEIS_SEGY_TEXT_HEADER_SIZE,
-                              SEEK_END);
-                        sgy->end_of_data = ftell(com->file);
+                        sgy->seek(sgy, sgy->file_size -
+                                           com->bin_hdr.num_of_trailer_stanza *
+                                               SEIS_SEGY_TEXT_HEADER_SIZE);
+                        sgy->end_of_data = sgy->curr_pos;
                         TRY(read_text_header(
                             sgy, seis_common_segy_add_stanza,
                             com->bin_hdr.num_of_trailer_stanza));
@@ -726,33 +1478,20 @@ SeisSegyErrCode read_trailer_stanzas(SeisISegy *sgy) {
                         free(text_buf);
                 return com->err.code;
         } else {
-                fseek(com->file, 0, SEEK_END);
-                sgy->end_of_data = ftell(com->file);
+                sgy->end_of_data = sgy->file_size;
         }
         return com->err.code;
 }
 
-SeisSegyErrCode read_trc_smpls_fix(SeisISegy *sgy, SeisTraceHeader *hdr,
-                                   SeisTrace **trc) {
-        SeisCommonSegy *com = sgy->com;
-        TRY(fill_from_file(sgy, com->samp_buf,
-                           com->samp_per_tr * com->bytes_per_sample));
-        char const *ptr = com->samp_buf;
-        *trc = seis_trace_new_with_header(com->samp_per_tr, hdr);
-        if (!trc) {
-                com->err.code = SEIS_SEGY_ERR_NO_MEM;
-                com->err.message = "can't get memory at trace sample reading";
-        }
-        double *samples = seis_trace_get_samples(*trc);
-        for (double *end = samples + com->samp_per_tr; samples != end;
-             ++samples)
-                *samples = sgy->read_sample(sgy, &ptr);
-error:
-        return com->err.code;
+SeisSegyErrCode fetch_trc_smpls_fix(SeisISegy *sgy, SeisTraceHeader *hdr,
+                                    char const **ptr, long long *num) {
+        UNUSED(hdr);
+        *num = sgy->com->samp_per_tr;
+        return fetch_smpls(sgy, *num, ptr);
 }
 
-SeisSegyErrCode read_trc_smpls_var(SeisISegy *sgy, SeisTraceHeader *hdr,
-                                   SeisTrace **trc) {
+SeisSegyErrCode fetch_trc_smpls_var(SeisISegy *sgy, SeisTraceHeader *hdr,
+                                    char const **ptr, long long *num) {
         SeisCommonSegy *com = sgy->com;
         SeisTraceHeaderValue v = seis_trace_header_get(hdr, "SAMP_NUM");
         long long const *samp_num = seis_trace_header_value_get_int(v);
@@ -762,28 +1501,237 @@ SeisSegyErrCode read_trc_smpls_var(SeisISegy *sgy, SeisTraceHeader *hdr,
                     "variable trace length and no samples number specified";
                 goto error;
         }
-        if (com->samp_per_tr < *samp_num) {
-                com->samp_per_tr = *samp_num;
-                void *res =
-                    realloc(com->samp_buf, *samp_num * com->bytes_per_sample);
+        *num = *samp_num;
+        TRY(fetch_smpls(sgy, *num, ptr));
+error:
+        return com->err.code;
+}
+
+/* grows samples buffer for variable length traces */
+SeisSegyErrCode fetch_smpls(SeisISegy *sgy, long long num, char const **ptr) {
+        SeisCommonSegy *com = sgy->com;
+        if (com->samp_per_tr < num) {
+                com->samp_per_tr = num;
+                void *res = realloc(com->samp_buf, num * com->bytes_per_sample);
                 if (!res) {
                         com->err.code = SEIS_SEGY_ERR_NO_MEM;
                         com->err.message = "can not allocate memory for "
                                            "trace samples reading";
                         goto error;
                 }
+                com->samp_buf = res;
         }
-        TRY(fill_from_file(sgy, com->samp_buf,
-                           *samp_num * com->bytes_per_sample));
-        char const *ptr = com->samp_buf;
-        *trc = seis_trace_new_with_header(*samp_num, hdr);
-        if (!trc) {
+        TRY(sgy->fetch(sgy, com->samp_buf, num * com->bytes_per_sample, ptr));
+error:
+        return com->err.code;
+}
+
+SeisSegyErrCode read_raw_headers(SeisISegy *sgy, size_t *hdrs_num) {
+        SeisCommonSegy *com = sgy->com;
+        SeisCommonSegyPrivate *priv = (SeisCommonSegyPrivate *)com;
+        size_t const size = SEIS_SEGY_TRACE_HEADER_SIZE;
+        char const *buf;
+        *hdrs_num = 1;
+        /* headers are copied, block could be refilled by next fetch */
+        TRY(reserve_raw(sgy, size));
+        TRY(sgy->fetch(sgy, com->hdr_buf, size, &buf));
+        memcpy(sgy->raw_buf, buf, size);
+        if (com->bin_hdr.max_num_add_tr_headers) {
+                TRY(reserve_raw(sgy, 2 * size));
+                TRY(sgy->fetch(sgy, com->hdr_buf, size, &buf));
+                memcpy(sgy->raw_buf + size, buf, size);
+                long long add_num = 0;
+                seis_segy_hdr_schema_get_int(
+                    priv->schema, 1, sgy->raw_buf + size,
+                    priv->schema->add_hdr_num_slot, &add_num);
+                *hdrs_num = 1 + (add_num ? add_num
+                                         : com->bin_hdr.max_num_add_tr_headers);
+                TRY(reserve_raw(sgy, *hdrs_num * size));
+                for (size_t i = 2; i < *hdrs_num; ++i) {
+                        TRY(sgy->fetch(sgy, com->hdr_buf, size, &buf));
+                        memcpy(sgy->raw_buf + i * size, buf, size);
+                }
+        }
+error:
+        return com->err.code;
+}
+
+SeisSegyErrCode read_raw_trace(SeisISegy *sgy, SeisSegyRawTrace *raw) {
+        SeisCommonSegy *com = sgy->com;
+        SeisCommonSegyPrivate *priv = (SeisCommonSegyPrivate *)com;
+        size_t const size = SEIS_SEGY_TRACE_HEADER_SIZE;
+        size_t hdrs_num;
+        char const *buf;
+        TRY(read_raw_headers(sgy, &hdrs_num));
+        long long samp_num = com->samp_per_tr;
+        if (sgy->fetch_trc_smpls != fetch_trc_smpls_fix) {
+                samp_num = 0;
+                for (size_t i = 0; i < hdrs_num && !samp_num; ++i)
+                        seis_segy_hdr_schema_get_int(
+                            priv->schema, i, sgy->raw_buf + i * size,
+                            priv->schema->samp_num_slot, &samp_num);
+                if (!samp_num) {
+                        com->err.code = SEIS_SEGY_ERR_BROKEN_FILE;
+                        com->err.message = "variable trace length and no "
+                                           "samples number specified";
+                        goto error;
+                }
+        }
+        size_t samp_size = samp_num * com->bytes_per_sample;
+        TRY(fetch_smpls(sgy, samp_num, &buf));
+        /* end of stream check moves bytes inside block */
+        if (sgy->streaming) {
+                TRY(reserve_raw(sgy, hdrs_num * size + samp_size));
+                memcpy(sgy->raw_buf + hdrs_num * size, buf, samp_size);
+                buf = sgy->raw_buf + hdrs_num * size;
+        }
+        ++sgy->traces_read;
+        TRY(stream_check_end(sgy));
+        raw->headers = sgy->raw_buf;
+        raw->headers_size = hdrs_num * size;
+        raw->samples = buf;
+        raw->samples_size = samp_size;
+        raw->samp_num = samp_num;
+        raw->format_code = com->bin_hdr.format_code;
+        raw->big_endian = is_big_endian(sgy);
+error:
+        return com->err.code;
+}
+
+SeisSegyErrCode read_lazy_hdr(SeisISegy *sgy, SeisSegyLazyHeader **hdr) {
+        SeisCommonSegy *com = sgy->com;
+        SeisCommonSegyPrivate *priv = (SeisCommonSegyPrivate *)com;
+        size_t hdrs_num;
+        TRY(read_raw_headers(sgy, &hdrs_num));
+        *hdr = seis_segy_lazy_header_new(priv->schema, sgy->raw_buf, hdrs_num);
+        if (!*hdr) {
+                com->err.code = SEIS_SEGY_ERR_NO_MEM;
+                com->err.message = "can't get memory at trace header reading";
+                goto error;
+        }
+        long long samp_num = com->samp_per_tr;
+        if (sgy->fetch_trc_smpls != fetch_trc_smpls_fix) {
+                long long const *num =
+                    seis_segy_lazy_header_get_int(*hdr, "SAMP_NUM");
+                if (!num || !*num) {
+                        com->err.code = SEIS_SEGY_ERR_BROKEN_FILE;
+                        com->err.message =
+                            "variable trace length and zero samples number";
+                        goto error;
+                }
+                samp_num = *num;
+        }
+        skip_bytes(sgy, samp_num * com->bytes_per_sample);
+        ++sgy->traces_read;
+        TRY(stream_check_end(sgy));
+        return com->err.code;
+error:
+        seis_segy_lazy_header_unref(hdr);
+        return com->err.code;
+}
+
+SeisSegyErrCode read_std_hdr(SeisISegy *sgy, SeisSegyStdHeader *hdr) {
+        SeisCommonSegy *com = sgy->com;
+        size_t hdrs_num;
+        TRY(read_raw_headers(sgy, &hdrs_num));
+        seis_segy_std_header_decode(hdr, sgy->raw_buf,
+                                    hdrs_num * SEIS_SEGY_TRACE_HEADER_SIZE,
+                                    is_big_endian(sgy));
+        long long samp_num = com->samp_per_tr;
+        /* first nonzero number wins as for raw traces */
+        if (sgy->fetch_trc_smpls != fetch_trc_smpls_fix) {
+                samp_num = hdr->samp_num ? (long long)hdr->samp_num
+                                         : (long long)hdr->ext_samp_num;
+                if (samp_num <= 0) {
+                        com->err.code = SEIS_SEGY_ERR_BROKEN_FILE;
+                        com->err.message =
+                            "variable trace length and zero samples number";
+                        goto error;
+                }
+        }
+        skip_bytes(sgy, samp_num * com->bytes_per_sample);
+        ++sgy->traces_read;
+        TRY(stream_check_end(sgy));
+error:
+        return com->err.code;
+}
+
+bool is_big_endian(SeisISegy const *sgy) {
+        return (sgy->read_u32 == read_u32_sw) == host_is_little_endian();
+}
+
+SeisSegyErrCode reserve_raw(SeisISegy *sgy, size_t size) {
+        SeisCommonSegy *com = sgy->com;
+        if (sgy->raw_size < size) {
+                void *res = realloc(sgy->raw_buf, size);
+                if (!res) {
+                        com->err.code = SEIS_SEGY_ERR_NO_MEM;
+                        com->err.message = "can't get memory for raw trace";
+                        goto error;
+                }
+                sgy->raw_buf = (char *)res;
+                sgy->raw_size = size;
+        }
+error:
+        return com->err.code;
+}
+
+SeisSegyErrCode read_trc_smpls(SeisISegy *sgy, SeisTraceHeader *hdr,
+                               SeisTrace **trc) {
+        SeisCommonSegy *com = sgy->com;
+        char const *ptr;
+        long long samp_num;
+        TRY(sgy->fetch_trc_smpls(sgy, hdr, &ptr, &samp_num));
+        *trc = seis_trace_new_with_header(samp_num, hdr);
+        if (!*trc) {
                 com->err.code = SEIS_SEGY_ERR_NO_MEM;
                 com->err.message = "can't get memory at trace sample reading";
+                goto error;
         }
-        double *samples = seis_trace_get_samples(*trc);
-        for (double *end = samples + *samp_num; samples != end; ++samples)
-                *samples = sgy->read_sample(sgy, &ptr);
+        sgy->convert(seis_trace_get_samples(*trc), ptr, samp_num);
+error:
+        return com->err.code;
+}
+
+SeisSegyErrCode read_trc_smpls_float(SeisISegy *sgy, SeisTraceHeader *hdr,
+                                     SeisSegyFloatTrace **trc) {
+        SeisCommonSegy *com = sgy->com;
+        char const *ptr;
+        long long samp_num;
+        TRY(sgy->fetch_trc_smpls(sgy, hdr, &ptr, &samp_num));
+        *trc = seis_segy_float_trace_new_with_header(samp_num, hdr);
+        if (!*trc) {
+                com->err.code = SEIS_SEGY_ERR_NO_MEM;
+                com->err.message = "can't get memory at trace sample reading";
+                goto error;
+        }
+        sgy->convert_f(seis_segy_float_trace_get_samples(*trc), ptr, samp_num);
+error:
+        return com->err.code;
+}
+
+SeisSegyErrCode read_trace_into(SeisISegy *sgy, SeisTraceHeader *hdr,
+                                double *samples, float *fsamples,
+                                size_t capacity, size_t *samp_num) {
+        SeisCommonSegy *com = sgy->com;
+        TRY(read_trc_hdr(sgy, hdr));
+        long long num;
+        TRY(seis_isegy_get_samples_num(sgy, hdr, &num, &com->err));
+        *samp_num = num;
+        /* checked before fetching, so samples are not consumed */
+        if ((size_t)num > capacity) {
+                com->err.code = SEIS_SEGY_ERR_BAD_PARAMS;
+                com->err.message = "samples buffer is too small for trace";
+                goto error;
+        }
+        char const *ptr;
+        TRY(sgy->fetch_trc_smpls(sgy, hdr, &ptr, &num));
+        if (fsamples)
+                sgy->convert_f(fsamples, ptr, num);
+        else
+                sgy->convert(samples, ptr, num);
+        ++sgy->traces_read;
+        TRY(stream_check_end(sgy));
 error:
         return com->err.code;
 }
@@ -791,7 +1739,7 @@ error:
 SeisSegyErrCode skip_trc_smpls_fix(SeisISegy *sgy, SeisTraceHeader *hdr) {
         UNUSED(hdr);
         SeisCommonSegy *com = sgy->com;
-        file_skip_bytes(sgy, com->bytes_per_sample * com->samp_per_tr);
+        skip_bytes(sgy, com->bytes_per_sample * com->samp_per_tr);
         return com->err.code;
 }
 
@@ -805,110 +1753,208 @@ SeisSegyErrCode skip_trc_smpls_var(SeisISegy *sgy, SeisTraceHeader *hdr) {
                     "variable trace length and zero samples number";
                 goto error;
         }
-        file_skip_bytes(sgy, com->bytes_per_sample * *samp_num);
+        skip_bytes(sgy, com->bytes_per_sample * *samp_num);
 error:
         return com->err.code;
 }
 
-void fill_hdr_from_fmt_arr(SeisISegy *sgy, single_hdr_fmt_t *arr,
-                           SeisTraceHeader *hdr) {
+SeisSegyErrCode read_trc_hdr(SeisISegy *sgy, SeisTraceHeader *hdr) {
         SeisCommonSegy *com = sgy->com;
-        char const *ptr;
-        for
-                M_EACH(item, *arr, M_OPL_single_hdr_fmt_t()) {
-                        ptr = com->hdr_buf + (*item)->offset;
-                        switch ((*item)->format) {
-                        case i8:
-                                seis_trace_header_set_int(
-                                    hdr, string_get_cstr((*item)->name),
-                                    sgy->read_i8(&ptr));
-                                break;
-                        case u8:
-                                seis_trace_header_set_int(
-                                    hdr, string_get_cstr((*item)->name),
-                                    sgy->read_u8(&ptr));
-                                break;
-                        case i16:
-                                seis_trace_header_set_int(
-                                    hdr, string_get_cstr((*item)->name),
-                                    sgy->read_i16(&ptr));
-                                break;
-                        case u16:
-                                seis_trace_header_set_int(
-                                    hdr, string_get_cstr((*item)->name),
-                                    sgy->read_u16(&ptr));
-                                break;
-                        case i32:
-                                seis_trace_header_set_int(
-                                    hdr, string_get_cstr((*item)->name),
-                                    sgy->read_i32(&ptr));
-                                break;
-                        case u32:
-                                seis_trace_header_set_int(
-                                    hdr, string_get_cstr((*item)->name),
-                                    sgy->read_u32(&ptr));
-                                break;
-                        case i64:
-                                seis_trace_header_set_int(
-                                    hdr, string_get_cstr((*item)->name),
-                                    sgy->read_i64(&ptr));
-                                break;
-                        case u64:
-                                seis_trace_header_set_int(
-                                    hdr, string_get_cstr((*item)->name),
-                                    sgy->read_u64(&ptr));
-                                break;
-                        case f32:
-                                seis_trace_header_set_real(
-                                    hdr, string_get_cstr((*item)->name),
-                                    sgy->dbl_from_IEEE_float(sgy, (&ptr)));
-                                break;
-                        case f64:
-                                seis_trace_header_set_real(
-                                    hdr, string_get_cstr((*item)->name),
-                                    sgy->dbl_from_IEEE_double(sgy, (&ptr)));
-                                break;
-                        case b64:
-                                break;
-                        }
+        SeisCommonSegyPrivate *priv = (SeisCommonSegyPrivate *)com;
+        char const *buf;
+        TRY(sgy->fetch(sgy, com->hdr_buf, SEIS_SEGY_TRACE_HEADER_SIZE, &buf));
+        seis_segy_hdr_schema_decode(priv->schema, 0, buf, hdr);
+        if (com->bin_hdr.max_num_add_tr_headers) {
+                TRY(sgy->fetch(sgy, com->hdr_buf, SEIS_SEGY_TRACE_HEADER_SIZE,
+                               &buf));
+                seis_segy_hdr_schema_decode(priv->schema, 1, buf, hdr);
+                int to_read = add_hdrs_left(sgy, hdr);
+                for (int i = 2; i < 2 + to_read; ++i) {
+                        TRY(sgy->fetch(sgy, com->hdr_buf,
+                                       SEIS_SEGY_TRACE_HEADER_SIZE, &buf));
+                        seis_segy_hdr_schema_decode(priv->schema, i, buf,
+                                                    hdr);
                 }
+        }
+error:
+        return com->err.code;
 }
 
-SeisSegyErrCode read_trc_hdr(SeisISegy *sgy, SeisTraceHeader *hdr) {
-        SeisCommonSegy *com = sgy->com;
+int add_hdrs_left(SeisISegy const *sgy, SeisTraceHeader const *hdr) {
+        SeisTraceHeaderValue v = seis_trace_header_get(hdr, "ADD_HDR_NUM");
+        long long const *add_hdr_num = seis_trace_header_value_get_int(v);
+        if (!add_hdr_num || !*add_hdr_num)
+                return sgy->com->bin_hdr.max_num_add_tr_headers - 1;
+        return *add_hdr_num - 1;
+}
+
+SeisSegyErrCode read_trc_hdr_at(SeisISegy const *sgy, long *pos,
+                                SeisTraceHeader *hdr, SeisSegyErr *err) {
+        SeisCommonSegy const *com = sgy->com;
         SeisCommonSegyPrivate *priv = (SeisCommonSegyPrivate *)com;
-        TRY(fill_from_file(sgy, com->hdr_buf, SEIS_SEGY_TRACE_HEADER_SIZE));
-        fill_hdr_from_fmt_arr(sgy, mult_hdr_fmt_get(priv->trc_hdr_map, 0), hdr);
+        char scratch[SEIS_SEGY_TRACE_HEADER_SIZE];
+        char const *buf;
+        TRY(fetch_at(sgy, scratch, SEIS_SEGY_TRACE_HEADER_SIZE, *pos, &buf,
+                     err));
+        *pos += SEIS_SEGY_TRACE_HEADER_SIZE;
+        seis_segy_hdr_schema_decode(priv->schema, 0, buf, hdr);
         if (com->bin_hdr.max_num_add_tr_headers) {
-                TRY(fill_from_file(sgy, com->hdr_buf,
-                                   SEIS_SEGY_TRACE_HEADER_SIZE));
-                fill_hdr_from_fmt_arr(
-                    sgy, mult_hdr_fmt_get(priv->trc_hdr_map, 1), hdr);
-                SeisTraceHeaderValue v =
-                    seis_trace_header_get(hdr, "ADD_HDR_NUM");
-                long long const *add_hdr_num =
-                    seis_trace_header_value_get_int(v);
-                int to_read;
-                if (!*add_hdr_num)
-                        to_read = com->bin_hdr.max_num_add_tr_headers - 1;
-                else
-                        to_read = *add_hdr_num - 1;
+                TRY(fetch_at(sgy, scratch, SEIS_SEGY_TRACE_HEADER_SIZE, *pos,
+                             &buf, err));
+                *pos += SEIS_SEGY_TRACE_HEADER_SIZE;
+                seis_segy_hdr_schema_decode(priv->schema, 1, buf, hdr);
+                int to_read = add_hdrs_left(sgy, hdr);
                 for (int i = 2; i < 2 + to_read; ++i) {
-                        TRY(fill_from_file(sgy, com->hdr_buf,
-                                           SEIS_SEGY_TRACE_HEADER_SIZE));
-                        fill_hdr_from_fmt_arr(
-                            sgy, mult_hdr_fmt_get(priv->trc_hdr_map, i), hdr);
+                        TRY(fetch_at(sgy, scratch, SEIS_SEGY_TRACE_HEADER_SIZE,
+                                     *pos, &buf, err));
+                        *pos += SEIS_SEGY_TRACE_HEADER_SIZE;
+                        seis_segy_hdr_schema_decode(priv->schema, i, buf,
+                                                    hdr);
                 }
         }
 error:
-        return com->err.code;
+        return err->code;
 }
 
-int8_t read_i8(char const **buf) {
-        int8_t res;
-        memcpy(&res, *buf, sizeof(int8_t));
-        ++*buf;
-        return res;
+SeisSegyErrCode seis_isegy_fetch_at(SeisISegy const *sgy, char *buf,
+                                    size_t num, size_t offset,
+                                    char const **res, SeisSegyErr *err) {
+        return fetch_at(sgy, buf, num, offset, res, err);
+}
+
+void seis_isegy_will_need(SeisISegy const *sgy, size_t offset, size_t num) {
+        seis_segy_backend_hint(sgy->com->backend, SEIS_SEGY_ACCESS_WILLNEED,
+                               offset, num);
+}
+
+bool seis_isegy_is_mapped(SeisISegy const *sgy) { return sgy->map; }
+
+int seis_isegy_get_fd(SeisISegy const *sgy) {
+        return sgy->map ? -1 : seis_segy_backend_get_fd(sgy->com->backend);
+}
+
+int seis_isegy_get_bytes_per_sample(SeisISegy const *sgy) {
+        return sgy->com->bytes_per_sample;
+}
+
+size_t seis_isegy_get_max_headers_size(SeisISegy const *sgy) {
+        return SEIS_SEGY_TRACE_HEADER_SIZE *
+               (1 + sgy->com->bin_hdr.max_num_add_tr_headers);
+}
+
+size_t seis_isegy_get_fixed_samples_size(SeisISegy const *sgy) {
+        if (sgy->fetch_trc_smpls != fetch_trc_smpls_fix)
+                return 0;
+        return sgy->com->samp_per_tr * sgy->com->bytes_per_sample;
+}
+
+bool seis_isegy_get_traces_range(SeisISegy const *sgy, size_t *first,
+                                 size_t *end) {
+        if (sgy->end_of_data < 0 || sgy->end_of_data < sgy->first_trace_pos)
+                return false;
+        *first = sgy->first_trace_pos;
+        *end = sgy->end_of_data;
+        return true;
+}
+
+SeisSegyHdrSchema *seis_isegy_get_hdr_schema(SeisISegy const *sgy) {
+        return ((SeisCommonSegyPrivate *)sgy->com)->schema;
+}
+
+SeisSegyErrCode seis_isegy_decode_trace_header(SeisISegy const *sgy,
+                                               char const *buf, size_t size,
+                                               SeisTraceHeader *hdr,
+                                               size_t *used, SeisSegyErr *err) {
+        SeisCommonSegy const *com = sgy->com;
+        SeisCommonSegyPrivate *priv = (SeisCommonSegyPrivate *)com;
+        size_t blocks = 1;
+        if (size < SEIS_SEGY_TRACE_HEADER_SIZE)
+                goto short_buf;
+        seis_segy_hdr_schema_decode(priv->schema, 0, buf, hdr);
+        if (com->bin_hdr.max_num_add_tr_headers) {
+                if (size < 2 * SEIS_SEGY_TRACE_HEADER_SIZE)
+                        goto short_buf;
+                seis_segy_hdr_schema_decode(priv->schema, 1,
+                                            buf + SEIS_SEGY_TRACE_HEADER_SIZE,
+                                            hdr);
+                blocks = 2 + add_hdrs_left(sgy, hdr);
+                if (size < blocks * SEIS_SEGY_TRACE_HEADER_SIZE)
+                        goto short_buf;
+                for (size_t i = 2; i < blocks; ++i)
+                        seis_segy_hdr_schema_decode(
+                            priv->schema, i,
+                            buf + i * SEIS_SEGY_TRACE_HEADER_SIZE, hdr);
+        }
+        *used = blocks * SEIS_SEGY_TRACE_HEADER_SIZE;
+        return err->code;
+short_buf:
+        err->code = SEIS_SEGY_ERR_FILE_READ;
+        err->message = "read less bytes than should";
+        return err->code;
+}
+
+SeisSegyErrCode seis_isegy_decode_trace_samples(SeisISegy const *sgy,
+                                                char const *buf,
+                                                long long samp_num,
+                                                SeisTraceHeader *hdr,
+                                                SeisTrace **trc,
+                                                SeisSegyErr *err) {
+        *trc = seis_trace_new_with_header(samp_num, hdr);
+        if (!*trc) {
+                err->code = SEIS_SEGY_ERR_NO_MEM;
+                err->message = "can't get memory at trace sample reading";
+                goto error;
+        }
+        sgy->convert(seis_trace_get_samples(*trc), buf, samp_num);
+error:
+        return err->code;
+}
+
+SeisSegyErrCode seis_isegy_get_samples_num(SeisISegy const *sgy,
+                                           SeisTraceHeader const *hdr,
+                                           long long *num, SeisSegyErr *err) {
+        if (sgy->fetch_trc_smpls == fetch_trc_smpls_fix) {
+                *num = sgy->com->samp_per_tr;
+                goto error;
+        }
+        SeisTraceHeaderValue v = seis_trace_header_get(hdr, "SAMP_NUM");
+        long long const *samp_num = seis_trace_header_value_get_int(v);
+        if (!samp_num || !*samp_num) {
+                err->code = SEIS_SEGY_ERR_BROKEN_FILE;
+                err->message =
+                    "variable trace length and no samples number specified";
+                goto error;
+        }
+        *num = *samp_num;
+error:
+        return err->code;
+}
+
+SeisSegyErrCode read_trc_smpls_at(SeisISegy const *sgy, long *pos,
+                                  SeisTraceHeader *hdr, SeisTrace **trc,
+                                  SeisSegyErr *err) {
+        long long samp_num;
+        TRY(seis_isegy_get_samples_num(sgy, hdr, &samp_num, err));
+        *trc = seis_trace_new_with_header(samp_num, hdr);
+        if (!*trc) {
+                err->code = SEIS_SEGY_ERR_NO_MEM;
+                err->message = "can't get memory at trace sample reading";
+                goto error;
+        }
+        double *samples = seis_trace_get_samples(*trc);
+        size_t bytes = samp_num * sgy->com->bytes_per_sample;
+        /* raw samples are read into the tail of the output array and
+         * decoded front to back. Sample never takes more than 8 bytes, so
+         * output can't overtake unread input and no scratch is needed.
+         * Converters go front to back as well and vector kernels load
+         * whole block before storing it. */
+        char *raw = (char *)samples + samp_num * sizeof(double) - bytes;
+        char const *ptr;
+        TRY(fetch_at(sgy, raw, bytes, *pos, &ptr, err));
+        *pos += bytes;
+        sgy->convert(samples, ptr, samp_num);
+error:
+        return err->code;
 }
 
 uint8_t read_u8(char const **buf) {
@@ -932,20 +1978,6 @@ uint16_t read_u16(char const **buf) {
         return res;
 }
 
-int32_t read_i24(char const **buf) {
-        int32_t res;
-        memcpy(&res, *buf, sizeof(int16_t) + sizeof(int8_t));
-        *buf += sizeof(int16_t) + sizeof(int8_t);
-        return res;
-}
-
-uint32_t read_u24(char const **buf) {
-        uint32_t res;
-        memcpy(&res, *buf, sizeof(uint16_t) + sizeof(uint8_t));
-        *buf += sizeof(uint16_t) + sizeof(uint8_t);
-        return res;
-}
-
 int32_t read_i32(char const **buf) {
         int32_t res;
         memcpy(&res, *buf, sizeof(int32_t));
@@ -975,88 +2007,30 @@ uint64_t read_u64(char const **buf) {
 }
 
 int16_t read_i16_sw(char const **buf) {
-        uint16_t res;
-        memcpy(&res, *buf, sizeof(int16_t));
-        *buf += sizeof(uint16_t);
-        return (int16_t)((res & 0xff) << 8 | (res & 0xff00) >> 8);
+        return (int16_t)bswap16(read_u16(buf));
 }
 
 uint16_t read_u16_sw(char const **buf) {
-        uint16_t res;
-        memcpy(&res, *buf, sizeof(uint16_t));
-        *buf += sizeof(uint16_t);
-        return (res & 0xff) << 8 | (res & 0xff00) >> 8;
-}
-
-int32_t read_i24_sw(char const **buf) {
-        uint32_t res = 0;
-        memcpy(&res, *buf, sizeof(int16_t) + sizeof(int8_t));
-        *buf += sizeof(int16_t) + sizeof(int8_t);
-        return (int32_t)((res & 0xff) << 24 | (res & 0xff000000) >> 24 |
-                         (res & 0xff00) << 8 | (res & 0xff0000) >> 8);
-}
-
-uint32_t read_u24_sw(char const **buf) {
-        uint32_t res = 0;
-        memcpy(&res, *buf, sizeof(uint16_t) + sizeof(uint8_t));
-        *buf += sizeof(uint16_t) + sizeof(uint8_t);
-        return ((res & 0xff) << 24 | (res & 0xff000000) >> 24 |
-                (res & 0xff00) << 8 | (res & 0xff0000) >> 8);
+        return bswap16(read_u16(buf));
 }
 
 int32_t read_i32_sw(char const **buf) {
-        uint32_t res;
-        memcpy(&res, *buf, sizeof(int32_t));
-        *buf += sizeof(uint32_t);
-        return (int32_t)((res & 0xff) << 24 | (res & 0xff000000) >> 24 |
-                         (res & 0xff00) << 8 | (res & 0xff0000) >> 8);
+        return (int32_t)bswap32(read_u32(buf));
 }
 
 uint32_t read_u32_sw(char const **buf) {
-        uint32_t res;
-        memcpy(&res, *buf, sizeof(int32_t));
-        *buf += sizeof(uint32_t);
-        return (res & 0xff) << 24 | (res & 0xff000000) >> 24 |
-               (res & 0xff00) << 8 | (res & 0xff0000) >> 8;
+        return bswap32(read_u32(buf));
 }
 
 int64_t read_i64_sw(char const **buf) {
-        uint64_t res;
-        memcpy(&res, *buf, sizeof(int64_t));
-        *buf += sizeof(uint64_t);
-        return (int64_t)((res & 0xff) << 56 | (res & 0xff00000000000000) >> 56 |
-                         (res & 0xff00) << 40 | (res & 0xff000000000000) >> 40 |
-                         (res & 0xff0000) << 24 | (res & 0xff0000000000) >> 24 |
-                         (res & 0xff000000) << 8 | (res & 0xff00000000) >> 8);
+        return (int64_t)bswap64(read_u64(buf));
 }
 
 uint64_t read_u64_sw(char const **buf) {
-        uint64_t res;
-        memcpy(&res, *buf, sizeof(int64_t));
-        *buf += sizeof(uint64_t);
-        return ((res & 0xff) << 56 | (res & 0xff00000000000000) >> 56 |
-                (res & 0xff00) << 40 | (res & 0xff000000000000) >> 40 |
-                (res & 0xff0000) << 24 | (res & 0xff0000000000) >> 24 |
-                (res & 0xff000000) << 8 | (res & 0xff00000000) >> 8);
-}
-
-double dbl_from_IBM_float(SeisISegy *sgy, char const **buf) {
-        uint32_t ibm = sgy->read_u32(buf);
-        int sign = ibm >> 31 ? -1 : 1;
-        int exp = ibm >> 24 & 0x7f;
-        uint32_t fraction = ibm & 0x00ffffff;
-        return fraction / pow(2, 24) * pow(16, exp - 64) * sign;
-}
-
-double dbl_from_IEEE_float(SeisISegy *sgy, char const **buf) {
-        uint32_t tmp = sgy->read_u32(buf);
-        int sign = tmp >> 31 ? -1 : 1;
-        int exp = (tmp & 0x7fffffff) >> 23;
-        uint32_t fraction = tmp & 0x7fffff;
-        return sign * pow(2, exp - 127) * (1 + fraction / pow(2, 23));
+        return bswap64(read_u64(buf));
 }
 
-double dbl_from_IEEE_double(SeisISegy *sgy, char const **buf) {
+double dbl_from_IEEE_double(SeisISegy const *sgy, char const **buf) {
         uint64_t tmp = sgy->read_u64(buf);
         int sign = tmp >> 63 ? -1 : 1;
         int exp = (tmp & 0x7fffffffffffffff) >> 52;
@@ -1064,56 +2038,10 @@ double dbl_from_IEEE_double(SeisISegy *sgy, char const **buf) {
         return sign * pow(2, exp - 1023) * (1 + fraction / pow(2, 52));
 }
 
-double dbl_from_IEEE_float_native(SeisISegy *sgy, char const **buf) {
-        uint32_t tmp = sgy->read_u32(buf);
-        float result;
-        memcpy(&result, &tmp, sizeof(result));
-        return (double)result;
-}
-
-double dbl_from_IEEE_double_native(SeisISegy *sgy, char const **buf) {
+double dbl_from_IEEE_double_native(SeisISegy const *sgy,
+                                   char const **buf) {
         uint64_t tmp = sgy->read_u64(buf);
         double result;
         memcpy(&result, &tmp, sizeof(result));
         return result;
 }
-
-double dbl_from_i8(SeisISegy *sgy, char const **buf) {
-        return sgy->read_i8(buf);
-}
-
-double dbl_from_u8(SeisISegy *sgy, char const **buf) {
-        return sgy->read_u8(buf);
-}
-
-double dbl_from_i16(SeisISegy *sgy, char const **buf) {
-        return sgy->read_i16(buf);
-}
-
-double dbl_from_u16(SeisISegy *sgy, char const **buf) {
-        return sgy->read_u16(buf);
-}
-
-double dbl_from_i24(SeisISegy *sgy, char const **buf) {
-        return sgy->read_i24(buf);
-}
-
-double dbl_from_u24(SeisISegy *sgy, char const **buf) {
-        return sgy->read_u24(buf);
-}
-
-double dbl_from_i32(SeisISegy *sgy, char const **buf) {
-        return sgy->read_i32(buf);
-}
-
-double dbl_from_u32(SeisISegy *sgy, char const **buf) {
-        return sgy->read_u32(buf);
-}
-
-double dbl_from_i64(SeisISegy *sgy, char const **buf) {
-        return sgy->read_i64(buf);
-}
-
-double dbl_from_u64(SeisISegy *sgy, char const **buf) {
-        return sgy->read_u64(buf);
-}
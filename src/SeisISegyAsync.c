@@ -0,0 +1,458 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "SeisISegyAsync.h"
+#include "SeisCommonSegy.h"
+#include "SeisISegy.h"
+#include "SeisISegyPrivate.h"
+#include "TRY.h"
+#include <SeisTrace.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef SEIS_SEGY_HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+struct request {
+        size_t seq;
+        size_t offset;
+};
+
+struct completion {
+        size_t seq;
+        SeisTrace *trc;
+        SeisSegyErr err;
+};
+
+#ifdef SEIS_SEGY_HAVE_LIBURING
+/* one read in flight. Variable trace length needs two reads: headers first,
+ * then samples, whose number is known only after headers decoding. */
+struct slot {
+        struct request req;
+        char *buf;
+        size_t cap, want, got;
+        size_t base;
+        size_t hdrs_size;
+        SeisTraceHeader *hdr;
+        bool busy;
+};
+#endif
+
+struct SeisISegyAsync {
+        SeisISegy *sgy;
+        SeisSegyErr err;
+        unsigned depth;
+        struct request *reqs;
+        size_t reqs_head, reqs_num, reqs_cap;
+        struct completion *done;
+        size_t done_head, done_num, done_cap;
+        size_t submitted, reaped;
+        pthread_mutex_t lock;
+        pthread_cond_t work_cond, done_cond;
+        pthread_t *workers;
+        unsigned workers_num;
+        bool stop;
+        bool use_ring;
+#ifdef SEIS_SEGY_HAVE_LIBURING
+        struct io_uring ring;
+        struct slot *slots;
+        unsigned in_flight;
+#endif
+        int rc;
+};
+
+static SeisSegyErrCode reserve(SeisISegyAsync *as, size_t num);
+static void *worker(void *arg);
+static SeisTrace *pool_reap(SeisISegyAsync *as, size_t *seq);
+#ifdef SEIS_SEGY_HAVE_LIBURING
+static void ring_fill(SeisISegyAsync *as);
+static void ring_prep(SeisISegyAsync *as, struct slot *s);
+static bool ring_advance(SeisISegyAsync *as, struct slot *s, int res,
+                         struct completion *c);
+static SeisTrace *ring_reap(SeisISegyAsync *as, size_t *seq);
+#endif
+
+SeisISegyAsync *seis_isegy_async_new(SeisISegy *sgy, unsigned queue_depth) {
+        SeisISegyAsync *as = (SeisISegyAsync *)calloc(1, sizeof(*as));
+        if (!as)
+                return NULL;
+        pthread_mutex_init(&as->lock, NULL);
+        pthread_cond_init(&as->work_cond, NULL);
+        pthread_cond_init(&as->done_cond, NULL);
+        as->sgy = seis_isegy_ref(sgy);
+        as->err.code = SEIS_SEGY_ERR_OK;
+        as->err.message = "";
+        as->depth = queue_depth ? queue_depth : 1;
+        as->rc = 1;
+#ifdef SEIS_SEGY_HAVE_LIBURING
+        /* mapped files and old kernels are served by thread pool */
+        if (seis_isegy_get_fd(sgy) != -1 &&
+            !io_uring_queue_init(as->depth, &as->ring, 0)) {
+                as->slots =
+                    (struct slot *)calloc(as->depth, sizeof(struct slot));
+                if (!as->slots) {
+                        io_uring_queue_exit(&as->ring);
+                        goto error;
+                }
+                as->use_ring = true;
+                /* buffers are reserved for headers and fixed length
+                 * samples, so filling slots never fails */
+                size_t size = seis_isegy_get_max_headers_size(sgy) +
+                              seis_isegy_get_fixed_samples_size(sgy);
+                for (unsigned i = 0; i < as->depth; ++i) {
+                        as->slots[i].buf = (char *)malloc(size);
+                        if (!as->slots[i].buf)
+                                goto error;
+                        as->slots[i].cap = size;
+                }
+                return as;
+        }
+#endif
+        as->workers = (pthread_t *)malloc(as->depth * sizeof(pthread_t));
+        if (!as->workers)
+                goto error;
+        for (unsigned i = 0; i < as->depth; ++i) {
+                if (pthread_create(&as->workers[i], NULL, worker, as))
+                        break;
+                ++as->workers_num;
+        }
+        if (!as->workers_num)
+                goto error;
+        return as;
+error:
+        seis_isegy_async_unref(&as);
+        return NULL;
+}
+
+SeisISegyAsync *seis_isegy_async_ref(SeisISegyAsync *as) {
+        ++as->rc;
+        return as;
+}
+
+void seis_isegy_async_unref(SeisISegyAsync **as) {
+        if (*as)
+                if (--(*as)->rc == 0) {
+                        SeisISegyAsync *a = *as;
+                        pthread_mutex_lock(&a->lock);
+                        /* drop not started reads */
+                        a->reqs_num = 0;
+                        a->stop = true;
+                        pthread_cond_broadcast(&a->work_cond);
+                        pthread_mutex_unlock(&a->lock);
+                        for (unsigned i = 0; i < a->workers_num; ++i)
+                                pthread_join(a->workers[i], NULL);
+                        free(a->workers);
+#ifdef SEIS_SEGY_HAVE_LIBURING
+                        if (a->use_ring) {
+                                while (a->in_flight) {
+                                        struct io_uring_cqe *cqe;
+                                        if (io_uring_wait_cqe(&a->ring, &cqe))
+                                                break;
+                                        io_uring_cqe_seen(&a->ring, cqe);
+                                        --a->in_flight;
+                                }
+                                io_uring_queue_exit(&a->ring);
+                                for (unsigned i = 0; i < a->depth; ++i) {
+                                        seis_trace_header_unref(
+                                            &a->slots[i].hdr);
+                                        free(a->slots[i].buf);
+                                }
+                                free(a->slots);
+                        }
+#endif
+                        for (size_t i = 0; i < a->done_num; ++i)
+                                seis_trace_unref(
+                                    &a->done[a->done_head + i].trc);
+                        free(a->done);
+                        free(a->reqs);
+                        pthread_cond_destroy(&a->done_cond);
+                        pthread_cond_destroy(&a->work_cond);
+                        pthread_mutex_destroy(&a->lock);
+                        seis_isegy_unref(&a->sgy);
+                        free(a);
+                        *as = NULL;
+                }
+}
+
+SeisSegyErr const *seis_isegy_async_get_error(SeisISegyAsync const *as) {
+        return &as->err;
+}
+
+bool seis_isegy_async_uses_io_uring(SeisISegyAsync const *as) {
+        return as->use_ring;
+}
+
+SeisSegyErrCode seis_isegy_async_submit_offsets(SeisISegyAsync *as,
+                                                size_t const *offsets,
+                                                size_t num) {
+        pthread_mutex_lock(&as->lock);
+        if (reserve(as, num)) {
+                pthread_mutex_unlock(&as->lock);
+                goto error;
+        }
+        for (size_t i = 0; i < num; ++i) {
+                struct request *r = &as->reqs[as->reqs_head + as->reqs_num++];
+                r->seq = as->submitted++;
+                r->offset = offsets[i];
+        }
+        pthread_cond_broadcast(&as->work_cond);
+        pthread_mutex_unlock(&as->lock);
+#ifdef SEIS_SEGY_HAVE_LIBURING
+        if (as->use_ring)
+                ring_fill(as);
+#endif
+error:
+        return as->err.code;
+}
+
+SeisSegyErrCode seis_isegy_async_submit_indices(SeisISegyAsync *as,
+                                                size_t const *indices,
+                                                size_t num) {
+        size_t *offsets = NULL;
+        if (!seis_isegy_get_fixed_samples_size(as->sgy)) {
+                as->err.code = SEIS_SEGY_ERR_BAD_PARAMS;
+                as->err.message = "trace indices need fixed trace length";
+                goto error;
+        }
+        offsets = (size_t *)malloc(num * sizeof(size_t));
+        if (!offsets && num) {
+                as->err.code = SEIS_SEGY_ERR_NO_MEM;
+                as->err.message = "can't get memory for trace offsets";
+                goto error;
+        }
+        for (size_t i = 0; i < num; ++i)
+                offsets[i] = seis_isegy_get_trace_offset(as->sgy, indices[i]);
+        seis_isegy_async_submit_offsets(as, offsets, num);
+error:
+        free(offsets);
+        return as->err.code;
+}
+
+size_t seis_isegy_async_pending(SeisISegyAsync const *as) {
+        /* both counters change only in caller thread */
+        return as->submitted - as->reaped;
+}
+
+SeisTrace *seis_isegy_async_reap(SeisISegyAsync *as, size_t *seq) {
+        if (as->submitted == as->reaped)
+                return NULL;
+#ifdef SEIS_SEGY_HAVE_LIBURING
+        if (as->use_ring)
+                return ring_reap(as, seq);
+#endif
+        return pool_reap(as, seq);
+}
+
+/* makes room for num more requests and their completions. Called with lock
+ * held, so workers never need to allocate. */
+SeisSegyErrCode reserve(SeisISegyAsync *as, size_t num) {
+        if (as->reqs_head + as->reqs_num + num > as->reqs_cap) {
+                memmove(as->reqs, as->reqs + as->reqs_head,
+                        as->reqs_num * sizeof(struct request));
+                as->reqs_head = 0;
+        }
+        if (as->reqs_num + num > as->reqs_cap) {
+                size_t cap = (as->reqs_num + num) * 2;
+                void *res = realloc(as->reqs, cap * sizeof(struct request));
+                if (!res)
+                        goto error;
+                as->reqs = (struct request *)res;
+                as->reqs_cap = cap;
+        }
+        size_t outstanding = as->submitted - as->reaped + num;
+        if (as->done_head + outstanding > as->done_cap) {
+                memmove(as->done, as->done + as->done_head,
+                        as->done_num * sizeof(struct completion));
+                as->done_head = 0;
+        }
+        if (outstanding > as->done_cap) {
+                size_t cap = outstanding * 2;
+                void *res = realloc(as->done, cap * sizeof(struct completion));
+                if (!res)
+                        goto error;
+                as->done = (struct completion *)res;
+                as->done_cap = cap;
+        }
+        return as->err.code;
+error:
+        as->err.code = SEIS_SEGY_ERR_NO_MEM;
+        as->err.message = "can't get memory for read requests";
+        return as->err.code;
+}
+
+void *worker(void *arg) {
+        SeisISegyAsync *as = (SeisISegyAsync *)arg;
+        pthread_mutex_lock(&as->lock);
+        while (1) {
+                while (!as->stop && !as->reqs_num)
+                        pthread_cond_wait(&as->work_cond, &as->lock);
+                if (!as->reqs_num)
+                        break;
+                struct request req = as->reqs[as->reqs_head++];
+                if (!--as->reqs_num)
+                        as->reqs_head = 0;
+                pthread_mutex_unlock(&as->lock);
+                struct completion c;
+                c.seq = req.seq;
+                c.trc = seis_isegy_read_trace_at(as->sgy, req.offset, NULL,
+                                                 &c.err);
+                pthread_mutex_lock(&as->lock);
+                as->done[as->done_head + as->done_num++] = c;
+                pthread_cond_signal(&as->done_cond);
+        }
+        pthread_mutex_unlock(&as->lock);
+        return NULL;
+}
+
+SeisTrace *pool_reap(SeisISegyAsync *as, size_t *seq) {
+        pthread_mutex_lock(&as->lock);
+        while (!as->done_num)
+                pthread_cond_wait(&as->done_cond, &as->lock);
+        struct completion c = as->done[as->done_head++];
+        if (!--as->done_num)
+                as->done_head = 0;
+        pthread_mutex_unlock(&as->lock);
+        ++as->reaped;
+        if (!c.trc)
+                as->err = c.err;
+        if (seq)
+                *seq = c.seq;
+        return c.trc;
+}
+
+#ifdef SEIS_SEGY_HAVE_LIBURING
+void ring_fill(SeisISegyAsync *as) {
+        size_t hdrs_size = seis_isegy_get_max_headers_size(as->sgy);
+        size_t smpls_size = seis_isegy_get_fixed_samples_size(as->sgy);
+        unsigned queued = 0;
+        for (unsigned i = 0; i < as->depth && as->reqs_num; ++i) {
+                struct slot *s = &as->slots[i];
+                if (s->busy)
+                        continue;
+                s->req = as->reqs[as->reqs_head++];
+                if (!--as->reqs_num)
+                        as->reqs_head = 0;
+                s->base = s->req.offset;
+                /* fixed length trace is read with single request */
+                s->want = hdrs_size + smpls_size;
+                s->got = 0;
+                s->hdrs_size = 0;
+                s->busy = true;
+                ring_prep(as, s);
+                ++queued;
+        }
+        if (queued)
+                io_uring_submit(&as->ring);
+}
+
+void ring_prep(SeisISegyAsync *as, struct slot *s) {
+        struct io_uring_sqe *sqe = io_uring_get_sqe(&as->ring);
+        io_uring_prep_read(sqe, seis_isegy_get_fd(as->sgy), s->buf + s->got,
+                           s->want - s->got, s->base + s->got);
+        io_uring_sqe_set_data(sqe, s);
+        ++as->in_flight;
+}
+
+/* returns true when slot is done with trace or error */
+bool ring_advance(SeisISegyAsync *as, struct slot *s, int res,
+                  struct completion *c) {
+        SeisISegy const *sgy = as->sgy;
+        c->seq = s->req.seq;
+        c->trc = NULL;
+        c->err.code = SEIS_SEGY_ERR_OK;
+        c->err.message = "";
+        if (res < 0) {
+                c->err.code = SEIS_SEGY_ERR_FILE_READ;
+                c->err.message = "asynchronous read error";
+                goto done;
+        }
+        s->got += res;
+        /* end of file is fine while reading headers of variable length
+         * trace, decoder checks there is enough of them */
+        bool eof = !res && !s->hdrs_size;
+        if (s->got < s->want && !eof) {
+                if (!res) {
+                        c->err.code = SEIS_SEGY_ERR_FILE_READ;
+                        c->err.message = "read less bytes than should";
+                        goto done;
+                }
+                ring_prep(as, s);
+                io_uring_submit(&as->ring);
+                return false;
+        }
+        char const *smpls = s->buf;
+        if (!s->hdrs_size) {
+                s->hdr = seis_trace_header_new();
+                if (!s->hdr) {
+                        c->err.code = SEIS_SEGY_ERR_NO_MEM;
+                        c->err.message = "can't get memory at trace reading";
+                        goto done;
+                }
+                TRY(seis_isegy_decode_trace_header(sgy, s->buf, s->got, s->hdr,
+                                                   &s->hdrs_size, &c->err));
+                if (!seis_isegy_get_fixed_samples_size(sgy)) {
+                        long long samp_num;
+                        TRY(seis_isegy_get_samples_num(sgy, s->hdr, &samp_num,
+                                                       &c->err));
+                        size_t want =
+                            samp_num * seis_isegy_get_bytes_per_sample(sgy);
+                        if (s->cap < want) {
+                                void *res = realloc(s->buf, want);
+                                if (!res) {
+                                        c->err.code = SEIS_SEGY_ERR_NO_MEM;
+                                        c->err.message =
+                                            "can't get memory at trace reading";
+                                        goto done;
+                                }
+                                s->buf = (char *)res;
+                                s->cap = want;
+                        }
+                        s->base = s->req.offset + s->hdrs_size;
+                        s->want = want;
+                        s->got = 0;
+                        ring_prep(as, s);
+                        io_uring_submit(&as->ring);
+                        return false;
+                }
+                smpls = s->buf + s->hdrs_size;
+        }
+        long long samp_num;
+        TRY(seis_isegy_get_samples_num(sgy, s->hdr, &samp_num, &c->err));
+        TRY(seis_isegy_decode_trace_samples(sgy, smpls, samp_num, s->hdr,
+                                            &c->trc, &c->err));
+        /* trace owns header now */
+        s->hdr = NULL;
+error:
+done:
+        seis_trace_header_unref(&s->hdr);
+        s->busy = false;
+        return true;
+}
+
+SeisTrace *ring_reap(SeisISegyAsync *as, size_t *seq) {
+        struct completion c;
+        while (1) {
+                ring_fill(as);
+                struct io_uring_cqe *cqe;
+                if (io_uring_wait_cqe(&as->ring, &cqe)) {
+                        as->err.code = SEIS_SEGY_ERR_FILE_READ;
+                        as->err.message = "io_uring wait error";
+                        return NULL;
+                }
+                struct slot *s = (struct slot *)io_uring_cqe_get_data(cqe);
+                int res = cqe->res;
+                io_uring_cqe_seen(&as->ring, cqe);
+                --as->in_flight;
+                if (ring_advance(as, s, res, &c))
+                        break;
+        }
+        ++as->reaped;
+        if (!c.trc)
+                as->err = c.err;
+        if (seq)
+                *seq = c.seq;
+        return c.trc;
+}
+#endif
@@ -0,0 +1,243 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "SeisISegyBatch.h"
+#include "SeisCommonSegy.h"
+#include "SeisISegy.h"
+#include "SeisISegyPrivate.h"
+#include "TRY.h"
+#include <SeisTrace.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* traces taken by thread at once, per thread. Few chunks per thread keep
+ * threads busy if traces take different time to decode. */
+#define CHUNKS_PER_THREAD 4
+
+struct SeisISegyBatch {
+        SeisISegy *sgy;
+        SeisSegyErr err;
+        char *buf;
+        size_t buf_size;
+        size_t rec_size;
+        /* current job, guarded by lock */
+        char const *data;
+        SeisTrace **traces;
+        size_t num, next, done, chunk;
+        pthread_mutex_t lock;
+        pthread_cond_t work_cond, done_cond;
+        pthread_t *workers;
+        unsigned workers_num;
+        bool stop;
+        int rc;
+};
+
+static void *worker(void *arg);
+static void run_chunks(SeisISegyBatch *b);
+static bool take_chunk(SeisISegyBatch *b, size_t *start, size_t *end);
+static void finish_chunk(SeisISegyBatch *b, size_t num,
+                         SeisSegyErr const *err);
+static SeisSegyErrCode decode_range(SeisISegyBatch *b, size_t start,
+                                    size_t end, SeisSegyErr *err);
+
+SeisISegyBatch *seis_isegy_batch_new(SeisISegy *sgy, unsigned threads_num) {
+        SeisISegyBatch *b = (SeisISegyBatch *)calloc(1, sizeof(*b));
+        if (!b)
+                return NULL;
+        pthread_mutex_init(&b->lock, NULL);
+        pthread_cond_init(&b->work_cond, NULL);
+        pthread_cond_init(&b->done_cond, NULL);
+        b->sgy = seis_isegy_ref(sgy);
+        b->err.code = SEIS_SEGY_ERR_OK;
+        b->err.message = "";
+        b->rec_size = seis_isegy_get_max_headers_size(sgy) +
+                      seis_isegy_get_fixed_samples_size(sgy);
+        b->rc = 1;
+        if (!threads_num) {
+                long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+                threads_num = cpus > 0 ? (unsigned)cpus : 1;
+        }
+        /* calling thread decodes too */
+        if (threads_num == 1)
+                return b;
+        b->workers =
+            (pthread_t *)malloc((threads_num - 1) * sizeof(pthread_t));
+        if (!b->workers)
+                goto error;
+        for (unsigned i = 0; i < threads_num - 1; ++i) {
+                if (pthread_create(&b->workers[i], NULL, worker, b))
+                        break;
+                ++b->workers_num;
+        }
+        return b;
+error:
+        seis_isegy_batch_unref(&b);
+        return NULL;
+}
+
+SeisISegyBatch *seis_isegy_batch_ref(SeisISegyBatch *batch) {
+        ++batch->rc;
+        return batch;
+}
+
+void seis_isegy_batch_unref(SeisISegyBatch **batch) {
+        if (*batch)
+                if (--(*batch)->rc == 0) {
+                        SeisISegyBatch *b = *batch;
+                        pthread_mutex_lock(&b->lock);
+                        b->stop = true;
+                        pthread_cond_broadcast(&b->work_cond);
+                        pthread_mutex_unlock(&b->lock);
+                        for (unsigned i = 0; i < b->workers_num; ++i)
+                                pthread_join(b->workers[i], NULL);
+                        free(b->workers);
+                        free(b->buf);
+                        pthread_cond_destroy(&b->done_cond);
+                        pthread_cond_destroy(&b->work_cond);
+                        pthread_mutex_destroy(&b->lock);
+                        seis_isegy_unref(&b->sgy);
+                        free(b);
+                        *batch = NULL;
+                }
+}
+
+SeisSegyErr const *seis_isegy_batch_get_error(SeisISegyBatch const *batch) {
+        return &batch->err;
+}
+
+unsigned seis_isegy_batch_get_threads_num(SeisISegyBatch const *batch) {
+        return batch->workers_num + 1;
+}
+
+SeisSegyErrCode seis_isegy_batch_read(SeisISegyBatch *batch, size_t first,
+                                      size_t num, SeisTrace **traces) {
+        batch->err.code = SEIS_SEGY_ERR_OK;
+        batch->err.message = "";
+        for (size_t i = 0; i < num; ++i)
+                traces[i] = NULL;
+        if (!seis_isegy_get_fixed_samples_size(batch->sgy)) {
+                batch->err.code = SEIS_SEGY_ERR_BAD_PARAMS;
+                batch->err.message = "batch reading needs fixed trace length";
+                goto error;
+        }
+        if (!num)
+                goto error;
+        /* whole batch is read with single request, mapped file needs no
+         * buffer */
+        size_t size = num * batch->rec_size;
+        if (!seis_isegy_is_mapped(batch->sgy) && batch->buf_size < size) {
+                void *res = realloc(batch->buf, size);
+                if (!res) {
+                        batch->err.code = SEIS_SEGY_ERR_NO_MEM;
+                        batch->err.message = "can't get memory for batch read";
+                        goto error;
+                }
+                batch->buf = (char *)res;
+                batch->buf_size = size;
+        }
+        char const *data;
+        TRY(seis_isegy_fetch_at(batch->sgy, batch->buf, size,
+                                seis_isegy_get_trace_offset(batch->sgy, first),
+                                &data, &batch->err));
+        size_t chunk = num / ((batch->workers_num + 1) * CHUNKS_PER_THREAD);
+        pthread_mutex_lock(&batch->lock);
+        batch->data = data;
+        batch->traces = traces;
+        batch->num = num;
+        batch->next = batch->done = 0;
+        batch->chunk = chunk ? chunk : 1;
+        pthread_cond_broadcast(&batch->work_cond);
+        pthread_mutex_unlock(&batch->lock);
+        run_chunks(batch);
+        pthread_mutex_lock(&batch->lock);
+        while (batch->done != batch->num)
+                pthread_cond_wait(&batch->done_cond, &batch->lock);
+        /* workers are idle until next job */
+        batch->num = batch->next = batch->done = 0;
+        pthread_mutex_unlock(&batch->lock);
+        if (batch->err.code)
+                for (size_t i = 0; i < num; ++i)
+                        seis_trace_unref(&traces[i]);
+error:
+        return batch->err.code;
+}
+
+void *worker(void *arg) {
+        SeisISegyBatch *b = (SeisISegyBatch *)arg;
+        while (1) {
+                pthread_mutex_lock(&b->lock);
+                while (!b->stop && b->next == b->num)
+                        pthread_cond_wait(&b->work_cond, &b->lock);
+                bool stop = b->stop;
+                pthread_mutex_unlock(&b->lock);
+                if (stop)
+                        break;
+                run_chunks(b);
+        }
+        return NULL;
+}
+
+/* decodes chunks of current job until none is left */
+void run_chunks(SeisISegyBatch *b) {
+        size_t start, end;
+        while (take_chunk(b, &start, &end)) {
+                SeisSegyErr err = {SEIS_SEGY_ERR_OK, ""};
+                decode_range(b, start, end, &err);
+                finish_chunk(b, end - start, &err);
+        }
+}
+
+bool take_chunk(SeisISegyBatch *b, size_t *start, size_t *end) {
+        pthread_mutex_lock(&b->lock);
+        bool taken = b->next != b->num;
+        if (taken) {
+                *start = b->next;
+                *end = b->num - b->next < b->chunk ? b->num
+                                                   : b->next + b->chunk;
+                b->next = *end;
+        }
+        pthread_mutex_unlock(&b->lock);
+        return taken;
+}
+
+/* first error wins. Other chunks are still finished, job is over when
+ * every trace is accounted */
+void finish_chunk(SeisISegyBatch *b, size_t num, SeisSegyErr const *err) {
+        pthread_mutex_lock(&b->lock);
+        if (err->code && !b->err.code)
+                b->err = *err;
+        b->done += num;
+        if (b->done == b->num)
+                pthread_cond_signal(&b->done_cond);
+        pthread_mutex_unlock(&b->lock);
+}
+
+/* job fields are not changed while any chunk is in progress, so they are
+ * read without lock */
+SeisSegyErrCode decode_range(SeisISegyBatch *b, size_t start, size_t end,
+                             SeisSegyErr *err) {
+        SeisTraceHeader *hdr = NULL;
+        for (size_t i = start; i < end; ++i) {
+                char const *rec = b->data + i * b->rec_size;
+                hdr = seis_trace_header_new();
+                if (!hdr) {
+                        err->code = SEIS_SEGY_ERR_NO_MEM;
+                        err->message = "can't get memory at trace reading";
+                        goto error;
+                }
+                size_t used;
+                long long samp_num;
+                TRY(seis_isegy_decode_trace_header(b->sgy, rec, b->rec_size,
+                                                   hdr, &used, err));
+                TRY(seis_isegy_get_samples_num(b->sgy, hdr, &samp_num, err));
+                TRY(seis_isegy_decode_trace_samples(
+                    b->sgy, rec + used, samp_num, hdr, &b->traces[i], err));
+                hdr = NULL;
+        }
+        return err->code;
+error:
+        seis_trace_header_unref(&hdr);
+        return err->code;
+}
@@ -0,0 +1,360 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "SeisISegyColumns.h"
+#include "SeisCommonSegy.h"
+#include "SeisISegy.h"
+#include "SeisISegyPrivate.h"
+#include "SeisSegyHdrSchema.h"
+#include "TRY.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* traces of variable trace length file array grows by at first */
+#define FIRST_CAPACITY 1024
+
+/* Fields of columns are found ahead for every number of header blocks
+ * trace could have, so trace costs one read and one accessor call per
+ * column. Extraction is read only while threads work. */
+struct Extraction {
+        SeisISegy const *sgy;
+        SeisSegyHdrSchema *schema;
+        SeisSegyHeaderColumn *columns;
+        size_t columns_num;
+        /* fields of columns for trace with i + 1 blocks start at
+         * i * columns_num */
+        SeisSegyHdrField const **fields;
+        /* samples number field for trace with i + 1 blocks */
+        SeisSegyHdrField const **samp_num;
+        size_t max_blocks;
+        size_t first, end;
+        /* record size of fixed trace length file, 0 otherwise */
+        size_t rec_size;
+        int bytes_per_sample;
+};
+
+/* range of traces read by one thread */
+struct Job {
+        struct Extraction const *ex;
+        size_t start, end;
+        SeisSegyErr err;
+        pthread_t thread;
+};
+
+static SeisSegyErrCode prepare(struct Extraction *ex, SeisSegyErr *err);
+static SeisSegyErrCode reserve(struct Extraction *ex, size_t num,
+                               SeisSegyErr *err);
+static SeisSegyErrCode fetch_headers(struct Extraction const *ex, char *buf,
+                                     size_t pos, char const **hdrs,
+                                     size_t *blocks, SeisSegyErr *err);
+static void put_values(struct Extraction const *ex, char const *hdrs,
+                       size_t blocks, size_t idx);
+static SeisSegyErrCode read_fixed(struct Extraction *ex, unsigned threads_num,
+                                  size_t *traces_num, SeisSegyErr *err);
+static SeisSegyErrCode read_variable(struct Extraction *ex,
+                                     size_t *traces_num, SeisSegyErr *err);
+static void *run_job(void *arg);
+static void free_columns(SeisSegyHeaderColumn *columns, size_t columns_num);
+
+SeisSegyErrCode seis_isegy_extract_header_columns(SeisISegy const *sgy,
+                                                  SeisSegyHeaderColumn *columns,
+                                                  size_t columns_num,
+                                                  unsigned threads_num,
+                                                  size_t *traces_num,
+                                                  SeisSegyErr *err) {
+        struct Extraction ex = {.sgy = sgy,
+                                .columns = columns,
+                                .columns_num = columns_num};
+        err->code = SEIS_SEGY_ERR_OK;
+        err->message = "";
+        *traces_num = 0;
+        for (size_t i = 0; i < columns_num; ++i) {
+                columns[i].ints = NULL;
+                columns[i].reals = NULL;
+        }
+        if (!seis_isegy_get_traces_range(sgy, &ex.first, &ex.end)) {
+                err->code = SEIS_SEGY_ERR_FILE_READ;
+                err->message = "positional reading needs seekable input";
+                goto error;
+        }
+        /* remap compiles new schema, this one stays while we read */
+        ex.schema = seis_segy_hdr_schema_ref(seis_isegy_get_hdr_schema(sgy));
+        TRY(prepare(&ex, err));
+        if (ex.rec_size)
+                TRY(read_fixed(&ex, threads_num, traces_num, err));
+        else
+                TRY(read_variable(&ex, traces_num, err));
+error:
+        if (err->code) {
+                free_columns(columns, columns_num);
+                *traces_num = 0;
+        }
+        seis_segy_hdr_schema_unref(&ex.schema);
+        free(ex.fields);
+        free(ex.samp_num);
+        return err->code;
+}
+
+SeisSegyErrCode prepare(struct Extraction *ex, SeisSegyErr *err) {
+        SeisSegyHdrSchema const *s = ex->schema;
+        size_t hdrs_size = seis_isegy_get_max_headers_size(ex->sgy);
+        size_t samples_size = seis_isegy_get_fixed_samples_size(ex->sgy);
+        ex->max_blocks = hdrs_size / SEIS_SEGY_TRACE_HEADER_SIZE;
+        ex->rec_size = samples_size ? hdrs_size + samples_size : 0;
+        ex->bytes_per_sample = seis_isegy_get_bytes_per_sample(ex->sgy);
+        ex->fields = (SeisSegyHdrField const **)malloc(
+            ex->max_blocks * (ex->columns_num ? ex->columns_num : 1) *
+            sizeof(SeisSegyHdrField const *));
+        ex->samp_num = (SeisSegyHdrField const **)malloc(
+            ex->max_blocks * sizeof(SeisSegyHdrField const *));
+        if (!ex->fields || !ex->samp_num) {
+                err->code = SEIS_SEGY_ERR_NO_MEM;
+                err->message = "can't get memory for header columns";
+                goto error;
+        }
+        for (size_t j = 0; j < ex->columns_num; ++j) {
+                SeisSegyHeaderColumn *col = ex->columns + j;
+                int slot = seis_segy_hdr_schema_slot(s, col->name);
+                /* type is taken from whole map, file could have less
+                 * blocks than map describes */
+                SeisSegyHdrField const *f =
+                    slot < 0 ? NULL
+                             : seis_segy_hdr_schema_find_last(
+                                   s, s->blocks_num, slot);
+                if (!f) {
+                        err->code = SEIS_SEGY_ERR_BAD_PARAMS;
+                        err->message = "unknown trace header field";
+                        goto error;
+                }
+                col->is_real = !f->get_int;
+                for (size_t b = 0; b < ex->max_blocks; ++b)
+                        ex->fields[b * ex->columns_num + j] =
+                            seis_segy_hdr_schema_find_last(s, b + 1, slot);
+        }
+        for (size_t b = 0; b < ex->max_blocks; ++b)
+                ex->samp_num[b] =
+                    s->samp_num_slot < 0
+                        ? NULL
+                        : seis_segy_hdr_schema_find_last(s, b + 1,
+                                                         s->samp_num_slot);
+error:
+        return err->code;
+}
+
+SeisSegyErrCode reserve(struct Extraction *ex, size_t num, SeisSegyErr *err) {
+        /* zero traces still get arrays */
+        size_t n = num ? num : 1;
+        for (size_t j = 0; j < ex->columns_num; ++j) {
+                SeisSegyHeaderColumn *col = ex->columns + j;
+                if (col->is_real) {
+                        double *tmp =
+                            (double *)realloc(col->reals, n * sizeof(double));
+                        if (!tmp)
+                                goto no_mem;
+                        col->reals = tmp;
+                } else {
+                        long long *tmp = (long long *)realloc(
+                            col->ints, n * sizeof(long long));
+                        if (!tmp)
+                                goto no_mem;
+                        col->ints = tmp;
+                }
+        }
+        return err->code;
+no_mem:
+        err->code = SEIS_SEGY_ERR_NO_MEM;
+        err->message = "can't get memory for header columns";
+        return err->code;
+}
+
+/* fetches main and additional headers of record at pos. hdrs points to buf
+ * or to file mapping. */
+SeisSegyErrCode fetch_headers(struct Extraction const *ex, char *buf,
+                              size_t pos, char const **hdrs, size_t *blocks,
+                              SeisSegyErr *err) {
+        size_t const size = SEIS_SEGY_TRACE_HEADER_SIZE;
+        size_t num = ex->max_blocks * size;
+        /* last record of variable trace length file could be shorter */
+        if (pos + num > ex->end)
+                num = ex->end - pos;
+        if (num < (ex->max_blocks > 1 ? 2 : 1) * size)
+                goto short_read;
+        TRY(seis_isegy_fetch_at(ex->sgy, buf, num, pos, hdrs, err));
+        *blocks = 1;
+        if (ex->max_blocks > 1) {
+                long long add_num = 0;
+                seis_segy_hdr_schema_get_int(ex->schema, 1, *hdrs + size,
+                                             ex->schema->add_hdr_num_slot,
+                                             &add_num);
+                if (add_num < 0 || (size_t)add_num >= ex->max_blocks) {
+                        err->code = SEIS_SEGY_ERR_BROKEN_FILE;
+                        err->message =
+                            "wrong number of additional trace headers";
+                        goto error;
+                }
+                *blocks = add_num ? 1 + (size_t)add_num : ex->max_blocks;
+                if (*blocks * size > num)
+                        goto short_read;
+        }
+        return err->code;
+short_read:
+        err->code = SEIS_SEGY_ERR_FILE_READ;
+        err->message = "read less bytes than should";
+error:
+        return err->code;
+}
+
+/* last field wins as in decoded trace header, missing ones are zeros */
+void put_values(struct Extraction const *ex, char const *hdrs, size_t blocks,
+                size_t idx) {
+        SeisSegyHdrField const *const *fields =
+            ex->fields + (blocks - 1) * ex->columns_num;
+        for (size_t j = 0; j < ex->columns_num; ++j) {
+                SeisSegyHeaderColumn *col = ex->columns + j;
+                SeisSegyHdrField const *f = fields[j];
+                char const *ptr =
+                    f ? hdrs + f->block * SEIS_SEGY_TRACE_HEADER_SIZE +
+                            f->offset
+                      : NULL;
+                if (col->is_real)
+                        col->reals[idx] =
+                            f && f->get_real ? f->get_real(ptr) : 0.0;
+                else
+                        col->ints[idx] = f && f->get_int ? f->get_int(ptr) : 0;
+        }
+}
+
+SeisSegyErrCode read_fixed(struct Extraction *ex, unsigned threads_num,
+                           size_t *traces_num, SeisSegyErr *err) {
+        struct Job *jobs = NULL;
+        bool *started = NULL;
+        size_t num = (ex->end - ex->first) / ex->rec_size;
+        TRY(reserve(ex, num, err));
+        if (!threads_num) {
+                long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+                threads_num = cpus > 0 ? (unsigned)cpus : 1;
+        }
+        if (threads_num > num)
+                threads_num = num ? (unsigned)num : 1;
+        jobs = (struct Job *)malloc(threads_num * sizeof(struct Job));
+        started = (bool *)calloc(threads_num, sizeof(bool));
+        if (!jobs || !started) {
+                err->code = SEIS_SEGY_ERR_NO_MEM;
+                err->message = "can't get memory for header columns";
+                goto error;
+        }
+        for (unsigned i = 0; i < threads_num; ++i) {
+                jobs[i].ex = ex;
+                jobs[i].start = num * i / threads_num;
+                jobs[i].end = num * (i + 1) / threads_num;
+                jobs[i].err.code = SEIS_SEGY_ERR_OK;
+                jobs[i].err.message = "";
+        }
+        /* calling thread reads first range, failed thread start is made up
+         * by calling thread too */
+        for (unsigned i = 1; i < threads_num; ++i)
+                started[i] =
+                    !pthread_create(&jobs[i].thread, NULL, run_job, jobs + i);
+        for (unsigned i = 0; i < threads_num; ++i)
+                if (!started[i])
+                        run_job(jobs + i);
+        for (unsigned i = 1; i < threads_num; ++i)
+                if (started[i])
+                        pthread_join(jobs[i].thread, NULL);
+        /* first failed range wins */
+        for (unsigned i = 0; i < threads_num; ++i)
+                if (jobs[i].err.code) {
+                        *err = jobs[i].err;
+                        goto error;
+                }
+        *traces_num = num;
+error:
+        free(started);
+        free(jobs);
+        return err->code;
+}
+
+void *run_job(void *arg) {
+        struct Job *job = (struct Job *)arg;
+        struct Extraction const *ex = job->ex;
+        char const *hdrs;
+        size_t blocks;
+        char *buf = NULL;
+        if (!seis_isegy_is_mapped(ex->sgy)) {
+                buf = (char *)malloc(ex->max_blocks *
+                                     SEIS_SEGY_TRACE_HEADER_SIZE);
+                if (!buf) {
+                        job->err.code = SEIS_SEGY_ERR_NO_MEM;
+                        job->err.message =
+                            "can't get memory for header columns";
+                        goto error;
+                }
+        }
+        for (size_t i = job->start; i < job->end; ++i) {
+                size_t pos = ex->first + i * ex->rec_size;
+                if (fetch_headers(ex, buf, pos, &hdrs, &blocks, &job->err))
+                        goto error;
+                put_values(ex, hdrs, blocks, i);
+        }
+error:
+        free(buf);
+        return NULL;
+}
+
+/* every record tells where next one starts, so traces are walked one by
+ * one */
+SeisSegyErrCode read_variable(struct Extraction *ex, size_t *traces_num,
+                              SeisSegyErr *err) {
+        char const *hdrs;
+        size_t blocks, num = 0, capacity = 0, pos = ex->first;
+        char *buf = NULL;
+        if (!seis_isegy_is_mapped(ex->sgy)) {
+                buf = (char *)malloc(ex->max_blocks *
+                                     SEIS_SEGY_TRACE_HEADER_SIZE);
+                if (!buf) {
+                        err->code = SEIS_SEGY_ERR_NO_MEM;
+                        err->message = "can't get memory for header columns";
+                        goto error;
+                }
+        }
+        TRY(reserve(ex, 0, err));
+        while (pos < ex->end) {
+                if (num == capacity) {
+                        capacity = capacity ? 2 * capacity : FIRST_CAPACITY;
+                        TRY(reserve(ex, capacity, err));
+                }
+                TRY(fetch_headers(ex, buf, pos, &hdrs, &blocks, err));
+                put_values(ex, hdrs, blocks, num);
+                SeisSegyHdrField const *f = ex->samp_num[blocks - 1];
+                long long samp_num =
+                    f && f->get_int
+                        ? f->get_int(hdrs + f->block *
+                                                SEIS_SEGY_TRACE_HEADER_SIZE +
+                                     f->offset)
+                        : 0;
+                if (samp_num <= 0) {
+                        err->code = SEIS_SEGY_ERR_BROKEN_FILE;
+                        err->message =
+                            "variable trace length and zero samples number";
+                        goto error;
+                }
+                pos += blocks * SEIS_SEGY_TRACE_HEADER_SIZE +
+                       samp_num * ex->bytes_per_sample;
+                ++num;
+        }
+        *traces_num = num;
+error:
+        free(buf);
+        return err->code;
+}
+
+void free_columns(SeisSegyHeaderColumn *columns, size_t columns_num) {
+        for (size_t i = 0; i < columns_num; ++i) {
+                free(columns[i].ints);
+                free(columns[i].reals);
+                columns[i].ints = NULL;
+                columns[i].reals = NULL;
+        }
+}
@@ -0,0 +1,60 @@
+#ifndef SEIS_ISEGY_PRIVATE
+#define SEIS_ISEGY_PRIVATE
+
+#include "SeisISegy.h"
+#include "SeisSegyHdrSchema.h"
+#include <SeisTrace.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Parts of reader shared with other reading modules. All of them are
+ * stateless and could be called from any thread. */
+
+/* file descriptor for positional reads or -1 if there is none or data is
+ * served from memory */
+int seis_isegy_get_fd(SeisISegy const *sgy);
+
+/* positional reads return pointers to memory and need no buffer */
+bool seis_isegy_is_mapped(SeisISegy const *sgy);
+
+/* reads num bytes at offset. res points to buf or to file mapping */
+SeisSegyErrCode seis_isegy_fetch_at(SeisISegy const *sgy, char *buf,
+                                    size_t num, size_t offset,
+                                    char const **res, SeisSegyErr *err);
+
+/* asks kernel to start reading range in background */
+void seis_isegy_will_need(SeisISegy const *sgy, size_t offset, size_t num);
+
+int seis_isegy_get_bytes_per_sample(SeisISegy const *sgy);
+
+/* size of main and all additional trace headers */
+size_t seis_isegy_get_max_headers_size(SeisISegy const *sgy);
+
+/* size of samples block for fixed trace length files, 0 otherwise */
+size_t seis_isegy_get_fixed_samples_size(SeisISegy const *sgy);
+
+/* file offsets of first trace record and of end of records. Returns false
+ * if end is unknown as for streaming input. */
+bool seis_isegy_get_traces_range(SeisISegy const *sgy, size_t *first,
+                                 size_t *end);
+
+/* trace header layout reader decodes with */
+SeisSegyHdrSchema *seis_isegy_get_hdr_schema(SeisISegy const *sgy);
+
+SeisSegyErrCode seis_isegy_get_samples_num(SeisISegy const *sgy,
+                                           SeisTraceHeader const *hdr,
+                                           long long *num, SeisSegyErr *err);
+
+SeisSegyErrCode seis_isegy_decode_trace_header(SeisISegy const *sgy,
+                                               char const *buf, size_t size,
+                                               SeisTraceHeader *hdr,
+                                               size_t *used, SeisSegyErr *err);
+
+SeisSegyErrCode seis_isegy_decode_trace_samples(SeisISegy const *sgy,
+                                                char const *buf,
+                                                long long samp_num,
+                                                SeisTraceHeader *hdr,
+                                                SeisTrace **trc,
+                                                SeisSegyErr *err);
+
+#endif /* SEIS_ISEGY_PRIVATE */
@@ -0,0 +1,215 @@
+#include "SeisISegyReadPlan.h"
+#include "SeisCommonSegy.h"
+#include "SeisISegy.h"
+#include "SeisISegyPrivate.h"
+#include "TRY.h"
+#include <SeisTrace.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+/* bounds memory taken by single merged read */
+#define MAX_RANGE_SIZE (16 * 1024 * 1024)
+
+struct entry {
+        size_t offset;
+        size_t order;
+};
+
+struct range {
+        size_t start, size;
+        size_t left;
+        char *buf;
+        char const *data;
+};
+
+struct SeisISegyReadPlan {
+        SeisISegy *sgy;
+        SeisSegyErr err;
+        struct range *ranges;
+        size_t ranges_num;
+        size_t *range_of;
+        size_t *offsets;
+        size_t num, pos;
+        size_t rec_size;
+        int rc;
+};
+
+static int cmp_entries(void const *a, void const *b);
+static SeisSegyErrCode build_ranges(SeisISegyReadPlan *plan,
+                                    struct entry *entries, size_t max_gap);
+
+SeisISegyReadPlan *seis_isegy_read_plan_new(SeisISegy *sgy,
+                                            size_t const *indices, size_t num,
+                                            size_t max_gap) {
+        struct entry *entries = NULL;
+        SeisISegyReadPlan *plan =
+            (SeisISegyReadPlan *)calloc(1, sizeof(SeisISegyReadPlan));
+        if (!plan)
+                return NULL;
+        plan->sgy = seis_isegy_ref(sgy);
+        plan->err.code = SEIS_SEGY_ERR_OK;
+        plan->err.message = "";
+        plan->num = num;
+        plan->rc = 1;
+        if (!seis_isegy_get_fixed_samples_size(sgy)) {
+                plan->err.code = SEIS_SEGY_ERR_BAD_PARAMS;
+                plan->err.message = "read plan needs fixed trace length";
+                plan->num = 0;
+                return plan;
+        }
+        plan->rec_size = seis_isegy_get_max_headers_size(sgy) +
+                         seis_isegy_get_fixed_samples_size(sgy);
+        if (!num)
+                return plan;
+        entries = (struct entry *)malloc(num * sizeof(struct entry));
+        plan->range_of = (size_t *)malloc(num * sizeof(size_t));
+        plan->offsets = (size_t *)malloc(num * sizeof(size_t));
+        if (!entries || !plan->range_of || !plan->offsets)
+                goto error;
+        for (size_t i = 0; i < num; ++i) {
+                entries[i].offset =
+                    seis_isegy_get_trace_offset(sgy, indices[i]);
+                entries[i].order = i;
+                plan->offsets[i] = entries[i].offset;
+        }
+        qsort(entries, num, sizeof(struct entry), cmp_entries);
+        if (build_ranges(plan, entries, max_gap))
+                goto error;
+        for (size_t i = 0; i < plan->ranges_num; ++i)
+                seis_isegy_will_need(sgy, plan->ranges[i].start,
+                                     plan->ranges[i].size);
+        free(entries);
+        return plan;
+error:
+        free(entries);
+        seis_isegy_read_plan_unref(&plan);
+        return NULL;
+}
+
+SeisISegyReadPlan *seis_isegy_read_plan_ref(SeisISegyReadPlan *plan) {
+        ++plan->rc;
+        return plan;
+}
+
+void seis_isegy_read_plan_unref(SeisISegyReadPlan **plan) {
+        if (*plan)
+                if (--(*plan)->rc == 0) {
+                        for (size_t i = 0; i < (*plan)->ranges_num; ++i)
+                                free((*plan)->ranges[i].buf);
+                        free((*plan)->ranges);
+                        free((*plan)->range_of);
+                        free((*plan)->offsets);
+                        seis_isegy_unref(&(*plan)->sgy);
+                        free(*plan);
+                        *plan = NULL;
+                }
+}
+
+SeisSegyErr const *
+seis_isegy_read_plan_get_error(SeisISegyReadPlan const *plan) {
+        return &plan->err;
+}
+
+size_t seis_isegy_read_plan_get_ranges_num(SeisISegyReadPlan const *plan) {
+        return plan->ranges_num;
+}
+
+bool seis_isegy_read_plan_end(SeisISegyReadPlan const *plan) {
+        return plan->pos == plan->num;
+}
+
+SeisTrace *seis_isegy_read_plan_next(SeisISegyReadPlan *plan) {
+        SeisTraceHeader *hdr = NULL;
+        SeisTrace *trc = NULL;
+        if (plan->err.code || plan->pos == plan->num)
+                return NULL;
+        struct range *r = &plan->ranges[plan->range_of[plan->pos]];
+        if (!r->data) {
+                /* mapped file needs no buffer */
+                if (!seis_isegy_is_mapped(plan->sgy)) {
+                        r->buf = (char *)malloc(r->size);
+                        if (!r->buf) {
+                                plan->err.code = SEIS_SEGY_ERR_NO_MEM;
+                                plan->err.message =
+                                    "can't get memory for merged read";
+                                goto error;
+                        }
+                }
+                TRY(seis_isegy_fetch_at(plan->sgy, r->buf, r->size, r->start,
+                                        &r->data, &plan->err));
+        }
+        char const *rec = r->data + (plan->offsets[plan->pos] - r->start);
+        hdr = seis_trace_header_new();
+        if (!hdr) {
+                plan->err.code = SEIS_SEGY_ERR_NO_MEM;
+                plan->err.message = "can't get memory at trace reading";
+                goto error;
+        }
+        size_t used;
+        long long samp_num;
+        TRY(seis_isegy_decode_trace_header(plan->sgy, rec, plan->rec_size, hdr,
+                                           &used, &plan->err));
+        TRY(seis_isegy_get_samples_num(plan->sgy, hdr, &samp_num, &plan->err));
+        TRY(seis_isegy_decode_trace_samples(plan->sgy, rec + used, samp_num,
+                                            hdr, &trc, &plan->err));
+        ++plan->pos;
+        /* range memory is released as soon as its last trace is read */
+        if (!--r->left) {
+                free(r->buf);
+                r->buf = NULL;
+                r->data = NULL;
+        }
+        return trc;
+error:
+        if (!trc)
+                seis_trace_header_unref(&hdr);
+        seis_trace_unref(&trc);
+        return NULL;
+}
+
+int cmp_entries(void const *a, void const *b) {
+        struct entry const *l = (struct entry const *)a;
+        struct entry const *r = (struct entry const *)b;
+        if (l->offset != r->offset)
+                return l->offset < r->offset ? -1 : 1;
+        return l->order < r->order ? -1 : l->order > r->order;
+}
+
+SeisSegyErrCode build_ranges(SeisISegyReadPlan *plan, struct entry *entries,
+                             size_t max_gap) {
+        size_t cap = 0;
+        struct range *r = NULL;
+        for (size_t i = 0; i < plan->num; ++i) {
+                size_t start = entries[i].offset;
+                size_t end = start + plan->rec_size;
+                /* merge with previous range if gap is small enough */
+                if (r && start <= r->start + r->size + max_gap &&
+                    end - r->start <= MAX_RANGE_SIZE) {
+                        if (end > r->start + r->size)
+                                r->size = end - r->start;
+                } else {
+                        if (plan->ranges_num == cap) {
+                                cap = cap ? cap * 2 : 16;
+                                void *res = realloc(
+                                    plan->ranges, cap * sizeof(struct range));
+                                if (!res)
+                                        goto error;
+                                plan->ranges = (struct range *)res;
+                        }
+                        r = &plan->ranges[plan->ranges_num++];
+                        r->start = start;
+                        r->size = plan->rec_size;
+                        r->left = 0;
+                        r->buf = NULL;
+                        r->data = NULL;
+                }
+                ++r->left;
+                plan->range_of[entries[i].order] = plan->ranges_num - 1;
+        }
+        return plan->err.code;
+error:
+        plan->err.code = SEIS_SEGY_ERR_NO_MEM;
+        plan->err.message = "can't get memory for read plan";
+        return plan->err.code;
+}
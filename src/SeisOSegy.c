@@ -3,6 +3,11 @@
 #include "SeisCommonSegyPrivate.h"
 #include "SeisEncodings.h"
 #include "SeisOSU.h"
+#include "SeisSegyBackend.h"
+#include "SeisSegyBytes.h"
+#include "SeisSegyConvert.h"
+#include "SeisSegyFloatTrace.h"
+#include "SeisSegyHdrSchema.h"
 #include "TRY.h"
 #include "m-string.h"
 #include <SeisTrace.h>
@@ -18,43 +23,47 @@
 #define UNUSED(x) (void)(x)
 
 static SeisSegyErrCode assign_raw_writers(SeisOSegy *sgy);
-static SeisSegyErrCode assign_sample_writer(SeisOSegy *sgy);
+static SeisSegyErrCode assign_sample_encoders(SeisOSegy *sgy);
 static SeisSegyErrCode assign_bytes_per_sample(SeisOSegy *sgy);
 static SeisSegyErrCode write_text_header(SeisOSegy *sgy);
 static SeisSegyErrCode write_bin_header(SeisOSegy *sgy);
 static SeisSegyErrCode write_ext_text_headers(SeisOSegy *sgy);
 static SeisSegyErrCode write_trailer_stanzas(SeisOSegy *sgy);
 static SeisSegyErrCode write_trace_header(SeisOSegy *sgy, SeisTraceHeader *hdr);
-static SeisSegyErrCode write_trace_samples_fix(SeisOSegy *sgy,
-                                               SeisTrace const *t);
-static SeisSegyErrCode write_trace_samples_var(SeisOSegy *sgy,
-                                               SeisTrace const *t);
-static void fill_buf_with_fmt_arr(SeisOSegy *sgy, single_hdr_fmt_t *arr,
-                                  SeisTraceHeader *hdr);
+static SeisSegyErrCode write_std_header(SeisOSegy *sgy,
+                                        SeisSegyStdHeader const *hdr);
+static bool is_big_endian(SeisOSegy const *sgy);
+static SeisSegyErrCode fit_samp_buf_fix(SeisOSegy *sgy, long long samp_num);
+static SeisSegyErrCode fit_samp_buf_var(SeisOSegy *sgy, long long samp_num);
+static SeisSegyErrCode write_trace_samples(SeisOSegy *sgy,
+                                           double const *samples,
+                                           long long samp_num);
+static SeisSegyErrCode write_trace_samples_float(SeisOSegy *sgy,
+                                                 float const *samples,
+                                                 long long samp_num);
 static SeisSegyErrCode write_to_file(SeisOSegy *sgy, char const *buf,
                                      size_t num);
+static SeisSegyErrCode open_file(SeisOSegy *sgy, char const *file_name);
+static SeisSegyErrCode prepare_segy(SeisOSegy *sgy);
+static SeisSegyErrCode prepare_su(SeisOSegy *sgy);
 
 struct SeisOSegy {
         SeisCommonSegy *com;
         void (*write_u8)(char **buf, uint8_t);
-        void (*write_i8)(char **buf, int8_t);
         void (*write_u16)(char **buf, uint16_t);
         void (*write_i16)(char **buf, int16_t);
-        void (*write_u24)(char **buf, uint32_t);
-        void (*write_i24)(char **buf, int32_t);
         void (*write_u32)(char **buf, uint32_t);
         void (*write_i32)(char **buf, int32_t);
         void (*write_u64)(char **buf, uint64_t);
         void (*write_i64)(char **buf, int64_t);
-        void (*write_sample)(SeisOSegy *sgy, char **buf, double);
-        void (*write_ibm_float)(SeisOSegy *sgy, char **buf, double);
-        void (*write_IEEE_float)(SeisOSegy *sgy, char **buf, double);
+        SeisSegyEncodeFunc encode;
+        SeisSegyEncodeFloatFunc encode_f;
         void (*write_IEEE_double)(SeisOSegy *sgy, char **buf, double);
         SeisSegyErrCode (*write_add_trc_hdrs)(SeisOSegy *sgy,
                                               SeisTraceHeader const *hdr);
-        SeisSegyErrCode (*write_trace_samples)(SeisOSegy *sgy,
-                                               SeisTrace const *t);
+        SeisSegyErrCode (*fit_samp_buf)(SeisOSegy *sgy, long long samp_num);
         SeisSegyErrCode (*write_trace)(SeisOSegy *sgy, SeisTrace const *trc);
+        size_t curr_pos;
         int update_bin_header;
         int rc;
 };
@@ -64,45 +73,28 @@ struct SeisOSU {
         int rc;
 };
 
-static void write_i8(char **buf, int8_t val);
 static void write_u8(char **buf, uint8_t val);
 static void write_i16(char **buf, int16_t val);
 static void write_u16(char **buf, uint16_t val);
-static void write_i24(char **buf, int32_t val);
-static void write_u24(char **buf, uint32_t val);
 static void write_i32(char **buf, int32_t val);
 static void write_u32(char **buf, uint32_t val);
 static void write_i64(char **buf, int64_t val);
 static void write_u64(char **buf, uint64_t val);
 static void write_i16_sw(char **buf, int16_t val);
 static void write_u16_sw(char **buf, uint16_t val);
-static void write_i24_sw(char **buf, int32_t val);
-static void write_u24_sw(char **buf, uint32_t val);
 static void write_i32_sw(char **buf, int32_t val);
 static void write_u32_sw(char **buf, uint32_t val);
 static void write_i64_sw(char **buf, int64_t val);
 static void write_u64_sw(char **buf, uint64_t val);
-static void write_IBM_float(SeisOSegy *sgy, char **buf, double val);
-static void write_IEEE_float(SeisOSegy *sgy, char **buf, double val);
 static void write_IEEE_double(SeisOSegy *sgy, char **buf, double val);
-static void write_IEEE_float_native(SeisOSegy *sgy, char **buf, double val);
 static void write_IEEE_double_native(SeisOSegy *sgy, char **buf, double val);
-static void dbl_to_i8(SeisOSegy *sgy, char **buf, double val);
-static void dbl_to_u8(SeisOSegy *sgy, char **buf, double val);
-static void dbl_to_i16(SeisOSegy *sgy, char **buf, double val);
-static void dbl_to_u16(SeisOSegy *sgy, char **buf, double val);
-static void dbl_to_i24(SeisOSegy *sgy, char **buf, double val);
-static void dbl_to_u24(SeisOSegy *sgy, char **buf, double val);
-static void dbl_to_i32(SeisOSegy *sgy, char **buf, double val);
-static void dbl_to_u32(SeisOSegy *sgy, char **buf, double val);
-static void dbl_to_i64(SeisOSegy *sgy, char **buf, double val);
-static void dbl_to_u64(SeisOSegy *sgy, char **buf, double val);
 
 SeisOSegy *seis_osegy_new(void) {
         SeisOSegy *sgy = (SeisOSegy *)malloc(sizeof(struct SeisOSegy));
         if (!sgy)
                 goto error;
         sgy->com = seis_common_segy_new();
+        sgy->curr_pos = 0;
         sgy->rc = 1;
         return sgy;
 error:
@@ -127,9 +119,8 @@ void seis_osegy_unref(SeisOSegy **sgy) {
                                         com->bin_hdr.samp_per_tr =
                                             com->bin_hdr.ext_samp_per_tr =
                                                 com->samp_per_tr;
-                                        fseek(com->file,
-                                              SEIS_SEGY_TEXT_HEADER_SIZE,
-                                              SEEK_SET);
+                                        (*sgy)->curr_pos =
+                                            SEIS_SEGY_TEXT_HEADER_SIZE;
                                         write_bin_header(*sgy);
                                 }
                         }
@@ -155,18 +146,28 @@ void seis_osegy_set_binary_header(SeisOSegy *sgy, SeisSegyBinHdr const *bh) {
 
 SeisSegyErrCode seis_osegy_open(SeisOSegy *sgy, char const *file_name) {
         SeisCommonSegy *com = sgy->com;
-        com->file = fopen(file_name, "wb");
-        if (!com->file) {
-                com->err.code = SEIS_SEGY_ERR_FILE_OPEN;
-                com->err.message = "can't open file for writing";
-                goto error;
-        }
+        TRY(open_file(sgy, file_name));
+        TRY(prepare_segy(sgy));
+error:
+        return com->err.code;
+}
+
+SeisSegyErrCode seis_osegy_open_backend(SeisOSegy *sgy,
+                                        SeisSegyBackend *backend) {
+        SeisCommonSegy *com = sgy->com;
+        assert(!com->backend);
+        com->backend = seis_segy_backend_ref(backend);
+        return prepare_segy(sgy);
+}
+
+SeisSegyErrCode prepare_segy(SeisOSegy *sgy) {
+        SeisCommonSegy *com = sgy->com;
         if (!com->bin_hdr.format_code)
                 com->bin_hdr.format_code = 1;
         TRY(write_text_header(sgy));
         TRY(assign_raw_writers(sgy));
         TRY(assign_bytes_per_sample(sgy));
-        TRY(assign_sample_writer(sgy));
+        TRY(assign_sample_encoders(sgy));
         TRY(write_bin_header(sgy));
         com->samp_per_tr = com->bin_hdr.ext_samp_per_tr
                                ? com->bin_hdr.ext_samp_per_tr
@@ -182,10 +183,10 @@ SeisSegyErrCode seis_osegy_open(SeisOSegy *sgy, char const *file_name) {
         if ((com->bin_hdr.fixed_tr_length ||
              !com->bin_hdr.SEGY_rev_major_ver) &&
             com->samp_per_tr) {
-                sgy->write_trace_samples = write_trace_samples_fix;
+                sgy->fit_samp_buf = fit_samp_buf_fix;
                 sgy->update_bin_header = 0;
         } else {
-                sgy->write_trace_samples = write_trace_samples_var;
+                sgy->fit_samp_buf = fit_samp_buf_var;
                 sgy->update_bin_header = 1;
         }
         if (com->bin_hdr.SEGY_rev_major_ver)
@@ -232,7 +233,30 @@ void seis_osegy_add_ext_text_header(SeisOSegy *sgy, char const *hdr) {
 SeisSegyErrCode seis_osegy_write_trace(SeisOSegy *sgy, SeisTrace *trc) {
         SeisSegyErr const *err = seis_osegy_get_error(sgy);
         TRY(write_trace_header(sgy, seis_trace_get_header(trc)));
-        return sgy->write_trace_samples(sgy, trc);
+        return write_trace_samples(sgy, seis_trace_get_samples_const(trc),
+                                   seis_trace_get_samples_num(trc));
+error:
+        return err->code;
+}
+
+SeisSegyErrCode seis_osegy_write_trace_float(SeisOSegy *sgy,
+                                             SeisSegyFloatTrace *trc) {
+        SeisSegyErr const *err = seis_osegy_get_error(sgy);
+        TRY(write_trace_header(sgy, seis_segy_float_trace_get_header(trc)));
+        return write_trace_samples_float(
+            sgy, seis_segy_float_trace_get_samples_const(trc),
+            seis_segy_float_trace_get_samples_num(trc));
+error:
+        return err->code;
+}
+
+SeisSegyErrCode seis_osegy_write_trace_std(SeisOSegy *sgy,
+                                           SeisSegyStdHeader const *hdr,
+                                           double const *samples,
+                                           long long samp_num) {
+        SeisSegyErr const *err = seis_osegy_get_error(sgy);
+        TRY(write_std_header(sgy, hdr));
+        return write_trace_samples(sgy, samples, samp_num);
 error:
         return err->code;
 }
@@ -273,56 +297,88 @@ SeisSegyErrCode seis_osu_remap_trace_header(SeisOSU *su, char const *hdr_name,
 }
 
 SeisSegyErrCode seis_osu_open(SeisOSU *su, char const *file_name) {
-        SeisOSegy *sgy = su->sgy;
+        SeisCommonSegy *com = su->sgy->com;
+        TRY(open_file(su->sgy, file_name));
+        TRY(prepare_su(su->sgy));
+error:
+        return com->err.code;
+}
+
+SeisSegyErrCode seis_osu_open_backend(SeisOSU *su, SeisSegyBackend *backend) {
+        SeisCommonSegy *com = su->sgy->com;
+        assert(!com->backend);
+        com->backend = seis_segy_backend_ref(backend);
+        return prepare_su(su->sgy);
+}
+
+SeisSegyErrCode prepare_su(SeisOSegy *sgy) {
         SeisCommonSegy *com = sgy->com;
-        com->file = fopen(file_name, "wb");
-        if (!com->file) {
-                com->err.code = SEIS_SEGY_ERR_FILE_OPEN;
-                com->err.message = "can't open file for writing";
-                goto error;
-        }
 #ifndef SU_BIG_ENDIAN
         com->bin_hdr.endianness = 0x01020304;
 #endif
         TRY(assign_raw_writers(sgy));
         com->bytes_per_sample = 4;
         com->bin_hdr.format_code = 1;
-        sgy->write_sample = write_IEEE_float_native;
+        /* SU samples are IEEE floats in spite of format code */
+        sgy->encode = seis_segy_get_encoder(5, sgy->write_u32 == write_u32_sw);
+        sgy->encode_f =
+            seis_segy_get_float_encoder(5, sgy->write_u32 == write_u32_sw);
         com->samp_per_tr = 0;
         com->samp_buf = NULL;
-        sgy->write_trace_samples = write_trace_samples_var;
+        sgy->fit_samp_buf = fit_samp_buf_var;
         sgy->update_bin_header = 0;
 error:
         return com->err.code;
 }
 
 SeisSegyErrCode seis_osu_write_trace(SeisOSU *su, SeisTrace *trc) {
-        SeisSegyErr const *err = seis_osu_get_error(su);
-        TRY(write_trace_header(su->sgy, seis_trace_get_header(trc)));
-        return su->sgy->write_trace_samples(su->sgy, trc);
-error:
-        return err->code;
+        return seis_osegy_write_trace(su->sgy, trc);
+}
+
+SeisSegyErrCode seis_osu_write_trace_float(SeisOSU *su,
+                                           SeisSegyFloatTrace *trc) {
+        return seis_osegy_write_trace_float(su->sgy, trc);
+}
+
+SeisSegyErrCode seis_osu_write_trace_std(SeisOSU *su,
+                                         SeisSegyStdHeader const *hdr,
+                                         double const *samples,
+                                         long long samp_num) {
+        return seis_osegy_write_trace_std(su->sgy, hdr, samples, samp_num);
 }
 
 SeisSegyErrCode write_to_file(SeisOSegy *sgy, char const *buf, size_t num) {
         SeisCommonSegy *com = sgy->com;
-        size_t written = fwrite(buf, 1, num, com->file);
-        if (written != num) {
+        long long written =
+            seis_segy_backend_write_at(com->backend, buf, num, sgy->curr_pos);
+        if (written != (long long)num) {
                 com->err.code = SEIS_SEGY_ERR_FILE_WRITE;
                 com->err.message = "written less bytes than should";
         }
+        if (written > 0)
+                sgy->curr_pos += written;
+        return com->err.code;
+}
+
+SeisSegyErrCode open_file(SeisOSegy *sgy, char const *file_name) {
+        SeisCommonSegy *com = sgy->com;
+        /* open func must be called only once */
+        assert(!com->backend);
+        /* stream buffer joins small header and sample writes */
+        com->backend = seis_segy_backend_stdio_new(file_name, "wb");
+        if (!com->backend) {
+                com->err.code = SEIS_SEGY_ERR_FILE_OPEN;
+                com->err.message = "can't open file for writing";
+        }
         return com->err.code;
 }
 
 SeisSegyErrCode assign_raw_writers(SeisOSegy *sgy) {
-        sgy->write_i8 = write_i8;
         sgy->write_u8 = write_u8;
         switch (sgy->com->bin_hdr.endianness) {
         case 0x01020304:
                 sgy->write_i16 = write_i16;
                 sgy->write_u16 = write_u16;
-                sgy->write_i24 = write_i24;
-                sgy->write_u24 = write_u24;
                 sgy->write_i32 = write_i32;
                 sgy->write_u32 = write_u32;
                 sgy->write_i64 = write_i64;
@@ -332,8 +388,6 @@ SeisSegyErrCode assign_raw_writers(SeisOSegy *sgy) {
         case 0x04030201:
                 sgy->write_i16 = write_i16_sw;
                 sgy->write_u16 = write_u16_sw;
-                sgy->write_i24 = write_i24_sw;
-                sgy->write_u24 = write_u24_sw;
                 sgy->write_i32 = write_i32_sw;
                 sgy->write_u32 = write_u32_sw;
                 sgy->write_i64 = write_i64_sw;
@@ -342,61 +396,23 @@ SeisSegyErrCode assign_raw_writers(SeisOSegy *sgy) {
         default:
                 sgy->com->err.code = SEIS_SEGY_ERR_UNKNOWN_ENDIANNESS;
                 sgy->com->err.message = "unsupported endianness";
-                break;
+                return sgy->com->err.code;
         }
         if (FLT_RADIX == 2 && DBL_MANT_DIG == 53) {
-                sgy->write_IEEE_float = write_IEEE_float_native;
                 sgy->write_IEEE_double = write_IEEE_double_native;
         } else {
-                sgy->write_IEEE_float = write_IEEE_float;
                 sgy->write_IEEE_double = write_IEEE_double;
         }
-        sgy->write_ibm_float = write_IBM_float;
-        return sgy->com->err.code;
+        return seis_common_segy_compile_schema(sgy->com,
+                                               sgy->write_u32 == write_u32_sw);
 }
 
-SeisSegyErrCode assign_sample_writer(SeisOSegy *sgy) {
-        switch (sgy->com->bin_hdr.format_code) {
-        case 1:
-                sgy->write_sample = write_IBM_float;
-                break;
-        case 2:
-                sgy->write_sample = dbl_to_i32;
-                break;
-        case 3:
-                sgy->write_sample = dbl_to_i16;
-                break;
-        case 5:
-                sgy->write_sample = sgy->write_IEEE_float;
-                break;
-        case 6:
-                sgy->write_sample = sgy->write_IEEE_double;
-                break;
-        case 7:
-                sgy->write_sample = dbl_to_i24;
-                break;
-        case 8:
-                sgy->write_sample = dbl_to_i8;
-                break;
-        case 9:
-                sgy->write_sample = dbl_to_i64;
-                break;
-        case 10:
-                sgy->write_sample = dbl_to_u32;
-                break;
-        case 11:
-                sgy->write_sample = dbl_to_u16;
-                break;
-        case 12:
-                sgy->write_sample = dbl_to_u64;
-                break;
-        case 15:
-                sgy->write_sample = dbl_to_u24;
-                break;
-        case 16:
-                sgy->write_sample = dbl_to_u8;
-                break;
-        default:
+SeisSegyErrCode assign_sample_encoders(SeisOSegy *sgy) {
+        int format_code = sgy->com->bin_hdr.format_code;
+        bool swap = sgy->write_u32 == write_u32_sw;
+        sgy->encode = seis_segy_get_encoder(format_code, swap);
+        sgy->encode_f = seis_segy_get_float_encoder(format_code, swap);
+        if (!sgy->encode || !sgy->encode_f) {
                 sgy->com->err.code = SEIS_SEGY_ERR_UNSUPPORTED_FORMAT;
                 sgy->com->err.message = "unknown format code in binary header";
         }
@@ -532,7 +548,7 @@ SeisSegyErrCode write_bin_header(SeisOSegy *sgy) {
         sgy->write_u64(&ptr, com->bin_hdr.num_of_tr_in_file);
         sgy->write_u64(&ptr, com->bin_hdr.byte_off_of_first_tr);
         sgy->write_i32(&ptr, com->bin_hdr.num_of_trailer_stanza);
-        fseek(com->file, SEIS_SEGY_TEXT_HEADER_SIZE, SEEK_SET);
+        sgy->curr_pos = SEIS_SEGY_TEXT_HEADER_SIZE;
         write_to_file(sgy, bin_buf, SEIS_SEGY_BIN_HEADER_SIZE);
         free(bin_buf);
         return com->err.code;
@@ -558,93 +574,10 @@ SeisSegyErrCode write_trailer_stanzas(SeisOSegy *sgy) {
         return com->err.code;
 }
 
-void fill_buf_with_fmt_arr(SeisOSegy *sgy, single_hdr_fmt_t *arr,
-                           SeisTraceHeader *hdr) {
-        char *ptr;
-        char const *tmp;
-        SeisTraceHeaderValue v;
-        long long const *i;
-        double const *d;
-        SeisCommonSegy *com = sgy->com;
-        memset(com->hdr_buf, 0, SEIS_SEGY_TRACE_HEADER_SIZE);
-        for
-                M_EACH(item, *arr, M_OPL_single_hdr_fmt_t()) {
-                        ptr = com->hdr_buf + (*item)->offset;
-                        switch ((*item)->format) {
-                        case i8:
-                                v = seis_trace_header_get(
-                                    hdr, string_get_cstr((*item)->name));
-                                i = seis_trace_header_value_get_int(v);
-                                sgy->write_i8(&ptr, i ? *i : 0);
-                                break;
-                        case u8:
-                                v = seis_trace_header_get(
-                                    hdr, string_get_cstr((*item)->name));
-                                i = seis_trace_header_value_get_int(v);
-                                sgy->write_u8(&ptr, i ? *i : 0);
-                                break;
-                        case i16:
-                                v = seis_trace_header_get(
-                                    hdr, string_get_cstr((*item)->name));
-                                i = seis_trace_header_value_get_int(v);
-                                sgy->write_i16(&ptr, i ? *i : 0);
-                                break;
-                        case u16:
-                                v = seis_trace_header_get(
-                                    hdr, string_get_cstr((*item)->name));
-                                i = seis_trace_header_value_get_int(v);
-                                sgy->write_u16(&ptr, i ? *i : 0);
-                                break;
-                        case i32:
-                                v = seis_trace_header_get(
-                                    hdr, string_get_cstr((*item)->name));
-                                i = seis_trace_header_value_get_int(v);
-                                sgy->write_i32(&ptr, i ? *i : 0);
-                                break;
-                        case u32:
-                                v = seis_trace_header_get(
-                                    hdr, string_get_cstr((*item)->name));
-                                i = seis_trace_header_value_get_int(v);
-                                sgy->write_u32(&ptr, i ? *i : 0);
-                                break;
-                        case i64:
-                                v = seis_trace_header_get(
-                                    hdr, string_get_cstr((*item)->name));
-                                i = seis_trace_header_value_get_int(v);
-                                sgy->write_i64(&ptr, i ? *i : 0);
-                                break;
-                        case u64:
-                                v = seis_trace_header_get(
-                                    hdr, string_get_cstr((*item)->name));
-                                i = seis_trace_header_value_get_int(v);
-                                sgy->write_u64(&ptr, i ? *i : 0);
-                                break;
-                        case f32:
-                                v = seis_trace_header_get(
-                                    hdr, string_get_cstr((*item)->name));
-                                d = seis_trace_header_value_get_real(v);
-                                sgy->write_IEEE_float(sgy, &ptr, d ? *d : 0);
-                                break;
-                        case f64:
-                                v = seis_trace_header_get(
-                                    hdr, string_get_cstr((*item)->name));
-                                d = seis_trace_header_value_get_real(v);
-                                sgy->write_IEEE_double(sgy, &ptr, d ? *d : 0);
-                                break;
-                        case b64:
-                                tmp = string_get_cstr((*item)->name);
-                                size_t size = strlen(tmp);
-                                size = size > 8 ? 8 : size;
-                                memcpy(ptr, tmp, size);
-                                break;
-                        }
-                }
-}
-
 SeisSegyErrCode write_trace_header(SeisOSegy *sgy, SeisTraceHeader *hdr) {
         SeisCommonSegy *com = sgy->com;
         SeisCommonSegyPrivate *priv = (SeisCommonSegyPrivate *)com;
-        fill_buf_with_fmt_arr(sgy, mult_hdr_fmt_get(priv->trc_hdr_map, 0), hdr);
+        seis_segy_hdr_schema_encode(priv->schema, 0, hdr, com->hdr_buf);
         TRY(write_to_file(sgy, com->hdr_buf, SEIS_SEGY_TRACE_HEADER_SIZE));
         if (com->bin_hdr.max_num_add_tr_headers) {
                 SeisTraceHeaderValue v =
@@ -657,8 +590,8 @@ SeisSegyErrCode write_trace_header(SeisOSegy *sgy, SeisTraceHeader *hdr) {
                 else
                         to_write = *add_hdr_num;
                 for (int i = 1; i < 1 + to_write; ++i) {
-                        fill_buf_with_fmt_arr(
-                            sgy, mult_hdr_fmt_get(priv->trc_hdr_map, i), hdr);
+                        seis_segy_hdr_schema_encode(priv->schema, i, hdr,
+                                                    com->hdr_buf);
                         TRY(write_to_file(sgy, com->hdr_buf,
                                           SEIS_SEGY_TRACE_HEADER_SIZE));
                 }
@@ -667,20 +600,38 @@ error:
         return com->err.code;
 }
 
-SeisSegyErrCode write_trace_samples_fix(SeisOSegy *sgy, SeisTrace const *t) {
+SeisSegyErrCode write_std_header(SeisOSegy *sgy,
+                                 SeisSegyStdHeader const *hdr) {
         SeisCommonSegy *com = sgy->com;
-        char *buf = com->samp_buf;
-        double const *samples = seis_trace_get_samples_const(t);
-        long long const samp_num = seis_trace_get_samples_num(t);
-        for (long long i = 0; i < samp_num; ++i)
-                sgy->write_sample(sgy, &buf, samples[i]);
-        write_to_file(sgy, com->samp_buf, com->bytes_per_sample * samp_num);
+        size_t const size = SEIS_SEGY_TRACE_HEADER_SIZE;
+        char buf[2 * SEIS_SEGY_TRACE_HEADER_SIZE];
+        int to_write = com->bin_hdr.max_num_add_tr_headers;
+        /* first additional header keeps number of additional headers */
+        if (to_write && hdr->has_ext && hdr->ext_add_trc_hdr)
+                to_write = hdr->ext_add_trc_hdr;
+        size_t num = to_write ? 2 * size : size;
+        /* additional headers without struct fields are zeros */
+        memset(buf, 0, sizeof(buf));
+        seis_segy_std_header_encode(hdr, buf, num, is_big_endian(sgy));
+        TRY(write_to_file(sgy, buf, num));
+        memset(buf, 0, size);
+        for (int i = 2; i <= to_write; ++i)
+                TRY(write_to_file(sgy, buf, size));
+error:
         return com->err.code;
 }
 
-SeisSegyErrCode write_trace_samples_var(SeisOSegy *sgy, SeisTrace const *t) {
+bool is_big_endian(SeisOSegy const *sgy) {
+        return (sgy->write_u32 == write_u32_sw) == host_is_little_endian();
+}
+
+SeisSegyErrCode fit_samp_buf_fix(SeisOSegy *sgy, long long samp_num) {
+        UNUSED(samp_num);
+        return sgy->com->err.code;
+}
+
+SeisSegyErrCode fit_samp_buf_var(SeisOSegy *sgy, long long samp_num) {
         SeisCommonSegy *com = sgy->com;
-        long long const samp_num = seis_trace_get_samples_num(t);
         if (samp_num > com->samp_per_tr) {
                 long long bytes_num = samp_num * com->bytes_per_sample;
                 com->samp_buf = realloc(com->samp_buf, bytes_num);
@@ -692,14 +643,28 @@ SeisSegyErrCode write_trace_samples_var(SeisOSegy *sgy, SeisTrace const *t) {
                 }
                 com->samp_per_tr = samp_num;
         }
-        return write_trace_samples_fix(sgy, t);
 error:
         return com->err.code;
 }
 
-void write_i8(char **buf, int8_t val) {
-        memcpy(*buf, &val, sizeof(int8_t));
-        ++*buf;
+SeisSegyErrCode write_trace_samples(SeisOSegy *sgy, double const *samples,
+                                    long long samp_num) {
+        SeisCommonSegy *com = sgy->com;
+        TRY(sgy->fit_samp_buf(sgy, samp_num));
+        sgy->encode(com->samp_buf, samples, samp_num);
+        write_to_file(sgy, com->samp_buf, com->bytes_per_sample * samp_num);
+error:
+        return com->err.code;
+}
+
+SeisSegyErrCode write_trace_samples_float(SeisOSegy *sgy, float const *samples,
+                                          long long samp_num) {
+        SeisCommonSegy *com = sgy->com;
+        TRY(sgy->fit_samp_buf(sgy, samp_num));
+        sgy->encode_f(com->samp_buf, samples, samp_num);
+        write_to_file(sgy, com->samp_buf, com->bytes_per_sample * samp_num);
+error:
+        return com->err.code;
 }
 
 void write_u8(char **buf, uint8_t val) {
@@ -717,24 +682,6 @@ void write_u16(char **buf, uint16_t val) {
         *buf += sizeof(uint16_t);
 }
 
-void write_i24(char **buf, int32_t val) {
-        uint16_t tmp16 = (uint32_t)val & 0xff;
-        memcpy(*buf, &tmp16, sizeof(int16_t));
-        *buf += sizeof(int16_t);
-        uint8_t tmp8 = ((uint32_t)val & 0x0f00) >> 16;
-        memcpy(*buf, &tmp8, sizeof(int8_t));
-        ++*buf;
-}
-
-void write_u24(char **buf, uint32_t val) {
-        uint16_t tmp16 = val & 0xff;
-        memcpy(*buf, &tmp16, sizeof(uint16_t));
-        *buf += sizeof(uint16_t);
-        uint8_t tmp8 = (val & 0x0f00) >> 16;
-        memcpy(*buf, &tmp8, sizeof(uint8_t));
-        ++*buf;
-}
-
 void write_i32(char **buf, int32_t val) {
         memcpy(*buf, &val, sizeof(int32_t));
         *buf += sizeof(int32_t);
@@ -756,92 +703,27 @@ void write_u64(char **buf, uint64_t val) {
 }
 
 void write_i16_sw(char **buf, int16_t val) {
-        uint16_t tmp = val;
-        val = (tmp & 0xff) << 8 | (tmp & 0xff00) >> 8;
-        memcpy(*buf, &val, sizeof(int16_t));
-        *buf += sizeof(int16_t);
+        write_u16(buf, bswap16((uint16_t)val));
 }
 
 void write_u16_sw(char **buf, uint16_t val) {
-        uint16_t tmp = val;
-        val = (tmp & 0xff) << 8 | (tmp & 0xff00) >> 8;
-        memcpy(*buf, &val, sizeof(uint16_t));
-        *buf += sizeof(uint16_t);
-}
-
-void write_i24_sw(char **buf, int32_t val) {
-        uint8_t tmp8 = ((uint32_t)val & 0x0f00) >> 16;
-        memcpy(*buf, &tmp8, sizeof(int8_t));
-        ++*buf;
-        uint16_t tmp16 = (uint32_t)val & 0xff;
-        tmp16 = (tmp16 & 0xf) << 8 | (tmp16 & 0xf0) >> 8;
-        memcpy(*buf, &tmp16, sizeof(int16_t));
-        *buf += sizeof(int16_t);
-}
-
-void write_u24_sw(char **buf, uint32_t val) {
-        uint8_t tmp8 = (val & 0x0f00) >> 16;
-        memcpy(*buf, &tmp8, sizeof(int8_t));
-        ++*buf;
-        uint16_t tmp16 = val & 0xff;
-        tmp16 = (tmp16 & 0xf) << 8 | (tmp16 & 0xf0) >> 8;
-        memcpy(*buf, &tmp16, sizeof(uint16_t));
-        *buf += sizeof(uint16_t);
+        write_u16(buf, bswap16(val));
 }
 
 void write_i32_sw(char **buf, int32_t val) {
-        uint32_t tmp = val;
-        val = (tmp & 0xff) << 24 | (tmp & 0xff000000) >> 24 |
-              (tmp & 0xff00) << 8 | (tmp & 0xff0000) >> 8;
-        memcpy(*buf, &val, sizeof(int32_t));
-        *buf += sizeof(int32_t);
+        write_u32(buf, bswap32((uint32_t)val));
 }
 
 void write_u32_sw(char **buf, uint32_t val) {
-        uint32_t tmp = val;
-        val = (tmp & 0xff) << 24 | (tmp & 0xff000000) >> 24 |
-              (tmp & 0xff00) << 8 | (tmp & 0xff0000) >> 8;
-        memcpy(*buf, &val, sizeof(uint32_t));
-        *buf += sizeof(uint32_t);
+        write_u32(buf, bswap32(val));
 }
 
 void write_i64_sw(char **buf, int64_t val) {
-        uint64_t tmp = val;
-        val = (tmp & 0xff) << 56 | (tmp & 0xff00000000000000) >> 56 |
-              (tmp & 0xff00) << 40 | (tmp & 0xff000000000000) >> 40 |
-              (tmp & 0xff0000) << 24 | (tmp & 0xff0000000000) >> 24 |
-              (tmp & 0xff000000) << 8 | (tmp & 0xff00000000) >> 8;
-        memcpy(*buf, &val, sizeof(int64_t));
-        *buf += sizeof(int64_t);
+        write_u64(buf, bswap64((uint64_t)val));
 }
 
 void write_u64_sw(char **buf, uint64_t val) {
-        uint64_t tmp = val;
-        val = (tmp & 0xff) << 56 | (tmp & 0xff00000000000000) >> 56 |
-              (tmp & 0xff00) << 40 | (tmp & 0xff000000000000) >> 40 |
-              (tmp & 0xff0000) << 24 | (tmp & 0xff0000000000) >> 24 |
-              (tmp & 0xff000000) << 8 | (tmp & 0xff00000000) >> 8;
-        memcpy(*buf, &val, sizeof(uint64_t));
-        *buf += sizeof(uint64_t);
-}
-
-void write_IBM_float(SeisOSegy *sgy, char **buf, double val) {
-        uint32_t sign = val < 0 ? 1 : 0;
-        double abs_val = fabs(val);
-        uint32_t exp = (uint32_t)(log(abs_val) / log(2) / 4 + 1 + 64) & 0x7f;
-        uint32_t fraction = abs_val / pow(16, (int)exp - 64) * pow(2, 24);
-        uint32_t result = sign << 31 | exp << 24 | (fraction & 0x00ffffff);
-        sgy->write_u32(buf, result);
-}
-
-void write_IEEE_float(SeisOSegy *sgy, char **buf, double val) {
-        uint32_t sign = val < 0 ? 1 : 0;
-        double abs_val = fabs(val);
-        uint32_t exp = (uint32_t)(log(abs_val) / log(2) + 1 + 127) & 0xff;
-        uint32_t fraction =
-            abs_val / pow(2, (int32_t)exp - 127) * pow(2, 23) - 1;
-        uint32_t result = sign << 31 | exp << 23 | (fraction & 0x007fffff);
-        sgy->write_u32(buf, result);
+        write_u64(buf, bswap64(val));
 }
 
 void write_IEEE_double(SeisOSegy *sgy, char **buf, double val) {
@@ -854,55 +736,8 @@ void write_IEEE_double(SeisOSegy *sgy, char **buf, double val) {
         sgy->write_u64(buf, result);
 }
 
-void write_IEEE_float_native(SeisOSegy *sgy, char **buf, double val) {
-        float flt = val;
-        uint32_t tmp;
-        memcpy(&tmp, &flt, sizeof(float));
-        sgy->write_u32(buf, tmp);
-}
-
 void write_IEEE_double_native(SeisOSegy *sgy, char **buf, double val) {
         uint64_t tmp;
         memcpy(&tmp, &val, sizeof(double));
         sgy->write_u64(buf, tmp);
 }
-
-void dbl_to_i8(SeisOSegy *sgy, char **buf, double val) {
-        sgy->write_i8(buf, (int8_t)val);
-}
-
-void dbl_to_u8(SeisOSegy *sgy, char **buf, double val) {
-        sgy->write_u8(buf, (uint8_t)val);
-}
-
-void dbl_to_i16(SeisOSegy *sgy, char **buf, double val) {
-        sgy->write_i16(buf, (int16_t)val);
-}
-
-void dbl_to_u16(SeisOSegy *sgy, char **buf, double val) {
-        sgy->write_u16(buf, (uint16_t)val);
-}
-
-void dbl_to_i24(SeisOSegy *sgy, char **buf, double val) {
-        sgy->write_i24(buf, (int32_t)val);
-}
-
-void dbl_to_u24(SeisOSegy *sgy, char **buf, double val) {
-        sgy->write_u24(buf, (uint32_t)val);
-}
-
-void dbl_to_i32(SeisOSegy *sgy, char **buf, double val) {
-        sgy->write_i32(buf, (int32_t)val);
-}
-
-void dbl_to_u32(SeisOSegy *sgy, char **buf, double val) {
-        sgy->write_u32(buf, (uint32_t)val);
-}
-
-void dbl_to_i64(SeisOSegy *sgy, char **buf, double val) {
-        sgy->write_i64(buf, (int64_t)val);
-}
-
-void dbl_to_u64(SeisOSegy *sgy, char **buf, double val) {
-        sgy->write_u64(buf, (uint64_t)val);
-}
@@ -0,0 +1,512 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "SeisSegyBackend.h"
+#include "SeisCommonSegy.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct SeisSegyBackend {
+        SeisSegyBackendOps ops;
+        void *data;
+        int fd;
+        int rc;
+};
+
+struct stdio_data {
+        FILE *file;
+        long pos;
+        bool writable;
+};
+
+struct fd_data {
+        int fd;
+        bool owner;
+};
+
+struct stream_data {
+        int fd;
+        size_t pos;
+        bool owner;
+};
+
+struct mem_data {
+        char const *buf;
+        size_t size;
+};
+
+struct wmem_data {
+        char *buf;
+        size_t size, cap;
+};
+
+static long long stdio_read_at(void *data, void *buf, size_t num,
+                               size_t offset);
+static long long stdio_write_at(void *data, void const *buf, size_t num,
+                                size_t offset);
+static long long stdio_size(void *data);
+static void stdio_hint(void *data, SeisSegyAccessHint hint, size_t offset,
+                       size_t num);
+static void stdio_close(void *data);
+static long long fd_read_at(void *data, void *buf, size_t num, size_t offset);
+static long long fd_write_at(void *data, void const *buf, size_t num,
+                             size_t offset);
+static long long fd_size(void *data);
+static void fd_hint(void *data, SeisSegyAccessHint hint, size_t offset,
+                    size_t num);
+static void fd_close(void *data);
+static long long stream_read_at(void *data, void *buf, size_t num,
+                                size_t offset);
+static long long stream_size(void *data);
+static void stream_close(void *data);
+static long long mem_read_at(void *data, void *buf, size_t num, size_t offset);
+static long long mem_size(void *data);
+static char const *mem_view(void *data);
+static void mem_close(void *data);
+static void mmap_hint(void *data, SeisSegyAccessHint hint, size_t offset,
+                      size_t num);
+static void mmap_close(void *data);
+static long long wmem_read_at(void *data, void *buf, size_t num,
+                              size_t offset);
+static long long wmem_write_at(void *data, void const *buf, size_t num,
+                               size_t offset);
+static long long wmem_size(void *data);
+static void wmem_close(void *data);
+static int fadvice(SeisSegyAccessHint hint);
+
+static SeisSegyBackendOps const stdio_ops = {
+    stdio_read_at, stdio_write_at, stdio_size, stdio_hint, NULL, stdio_close};
+static SeisSegyBackendOps const fd_ops = {fd_read_at, fd_write_at, fd_size,
+                                          fd_hint,    NULL,        fd_close};
+static SeisSegyBackendOps const stream_ops = {
+    stream_read_at, NULL, stream_size, NULL, NULL, stream_close};
+static SeisSegyBackendOps const mmap_ops = {mem_read_at, NULL,     mem_size,
+                                            mmap_hint,   mem_view, mmap_close};
+static SeisSegyBackendOps const mem_ops = {mem_read_at, NULL,     mem_size,
+                                           NULL,        mem_view, mem_close};
+static SeisSegyBackendOps const wmem_ops = {
+    wmem_read_at, wmem_write_at, wmem_size, NULL, NULL, wmem_close};
+
+SeisSegyBackend *seis_segy_backend_new(SeisSegyBackendOps const *ops,
+                                       void *data) {
+        SeisSegyBackend *b = (SeisSegyBackend *)malloc(sizeof(*b));
+        if (!b)
+                return NULL;
+        b->ops = *ops;
+        b->data = data;
+        b->fd = -1;
+        b->rc = 1;
+        return b;
+}
+
+SeisSegyBackend *seis_segy_backend_stdio_new(char const *file_name,
+                                             char const *mode) {
+        struct stdio_data *d = (struct stdio_data *)malloc(sizeof(*d));
+        if (!d)
+                return NULL;
+        d->file = fopen(file_name, mode);
+        if (!d->file) {
+                free(d);
+                return NULL;
+        }
+        d->pos = 0;
+        d->writable = strpbrk(mode, "wa+");
+        SeisSegyBackend *b = seis_segy_backend_new(&stdio_ops, d);
+        if (!b) {
+                stdio_close(d);
+                return NULL;
+        }
+        b->fd = fileno(d->file);
+        return b;
+}
+
+SeisSegyBackend *seis_segy_backend_fd_new(int fd, bool owner) {
+        struct fd_data *d = (struct fd_data *)malloc(sizeof(*d));
+        if (!d)
+                return NULL;
+        d->fd = fd;
+        d->owner = owner;
+        SeisSegyBackend *b = seis_segy_backend_new(&fd_ops, d);
+        if (!b) {
+                free(d);
+                return NULL;
+        }
+        b->fd = fd;
+        return b;
+}
+
+SeisSegyBackend *seis_segy_backend_stream_new(int fd, bool owner) {
+        struct stream_data *d = (struct stream_data *)malloc(sizeof(*d));
+        if (!d)
+                return NULL;
+        d->fd = fd;
+        d->pos = 0;
+        d->owner = owner;
+        SeisSegyBackend *b = seis_segy_backend_new(&stream_ops, d);
+        if (!b) {
+                free(d);
+                return NULL;
+        }
+        return b;
+}
+
+SeisSegyBackend *seis_segy_backend_mmap_new(char const *file_name) {
+        struct mem_data *d = (struct mem_data *)calloc(1, sizeof(*d));
+        if (!d)
+                return NULL;
+        int fd = open(file_name, O_RDONLY);
+        if (fd == -1)
+                goto error;
+        struct stat st;
+        if (fstat(fd, &st) == -1) {
+                close(fd);
+                goto error;
+        }
+        /* zero length can't be mapped */
+        if (st.st_size) {
+                void *map =
+                    mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (map == MAP_FAILED) {
+                        close(fd);
+                        goto error;
+                }
+                d->buf = (char const *)map;
+                d->size = st.st_size;
+        }
+        /* mapping stays valid after descriptor is closed */
+        close(fd);
+        SeisSegyBackend *b = seis_segy_backend_new(&mmap_ops, d);
+        if (!b) {
+                mmap_close(d);
+                return NULL;
+        }
+        return b;
+error:
+        free(d);
+        return NULL;
+}
+
+SeisSegyBackend *seis_segy_backend_memory_new(void const *buf, size_t size) {
+        struct mem_data *d = (struct mem_data *)malloc(sizeof(*d));
+        if (!d)
+                return NULL;
+        d->buf = (char const *)buf;
+        d->size = size;
+        SeisSegyBackend *b = seis_segy_backend_new(&mem_ops, d);
+        if (!b)
+                free(d);
+        return b;
+}
+
+SeisSegyBackend *seis_segy_backend_memory_new_writable(void) {
+        struct wmem_data *d = (struct wmem_data *)calloc(1, sizeof(*d));
+        if (!d)
+                return NULL;
+        SeisSegyBackend *b = seis_segy_backend_new(&wmem_ops, d);
+        if (!b)
+                free(d);
+        return b;
+}
+
+char const *seis_segy_backend_memory_get_data(SeisSegyBackend const *b,
+                                              size_t *size) {
+        if (b->ops.write_at != wmem_write_at)
+                return NULL;
+        struct wmem_data const *d = (struct wmem_data const *)b->data;
+        *size = d->size;
+        return d->buf;
+}
+
+SeisSegyBackend *seis_segy_backend_ref(SeisSegyBackend *b) {
+        ++b->rc;
+        return b;
+}
+
+void seis_segy_backend_unref(SeisSegyBackend **b) {
+        if (*b)
+                if (--(*b)->rc == 0) {
+                        if ((*b)->ops.close)
+                                (*b)->ops.close((*b)->data);
+                        free(*b);
+                        *b = NULL;
+                }
+}
+
+long long seis_segy_backend_read_at(SeisSegyBackend const *b, void *buf,
+                                    size_t num, size_t offset) {
+        if (!b->ops.read_at)
+                return -1;
+        return b->ops.read_at(b->data, buf, num, offset);
+}
+
+long long seis_segy_backend_write_at(SeisSegyBackend *b, void const *buf,
+                                     size_t num, size_t offset) {
+        if (!b->ops.write_at)
+                return -1;
+        return b->ops.write_at(b->data, buf, num, offset);
+}
+
+long long seis_segy_backend_size(SeisSegyBackend const *b) {
+        if (!b->ops.size)
+                return -1;
+        return b->ops.size(b->data);
+}
+
+void seis_segy_backend_hint(SeisSegyBackend const *b, SeisSegyAccessHint hint,
+                            size_t offset, size_t num) {
+        if (b->ops.hint)
+                b->ops.hint(b->data, hint, offset, num);
+}
+
+char const *seis_segy_backend_view(SeisSegyBackend const *b) {
+        if (!b->ops.view)
+                return NULL;
+        return b->ops.view(b->data);
+}
+
+int seis_segy_backend_get_fd(SeisSegyBackend const *b) { return b->fd; }
+
+long long stdio_read_at(void *data, void *buf, size_t num, size_t offset) {
+        struct stdio_data *d = (struct stdio_data *)data;
+        /* pending writes must reach file before it is read past stream */
+        if (d->writable)
+                fflush(d->file);
+        return fd_read_at(&(struct fd_data){fileno(d->file), false}, buf, num,
+                          offset);
+}
+
+long long stdio_write_at(void *data, void const *buf, size_t num,
+                         size_t offset) {
+        struct stdio_data *d = (struct stdio_data *)data;
+        /* sequential writes are served by stream buffer without seeking */
+        if (d->pos != (long)offset) {
+                if (fseek(d->file, offset, SEEK_SET))
+                        return -1;
+                d->pos = offset;
+        }
+        size_t written = fwrite(buf, 1, num, d->file);
+        d->pos += written;
+        return written;
+}
+
+long long stdio_size(void *data) {
+        struct stdio_data *d = (struct stdio_data *)data;
+        if (d->writable)
+                fflush(d->file);
+        return fd_size(&(struct fd_data){fileno(d->file), false});
+}
+
+void stdio_hint(void *data, SeisSegyAccessHint hint, size_t offset,
+                size_t num) {
+        struct stdio_data *d = (struct stdio_data *)data;
+        posix_fadvise(fileno(d->file), offset, num, fadvice(hint));
+}
+
+void stdio_close(void *data) {
+        struct stdio_data *d = (struct stdio_data *)data;
+        fclose(d->file);
+        free(d);
+}
+
+long long fd_read_at(void *data, void *buf, size_t num, size_t offset) {
+        struct fd_data *d = (struct fd_data *)data;
+        size_t done = 0;
+        while (done < num) {
+                ssize_t got =
+                    pread(d->fd, (char *)buf + done, num - done, offset + done);
+                if (got == -1 && errno == EINTR)
+                        continue;
+                if (got == -1)
+                        return done ? (long long)done : -1;
+                if (!got)
+                        break;
+                done += got;
+        }
+        return done;
+}
+
+long long fd_write_at(void *data, void const *buf, size_t num, size_t offset) {
+        struct fd_data *d = (struct fd_data *)data;
+        size_t done = 0;
+        while (done < num) {
+                ssize_t put = pwrite(d->fd, (char const *)buf + done,
+                                     num - done, offset + done);
+                if (put == -1 && errno == EINTR)
+                        continue;
+                if (put <= 0)
+                        return -1;
+                done += put;
+        }
+        return done;
+}
+
+long long fd_size(void *data) {
+        struct fd_data *d = (struct fd_data *)data;
+        struct stat st;
+        /* pipes and sockets have no size */
+        if (fstat(d->fd, &st) == -1 || !S_ISREG(st.st_mode))
+                return -1;
+        return st.st_size;
+}
+
+void fd_hint(void *data, SeisSegyAccessHint hint, size_t offset, size_t num) {
+        struct fd_data *d = (struct fd_data *)data;
+        posix_fadvise(d->fd, offset, num, fadvice(hint));
+}
+
+void fd_close(void *data) {
+        struct fd_data *d = (struct fd_data *)data;
+        if (d->owner)
+                close(d->fd);
+        free(d);
+}
+
+/* makes single read to not wait for data which is not requested yet */
+long long stream_read_at(void *data, void *buf, size_t num, size_t offset) {
+        struct stream_data *d = (struct stream_data *)data;
+        char skip[4096];
+        if (offset < d->pos)
+                return -1;
+        while (d->pos < offset) {
+                size_t left = offset - d->pos;
+                ssize_t got = read(d->fd, skip,
+                                   left < sizeof(skip) ? left : sizeof(skip));
+                if (got == -1 && errno == EINTR)
+                        continue;
+                if (got <= 0)
+                        return got ? -1 : 0;
+                d->pos += got;
+        }
+        while (1) {
+                ssize_t got = read(d->fd, buf, num);
+                if (got == -1 && errno == EINTR)
+                        continue;
+                if (got == -1)
+                        return -1;
+                d->pos += got;
+                return got;
+        }
+}
+
+long long stream_size(void *data) {
+        (void)data;
+        return -1;
+}
+
+void stream_close(void *data) {
+        struct stream_data *d = (struct stream_data *)data;
+        if (d->owner)
+                close(d->fd);
+        free(d);
+}
+
+long long mem_read_at(void *data, void *buf, size_t num, size_t offset) {
+        struct mem_data *d = (struct mem_data *)data;
+        if (offset >= d->size)
+                return 0;
+        if (num > d->size - offset)
+                num = d->size - offset;
+        memcpy(buf, d->buf + offset, num);
+        return num;
+}
+
+long long mem_size(void *data) { return ((struct mem_data *)data)->size; }
+
+char const *mem_view(void *data) { return ((struct mem_data *)data)->buf; }
+
+void mem_close(void *data) { free(data); }
+
+void mmap_hint(void *data, SeisSegyAccessHint hint, size_t offset,
+               size_t num) {
+        struct mem_data *d = (struct mem_data *)data;
+        if (offset >= d->size)
+                return;
+        if (!num || num > d->size - offset)
+                num = d->size - offset;
+        /* advice range must start at page boundary */
+        size_t page = sysconf(_SC_PAGESIZE);
+        size_t start = offset / page * page;
+        int advice = POSIX_MADV_NORMAL;
+        switch (hint) {
+        case SEIS_SEGY_ACCESS_NORMAL:
+                break;
+        case SEIS_SEGY_ACCESS_SEQUENTIAL:
+                advice = POSIX_MADV_SEQUENTIAL;
+                break;
+        case SEIS_SEGY_ACCESS_RANDOM:
+                advice = POSIX_MADV_RANDOM;
+                break;
+        case SEIS_SEGY_ACCESS_WILLNEED:
+                advice = POSIX_MADV_WILLNEED;
+                break;
+        case SEIS_SEGY_ACCESS_DONTNEED:
+                advice = POSIX_MADV_DONTNEED;
+                break;
+        }
+        posix_madvise((void *)(d->buf + start), num + offset - start, advice);
+}
+
+void mmap_close(void *data) {
+        struct mem_data *d = (struct mem_data *)data;
+        if (d->buf)
+                munmap((void *)d->buf, d->size);
+        free(d);
+}
+
+long long wmem_read_at(void *data, void *buf, size_t num, size_t offset) {
+        struct wmem_data *d = (struct wmem_data *)data;
+        return mem_read_at(&(struct mem_data){d->buf, d->size}, buf, num,
+                           offset);
+}
+
+long long wmem_write_at(void *data, void const *buf, size_t num,
+                        size_t offset) {
+        struct wmem_data *d = (struct wmem_data *)data;
+        if (offset + num > d->cap) {
+                size_t cap = d->cap ? d->cap : 4096;
+                while (cap < offset + num)
+                        cap *= 2;
+                void *res = realloc(d->buf, cap);
+                if (!res)
+                        return -1;
+                d->buf = (char *)res;
+                d->cap = cap;
+        }
+        /* hole left by write past the end reads as zeros */
+        if (offset > d->size)
+                memset(d->buf + d->size, 0, offset - d->size);
+        memcpy(d->buf + offset, buf, num);
+        if (offset + num > d->size)
+                d->size = offset + num;
+        return num;
+}
+
+long long wmem_size(void *data) { return ((struct wmem_data *)data)->size; }
+
+void wmem_close(void *data) {
+        struct wmem_data *d = (struct wmem_data *)data;
+        free(d->buf);
+        free(d);
+}
+
+int fadvice(SeisSegyAccessHint hint) {
+        switch (hint) {
+        case SEIS_SEGY_ACCESS_SEQUENTIAL:
+                return POSIX_FADV_SEQUENTIAL;
+        case SEIS_SEGY_ACCESS_RANDOM:
+                return POSIX_FADV_RANDOM;
+        case SEIS_SEGY_ACCESS_WILLNEED:
+                return POSIX_FADV_WILLNEED;
+        case SEIS_SEGY_ACCESS_DONTNEED:
+                return POSIX_FADV_DONTNEED;
+        default:
+                return POSIX_FADV_NORMAL;
+        }
+}
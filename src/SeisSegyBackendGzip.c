@@ -0,0 +1,421 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "SeisCommonSegy.h"
+#include "SeisSegyBackend.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef SEIS_SEGY_HAVE_ZLIB
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#define WINSIZE 32768
+#define CHUNK 16384
+#define DEFAULT_SPAN (4 * 1024 * 1024)
+#define INDEX_MAGIC "SEISGZI1"
+
+/* decompressor state at deflate block boundary. Decompression restarts
+ * from here with last WINSIZE bytes of output as dictionary. */
+struct point {
+        uint64_t out, in;
+        int32_t bits;
+        unsigned char window[WINSIZE];
+};
+
+struct cursor {
+        z_stream strm;
+        uint64_t out, in;
+        size_t skip;
+        bool raw, active;
+        unsigned char in_buf[CHUNK];
+};
+
+struct gz_data {
+        int fd;
+        uint64_t in_size, size, span;
+        int64_t mtime;
+        struct point *points;
+        size_t points_num;
+        pthread_mutex_t lock;
+        struct cursor cur;
+};
+
+static long long gz_read_at(void *data, void *buf, size_t num, size_t offset);
+static long long gz_size(void *data);
+static void gz_close(void *data);
+static int build_index(struct gz_data *d);
+static int add_point(struct gz_data *d, size_t *cap, z_stream const *strm,
+                     uint64_t in, uint64_t out, unsigned char const *window);
+static int load_index(struct gz_data *d, char const *index_name);
+static void save_index(struct gz_data const *d, char const *index_name);
+static struct point const *find_point(struct gz_data const *d,
+                                      uint64_t offset);
+static int cursor_start(struct gz_data const *d, struct cursor *c,
+                        struct point const *p);
+static long long cursor_read(struct gz_data const *d, struct cursor *c,
+                             char *buf, size_t num, uint64_t offset);
+static void cursor_end(struct cursor *c);
+
+static SeisSegyBackendOps const gz_ops = {gz_read_at, NULL, gz_size,
+                                          NULL,       NULL, gz_close};
+
+SeisSegyBackend *seis_segy_backend_gzip_new(char const *file_name,
+                                            char const *index_name,
+                                            size_t span) {
+        struct gz_data *d = (struct gz_data *)calloc(1, sizeof(*d));
+        if (!d)
+                return NULL;
+        d->span = span ? span : DEFAULT_SPAN;
+        d->fd = open(file_name, O_RDONLY);
+        if (d->fd == -1) {
+                free(d);
+                return NULL;
+        }
+        struct stat st;
+        if (fstat(d->fd, &st) == -1)
+                goto error;
+        d->in_size = st.st_size;
+        d->mtime = st.st_mtime;
+        /* stale or broken index is rebuilt */
+        if (!index_name || load_index(d, index_name)) {
+                if (build_index(d))
+                        goto error;
+                if (index_name)
+                        save_index(d, index_name);
+        }
+        pthread_mutex_init(&d->lock, NULL);
+        SeisSegyBackend *b = seis_segy_backend_new(&gz_ops, d);
+        if (!b) {
+                gz_close(d);
+                return NULL;
+        }
+        return b;
+error:
+        close(d->fd);
+        free(d->points);
+        free(d);
+        return NULL;
+}
+
+/* reader which holds shared cursor continues where previous read stopped.
+ * Concurrent readers decompress with their own cursor. */
+long long gz_read_at(void *data, void *buf, size_t num, size_t offset) {
+        struct gz_data *d = (struct gz_data *)data;
+        if (offset >= d->size)
+                return 0;
+        if (num > d->size - offset)
+                num = d->size - offset;
+        struct cursor *c = &d->cur;
+        bool shared = !pthread_mutex_trylock(&d->lock);
+        if (!shared) {
+                c = (struct cursor *)malloc(sizeof(*c));
+                if (!c)
+                        return -1;
+                c->active = false;
+        }
+        long long res = -1;
+        struct point const *p = find_point(d, offset);
+        uint64_t start = p ? p->out : 0;
+        if (!c->active || c->out > offset || c->out < start)
+                if (cursor_start(d, c, p))
+                        goto error;
+        res = cursor_read(d, c, (char *)buf, num, offset);
+error:
+        if (shared) {
+                pthread_mutex_unlock(&d->lock);
+        } else {
+                cursor_end(c);
+                free(c);
+        }
+        return res;
+}
+
+long long gz_size(void *data) { return ((struct gz_data *)data)->size; }
+
+void gz_close(void *data) {
+        struct gz_data *d = (struct gz_data *)data;
+        cursor_end(&d->cur);
+        pthread_mutex_destroy(&d->lock);
+        close(d->fd);
+        free(d->points);
+        free(d);
+}
+
+/* decompresses whole file once and saves state every span bytes */
+int build_index(struct gz_data *d) {
+        z_stream strm;
+        size_t cap = 0;
+        unsigned char *in_buf = (unsigned char *)malloc(CHUNK);
+        unsigned char *window = (unsigned char *)calloc(1, WINSIZE);
+        if (!in_buf || !window)
+                goto error;
+        memset(&strm, 0, sizeof(strm));
+        if (inflateInit2(&strm, 31) != Z_OK)
+                goto error;
+        uint64_t in_pos = 0, totin = 0, totout = 0, last = 0;
+        int ret = Z_OK;
+        strm.avail_in = 0;
+        strm.avail_out = 0;
+        while (1) {
+                if (!strm.avail_in) {
+                        ssize_t got = pread(d->fd, in_buf, CHUNK, in_pos);
+                        if (got == -1 && errno == EINTR)
+                                continue;
+                        if (got == -1)
+                                goto inflate_error;
+                        if (!got)
+                                break;
+                        in_pos += got;
+                        strm.avail_in = got;
+                        strm.next_in = in_buf;
+                }
+                if (!strm.avail_out) {
+                        strm.avail_out = WINSIZE;
+                        strm.next_out = window;
+                }
+                totin += strm.avail_in;
+                totout += strm.avail_out;
+                ret = inflate(&strm, Z_BLOCK);
+                totin -= strm.avail_in;
+                totout -= strm.avail_out;
+                if (ret == Z_NEED_DICT || ret == Z_DATA_ERROR ||
+                    ret == Z_MEM_ERROR)
+                        goto inflate_error;
+                /* concatenated members are read as one stream */
+                if (ret == Z_STREAM_END) {
+                        inflateReset(&strm);
+                        continue;
+                }
+                if ((strm.data_type & 128) && !(strm.data_type & 64) &&
+                    totout - last > d->span) {
+                        if (add_point(d, &cap, &strm, totin, totout, window))
+                                goto inflate_error;
+                        last = totout;
+                }
+        }
+        /* truncated file */
+        if (ret != Z_STREAM_END)
+                goto inflate_error;
+        d->size = totout;
+        inflateEnd(&strm);
+        free(in_buf);
+        free(window);
+        return 0;
+inflate_error:
+        inflateEnd(&strm);
+error:
+        free(in_buf);
+        free(window);
+        return -1;
+}
+
+int add_point(struct gz_data *d, size_t *cap, z_stream const *strm,
+              uint64_t in, uint64_t out, unsigned char const *window) {
+        if (d->points_num == *cap) {
+                *cap = *cap ? *cap * 2 : 8;
+                void *res = realloc(d->points, *cap * sizeof(struct point));
+                if (!res)
+                        return -1;
+                d->points = (struct point *)res;
+        }
+        struct point *p = &d->points[d->points_num++];
+        p->out = out;
+        p->in = in;
+        p->bits = strm->data_type & 7;
+        /* window is circular, oldest bytes start after write position */
+        size_t left = strm->avail_out;
+        memcpy(p->window, window + WINSIZE - left, left);
+        memcpy(p->window + left, window, WINSIZE - left);
+        return 0;
+}
+
+int load_index(struct gz_data *d, char const *index_name) {
+        FILE *file = fopen(index_name, "rb");
+        if (!file)
+                return -1;
+        char magic[sizeof(INDEX_MAGIC) - 1];
+        uint64_t in_size, size, num;
+        int64_t mtime;
+        if (fread(magic, sizeof(magic), 1, file) != 1 ||
+            memcmp(magic, INDEX_MAGIC, sizeof(magic)) ||
+            fread(&in_size, sizeof(in_size), 1, file) != 1 ||
+            fread(&mtime, sizeof(mtime), 1, file) != 1 ||
+            fread(&size, sizeof(size), 1, file) != 1 ||
+            fread(&num, sizeof(num), 1, file) != 1 ||
+            in_size != d->in_size || mtime != d->mtime)
+                goto error;
+        d->points = (struct point *)malloc(num * sizeof(struct point));
+        if (num && !d->points)
+                goto error;
+        for (uint64_t i = 0; i < num; ++i) {
+                struct point *p = &d->points[i];
+                if (fread(&p->out, sizeof(p->out), 1, file) != 1 ||
+                    fread(&p->in, sizeof(p->in), 1, file) != 1 ||
+                    fread(&p->bits, sizeof(p->bits), 1, file) != 1 ||
+                    fread(p->window, WINSIZE, 1, file) != 1)
+                        goto error;
+        }
+        d->points_num = num;
+        d->size = size;
+        fclose(file);
+        return 0;
+error:
+        free(d->points);
+        d->points = NULL;
+        fclose(file);
+        return -1;
+}
+
+/* index is only a cache, failed write leaves no file behind */
+void save_index(struct gz_data const *d, char const *index_name) {
+        FILE *file = fopen(index_name, "wb");
+        if (!file)
+                return;
+        uint64_t num = d->points_num;
+        int ok = fwrite(INDEX_MAGIC, sizeof(INDEX_MAGIC) - 1, 1, file) == 1 &&
+                 fwrite(&d->in_size, sizeof(d->in_size), 1, file) == 1 &&
+                 fwrite(&d->mtime, sizeof(d->mtime), 1, file) == 1 &&
+                 fwrite(&d->size, sizeof(d->size), 1, file) == 1 &&
+                 fwrite(&num, sizeof(num), 1, file) == 1;
+        for (size_t i = 0; ok && i < d->points_num; ++i) {
+                struct point const *p = &d->points[i];
+                ok = fwrite(&p->out, sizeof(p->out), 1, file) == 1 &&
+                     fwrite(&p->in, sizeof(p->in), 1, file) == 1 &&
+                     fwrite(&p->bits, sizeof(p->bits), 1, file) == 1 &&
+                     fwrite(p->window, WINSIZE, 1, file) == 1;
+        }
+        if (fclose(file) || !ok)
+                remove(index_name);
+}
+
+/* last point not after offset. NULL means start of file. */
+struct point const *find_point(struct gz_data const *d, uint64_t offset) {
+        size_t lo = 0, hi = d->points_num;
+        while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (d->points[mid].out <= offset)
+                        lo = mid + 1;
+                else
+                        hi = mid;
+        }
+        return lo ? &d->points[lo - 1] : NULL;
+}
+
+int cursor_start(struct gz_data const *d, struct cursor *c,
+                 struct point const *p) {
+        cursor_end(c);
+        memset(&c->strm, 0, sizeof(c->strm));
+        c->skip = 0;
+        if (!p) {
+                if (inflateInit2(&c->strm, 31) != Z_OK)
+                        return -1;
+                c->in = 0;
+                c->out = 0;
+                c->raw = false;
+                c->active = true;
+                return 0;
+        }
+        if (inflateInit2(&c->strm, -15) != Z_OK)
+                return -1;
+        c->active = true;
+        c->raw = true;
+        c->in = p->in;
+        c->out = p->out;
+        /* point could be in the middle of byte */
+        if (p->bits) {
+                unsigned char byte;
+                if (pread(d->fd, &byte, 1, p->in - 1) != 1)
+                        return -1;
+                inflatePrime(&c->strm, p->bits, byte >> (8 - p->bits));
+        }
+        if (inflateSetDictionary(&c->strm, p->window, WINSIZE) != Z_OK)
+                return -1;
+        return 0;
+}
+
+long long cursor_read(struct gz_data const *d, struct cursor *c, char *buf,
+                      size_t num, uint64_t offset) {
+        unsigned char discard[CHUNK];
+        while (c->out < offset + num) {
+                if (!c->strm.avail_in) {
+                        ssize_t got = pread(d->fd, c->in_buf, CHUNK, c->in);
+                        if (got == -1 && errno == EINTR)
+                                continue;
+                        if (got == -1)
+                                goto error;
+                        if (!got)
+                                break;
+                        c->in += got;
+                        c->strm.avail_in = got;
+                        c->strm.next_in = c->in_buf;
+                }
+                /* raw stream leaves gzip trailer of member unread */
+                if (c->skip) {
+                        size_t n = c->skip < c->strm.avail_in
+                                       ? c->skip
+                                       : c->strm.avail_in;
+                        c->strm.next_in += n;
+                        c->strm.avail_in -= n;
+                        c->skip -= n;
+                        if (!c->skip) {
+                                inflateReset2(&c->strm, 31);
+                                c->raw = false;
+                        }
+                        continue;
+                }
+                if (c->out < offset) {
+                        uint64_t left = offset - c->out;
+                        c->strm.next_out = discard;
+                        c->strm.avail_out = left < CHUNK ? left : CHUNK;
+                } else {
+                        uint64_t left = offset + num - c->out;
+                        c->strm.next_out =
+                            (unsigned char *)buf + (c->out - offset);
+                        c->strm.avail_out = left < CHUNK ? left : CHUNK;
+                }
+                unsigned avail = c->strm.avail_out;
+                int ret = inflate(&c->strm, Z_NO_FLUSH);
+                c->out += avail - c->strm.avail_out;
+                if (ret == Z_STREAM_END) {
+                        if (c->raw)
+                                c->skip = 8;
+                        else
+                                inflateReset(&c->strm);
+                } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                        goto error;
+                }
+        }
+        return c->out > offset ? c->out - offset : 0;
+error:
+        /* state is unknown, next read starts from point */
+        cursor_end(c);
+        return -1;
+}
+
+void cursor_end(struct cursor *c) {
+        if (c->active)
+                inflateEnd(&c->strm);
+        c->active = false;
+}
+
+#else
+
+SeisSegyBackend *seis_segy_backend_gzip_new(char const *file_name,
+                                            char const *index_name,
+                                            size_t span) {
+        (void)file_name;
+        (void)index_name;
+        (void)span;
+        return NULL;
+}
+
+#endif /* SEIS_SEGY_HAVE_ZLIB */
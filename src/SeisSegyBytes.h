@@ -0,0 +1,101 @@
+#ifndef SEIS_SEGY_BYTES
+#define SEIS_SEGY_BYTES
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Byte order helpers shared by sample converters and trace header codecs.
+ * Accessors read and write one value at unaligned buffer, ones with _sw
+ * suffix do it in byte order opposite to host. Integers go through
+ * long long and IEEE values through double, so every accessor of kind has
+ * same signature and can be picked by pointer. */
+
+static inline uint8_t bswap8(uint8_t v) { return v; }
+
+static inline uint16_t bswap16(uint16_t v) {
+        return (uint16_t)(v << 8 | v >> 8);
+}
+
+static inline uint32_t bswap32(uint32_t v) {
+        return v << 24 | (v & 0xff00) << 8 | (v & 0xff0000) >> 8 | v >> 24;
+}
+
+static inline uint64_t bswap64(uint64_t v) {
+        return (uint64_t)bswap32((uint32_t)v) << 32 | bswap32(v >> 32);
+}
+
+/* true if host stores least significant byte first */
+static inline bool host_is_little_endian(void) {
+        uint16_t one = 1;
+        char first;
+        memcpy(&first, &one, sizeof(first));
+        return first;
+}
+
+/* accessors of integer field of type stored as utype bits */
+#define DEF_INT_ACCESSORS(name, type, utype, swap)                             \
+        static inline long long get_##name(char const *buf) {                  \
+                type val;                                                      \
+                memcpy(&val, buf, sizeof(val));                                \
+                return (long long)val;                                         \
+        }                                                                      \
+        static inline long long get_##name##_sw(char const *buf) {             \
+                utype bits;                                                    \
+                type val;                                                      \
+                memcpy(&bits, buf, sizeof(bits));                              \
+                bits = swap(bits);                                             \
+                memcpy(&val, &bits, sizeof(val));                              \
+                return (long long)val;                                         \
+        }                                                                      \
+        static inline void put_##name(char *buf, long long val) {              \
+                type tmp = (type)val;                                          \
+                memcpy(buf, &tmp, sizeof(tmp));                                \
+        }                                                                      \
+        static inline void put_##name##_sw(char *buf, long long val) {         \
+                type tmp = (type)val;                                          \
+                utype bits;                                                    \
+                memcpy(&bits, &tmp, sizeof(bits));                             \
+                bits = swap(bits);                                             \
+                memcpy(buf, &bits, sizeof(bits));                              \
+        }
+
+/* accessors of IEEE field, host floats are IEEE as in sample converters */
+#define DEF_REAL_ACCESSORS(name, type, utype, swap)                            \
+        static inline double get_##name(char const *buf) {                     \
+                type val;                                                      \
+                memcpy(&val, buf, sizeof(val));                                \
+                return val;                                                    \
+        }                                                                      \
+        static inline double get_##name##_sw(char const *buf) {                \
+                utype bits;                                                    \
+                type val;                                                      \
+                memcpy(&bits, buf, sizeof(bits));                              \
+                bits = swap(bits);                                             \
+                memcpy(&val, &bits, sizeof(val));                              \
+                return val;                                                    \
+        }                                                                      \
+        static inline void put_##name(char *buf, double val) {                 \
+                type tmp = (type)val;                                          \
+                memcpy(buf, &tmp, sizeof(tmp));                                \
+        }                                                                      \
+        static inline void put_##name##_sw(char *buf, double val) {            \
+                type tmp = (type)val;                                          \
+                utype bits;                                                    \
+                memcpy(&bits, &tmp, sizeof(bits));                             \
+                bits = swap(bits);                                             \
+                memcpy(buf, &bits, sizeof(bits));                              \
+        }
+
+DEF_INT_ACCESSORS(i8, int8_t, uint8_t, bswap8)
+DEF_INT_ACCESSORS(u8, uint8_t, uint8_t, bswap8)
+DEF_INT_ACCESSORS(i16, int16_t, uint16_t, bswap16)
+DEF_INT_ACCESSORS(u16, uint16_t, uint16_t, bswap16)
+DEF_INT_ACCESSORS(i32, int32_t, uint32_t, bswap32)
+DEF_INT_ACCESSORS(u32, uint32_t, uint32_t, bswap32)
+DEF_INT_ACCESSORS(i64, int64_t, uint64_t, bswap64)
+DEF_INT_ACCESSORS(u64, uint64_t, uint64_t, bswap64)
+DEF_REAL_ACCESSORS(f32, float, uint32_t, bswap32)
+DEF_REAL_ACCESSORS(f64, double, uint64_t, bswap64)
+
+#endif
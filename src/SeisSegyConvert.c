@@ -0,0 +1,882 @@
+#include "SeisSegyConvert.h"
+#include "SeisSegyBytes.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SEIS_SEGY_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+/* IBM float is fraction * 16^(exp - 64) with 24 bit fraction. As double it
+ * is (double)fraction * 2^(4 * exp - 280). Scale is always normal double,
+ * so its bits are built directly: biased exponent is 4 * exp + 743. Sign
+ * is copied to keep negative zero. */
+#define IBM_EXP_BIAS 743
+
+/* IBM floats are narrowed to float through stack buffer of this size */
+#define IBM_CHUNK 256
+
+/* Encoding takes biggest 4 * (exp - 64) above binary exponent of value.
+ * From biased double exponent e it is exp = floor((e - 1023) / 4) + 65,
+ * computed without negative shifts as (e + 1) / 4 - 191. Value is scaled
+ * to fraction by 2^(280 - 4 * exp), biased exponent of scale is
+ * 1303 - 4 * exp. Adding and subtracting 2^52 rounds fraction to nearest
+ * even in default rounding mode. */
+#define IBM_ENC_EXP_BIAS 191
+#define IBM_ENC_SCALE_BIAS 1303
+#define IBM_ENC_ROUND 0x1p52
+#define IBM_MAX 0x7fffffff
+
+static int find_converters(int format_code, bool *swap);
+static int find_encoders(int format_code, bool *swap);
+static bool host_swap(int format_code, bool swap);
+static double round_even(double v);
+static uint32_t fixp_from_double(double val);
+static void ibm_to_float(float *dst, char const *src, size_t num, bool swap);
+static void float_to_ibm(char *dst, float const *src, size_t num, bool swap);
+static void ibm_scalar(double *dst, char const *src, size_t num, bool swap);
+static void ibm_enc_scalar(char *dst, double const *src, size_t num,
+                           bool swap);
+#ifdef SEIS_SEGY_X86_KERNELS
+static void ibm_sse2(double *dst, char const *src, size_t num, bool swap);
+static void ibm_avx2(double *dst, char const *src, size_t num, bool swap);
+static void ibm_avx512(double *dst, char const *src, size_t num, bool swap);
+static void ibm_enc_sse2(char *dst, double const *src, size_t num,
+                         bool swap);
+static void ibm_enc_avx2(char *dst, double const *src, size_t num,
+                         bool swap);
+#endif
+
+/* one loop per format, byte order and output type with no calls inside.
+ * Values are loaded with memcpy, compilers turn it into unaligned loads and
+ * vectorize loop. */
+#define NO_SWAP(v) (v)
+
+#define DEF_CONVERTER(name, out, type, utype, swap_func)                      \
+        static void name(out *dst, char const *src, size_t num) {             \
+                for (size_t i = 0; i < num; ++i) {                            \
+                        utype v;                                              \
+                        memcpy(&v, src + i * sizeof(v), sizeof(v));           \
+                        v = swap_func(v);                                     \
+                        type res;                                             \
+                        memcpy(&res, &v, sizeof(res));                        \
+                        dst[i] = (out)res;                                    \
+                }                                                             \
+        }
+
+#define DEF_CONVERTERS(name, type, utype, swap_func)                          \
+        DEF_CONVERTER(name##_native, double, type, utype, NO_SWAP)            \
+        DEF_CONVERTER(name##_swap, double, type, utype, swap_func)            \
+        DEF_CONVERTER(name##_native_f, float, type, utype, NO_SWAP)           \
+        DEF_CONVERTER(name##_swap_f, float, type, utype, swap_func)
+
+DEF_CONVERTERS(i16, int16_t, uint16_t, bswap16)
+DEF_CONVERTERS(u16, uint16_t, uint16_t, bswap16)
+DEF_CONVERTERS(i32, int32_t, uint32_t, bswap32)
+DEF_CONVERTERS(u32, uint32_t, uint32_t, bswap32)
+DEF_CONVERTERS(i64, int64_t, uint64_t, bswap64)
+DEF_CONVERTERS(u64, uint64_t, uint64_t, bswap64)
+DEF_CONVERTERS(f32, float, uint32_t, bswap32)
+DEF_CONVERTERS(f64, double, uint64_t, bswap64)
+
+/* 3 byte values are assembled from bytes and sign extended */
+#define DEF_BYTE_CONVERTERS(suffix, out)                                      \
+        static void i8_native##suffix(out *dst, char const *src,              \
+                                      size_t num) {                           \
+                for (size_t i = 0; i < num; ++i)                              \
+                        dst[i] = (int8_t)src[i];                              \
+        }                                                                     \
+        static void u8_native##suffix(out *dst, char const *src,              \
+                                      size_t num) {                           \
+                for (size_t i = 0; i < num; ++i)                              \
+                        dst[i] = (uint8_t)src[i];                             \
+        }                                                                     \
+        static void i24_le##suffix(out *dst, char const *src, size_t num) {   \
+                unsigned char const *p = (unsigned char const *)src;          \
+                for (size_t i = 0; i < num; ++i, p += 3) {                    \
+                        int32_t v = (int32_t)(p[2] << 16 | p[1] << 8 | p[0]); \
+                        dst[i] = (out)((v ^ 0x800000) - 0x800000);            \
+                }                                                             \
+        }                                                                     \
+        static void i24_be##suffix(out *dst, char const *src, size_t num) {   \
+                unsigned char const *p = (unsigned char const *)src;          \
+                for (size_t i = 0; i < num; ++i, p += 3) {                    \
+                        int32_t v = (int32_t)(p[0] << 16 | p[1] << 8 | p[2]); \
+                        dst[i] = (out)((v ^ 0x800000) - 0x800000);            \
+                }                                                             \
+        }                                                                     \
+        static void u24_le##suffix(out *dst, char const *src, size_t num) {   \
+                unsigned char const *p = (unsigned char const *)src;          \
+                for (size_t i = 0; i < num; ++i, p += 3)                      \
+                        dst[i] = (out)(p[2] << 16 | p[1] << 8 | p[0]);        \
+        }                                                                     \
+        static void u24_be##suffix(out *dst, char const *src, size_t num) {   \
+                unsigned char const *p = (unsigned char const *)src;          \
+                for (size_t i = 0; i < num; ++i, p += 3)                      \
+                        dst[i] = (out)(p[0] << 16 | p[1] << 8 | p[2]);        \
+        }
+
+DEF_BYTE_CONVERTERS(, double)
+DEF_BYTE_CONVERTERS(_f, float)
+
+/* fixed point with gain is mantissa * 2^-gain, gain is second byte and
+ * mantissa is low half of big endian word. Scale is built from bits as for
+ * IBM floats, product is exact in double. */
+#define DEF_FIXP_CONVERTER(name, out, swap_func)                              \
+        static void name(out *dst, char const *src, size_t num) {             \
+                for (size_t i = 0; i < num; ++i) {                            \
+                        uint32_t w;                                           \
+                        memcpy(&w, src + i * sizeof(w), sizeof(w));           \
+                        w = swap_func(w);                                     \
+                        uint64_t scale_bits = (uint64_t)(1023 - (w >> 16 &    \
+                                                                 0xff))       \
+                                              << 52;                          \
+                        double scale;                                         \
+                        memcpy(&scale, &scale_bits, sizeof(scale));           \
+                        dst[i] = (out)((int16_t)(w & 0xffff) * scale);        \
+                }                                                             \
+        }
+
+DEF_FIXP_CONVERTER(fixp_native, double, NO_SWAP)
+DEF_FIXP_CONVERTER(fixp_swap, double, bswap32)
+DEF_FIXP_CONVERTER(fixp_native_f, float, NO_SWAP)
+DEF_FIXP_CONVERTER(fixp_swap_f, float, bswap32)
+
+static void ibm_native(double *dst, char const *src, size_t num) {
+        seis_segy_ibm_to_double(dst, src, num, false);
+}
+
+static void ibm_swap(double *dst, char const *src, size_t num) {
+        seis_segy_ibm_to_double(dst, src, num, true);
+}
+
+static void ibm_native_f(float *dst, char const *src, size_t num) {
+        ibm_to_float(dst, src, num, false);
+}
+
+static void ibm_swap_f(float *dst, char const *src, size_t num) {
+        ibm_to_float(dst, src, num, true);
+}
+
+static struct {
+        int format_code;
+        SeisSegyConvertFunc native, swap;
+        SeisSegyConvertFloatFunc native_f, swap_f;
+} const converters[] = {
+    {1, ibm_native, ibm_swap, ibm_native_f, ibm_swap_f},
+    {2, i32_native, i32_swap, i32_native_f, i32_swap_f},
+    {3, i16_native, i16_swap, i16_native_f, i16_swap_f},
+    {4, fixp_native, fixp_swap, fixp_native_f, fixp_swap_f},
+    {5, f32_native, f32_swap, f32_native_f, f32_swap_f},
+    {6, f64_native, f64_swap, f64_native_f, f64_swap_f},
+    {7, i24_le, i24_be, i24_le_f, i24_be_f},
+    {8, i8_native, i8_native, i8_native_f, i8_native_f},
+    {9, i64_native, i64_swap, i64_native_f, i64_swap_f},
+    {10, u32_native, u32_swap, u32_native_f, u32_swap_f},
+    {11, u16_native, u16_swap, u16_native_f, u16_swap_f},
+    {12, u64_native, u64_swap, u64_native_f, u64_swap_f},
+    {15, u24_le, u24_be, u24_le_f, u24_be_f},
+    {16, u8_native, u8_native, u8_native_f, u8_native_f}};
+
+/* encoders mirror converters. Integers are rounded to nearest even and
+ * saturated to range of type, NaN becomes zero. Value is clamped in
+ * floating point before conversion, so conversion is always defined.
+ * Upper bound is exclusive: max + 1 is power of two and exact in double,
+ * for 64 bit types max is rounded up to it by conversion. Quiet
+ * comparisons don't raise exceptions on NaN, so compiler turns them into
+ * selects and vectorizes loop. */
+#define DEF_INT_ENCODER(name, in, type, utype, tmin, tmax, swap_func)        \
+        static void name(char *dst, in const *src, size_t num) {              \
+                for (size_t i = 0; i < num; ++i) {                            \
+                        double r = round_even(src[i]);                        \
+                        int over = isgreaterequal(r, (double)(tmax) + 1.0);   \
+                        double c = over                        ? 0            \
+                                   : isless(r, (double)(tmin)) ? (tmin)       \
+                                   : isunordered(r, r)         ? 0            \
+                                                               : r;           \
+                        type res = (type)c;                                   \
+                        res = over ? (tmax) : res;                            \
+                        utype v;                                              \
+                        memcpy(&v, &res, sizeof(v));                          \
+                        v = swap_func(v);                                     \
+                        memcpy(dst + i * sizeof(v), &v, sizeof(v));           \
+                }                                                             \
+        }
+
+#define DEF_INT_ENCODERS(name, type, utype, tmin, tmax, swap_func)            \
+        DEF_INT_ENCODER(name##_enc_native, double, type, utype, tmin, tmax,   \
+                        NO_SWAP)                                              \
+        DEF_INT_ENCODER(name##_enc_swap, double, type, utype, tmin, tmax,     \
+                        swap_func)                                            \
+        DEF_INT_ENCODER(name##_enc_native_f, float, type, utype, tmin, tmax,  \
+                        NO_SWAP)                                              \
+        DEF_INT_ENCODER(name##_enc_swap_f, float, type, utype, tmin, tmax,    \
+                        swap_func)
+
+DEF_INT_ENCODER(i8_enc_native, double, int8_t, uint8_t, INT8_MIN, INT8_MAX,
+                NO_SWAP)
+DEF_INT_ENCODER(i8_enc_native_f, float, int8_t, uint8_t, INT8_MIN, INT8_MAX,
+                NO_SWAP)
+DEF_INT_ENCODER(u8_enc_native, double, uint8_t, uint8_t, 0, UINT8_MAX,
+                NO_SWAP)
+DEF_INT_ENCODER(u8_enc_native_f, float, uint8_t, uint8_t, 0, UINT8_MAX,
+                NO_SWAP)
+DEF_INT_ENCODERS(i16, int16_t, uint16_t, INT16_MIN, INT16_MAX, bswap16)
+DEF_INT_ENCODERS(u16, uint16_t, uint16_t, 0, UINT16_MAX, bswap16)
+DEF_INT_ENCODERS(i32, int32_t, uint32_t, INT32_MIN, INT32_MAX, bswap32)
+DEF_INT_ENCODERS(u32, uint32_t, uint32_t, 0, UINT32_MAX, bswap32)
+DEF_INT_ENCODERS(i64, int64_t, uint64_t, INT64_MIN, INT64_MAX, bswap64)
+DEF_INT_ENCODERS(u64, uint64_t, uint64_t, 0, UINT64_MAX, bswap64)
+
+/* 3 byte values are saturated as doubles, their bounds are exact */
+#define DEF_24_ENCODER(name, in, type, tmin, tmax, b0, b1, b2)               \
+        static void name(char *dst, in const *src, size_t num) {              \
+                unsigned char *p = (unsigned char *)dst;                      \
+                for (size_t i = 0; i < num; ++i, p += 3) {                    \
+                        double r = round_even(src[i]);                        \
+                        double c = isgreater(r, (tmax)) ? (tmax)              \
+                                   : isless(r, (tmin))  ? (tmin)              \
+                                   : isunordered(r, r)  ? 0                   \
+                                                        : r;                  \
+                        uint32_t v = (uint32_t)(type)c;                       \
+                        p[b0] = (unsigned char)v;                             \
+                        p[b1] = (unsigned char)(v >> 8);                      \
+                        p[b2] = (unsigned char)(v >> 16);                     \
+                }                                                             \
+        }
+
+#define DEF_24_ENCODERS(name, type, tmin, tmax)                               \
+        DEF_24_ENCODER(name##_enc_le, double, type, tmin, tmax, 0, 1, 2)      \
+        DEF_24_ENCODER(name##_enc_be, double, type, tmin, tmax, 2, 1, 0)      \
+        DEF_24_ENCODER(name##_enc_le_f, float, type, tmin, tmax, 0, 1, 2)     \
+        DEF_24_ENCODER(name##_enc_be_f, float, type, tmin, tmax, 2, 1, 0)
+
+DEF_24_ENCODERS(i24, int32_t, -0x800000, 0x7fffff)
+DEF_24_ENCODERS(u24, uint32_t, 0, 0xffffff)
+
+/* narrowing to float rounds to nearest even, overflow gives infinity */
+#define DEF_FLOAT_ENCODER(name, in, type, utype, swap_func)                  \
+        static void name(char *dst, in const *src, size_t num) {              \
+                for (size_t i = 0; i < num; ++i) {                            \
+                        type res = (type)src[i];                              \
+                        utype v;                                              \
+                        memcpy(&v, &res, sizeof(v));                          \
+                        v = swap_func(v);                                     \
+                        memcpy(dst + i * sizeof(v), &v, sizeof(v));           \
+                }                                                             \
+        }
+
+#define DEF_FLOAT_ENCODERS(name, type, utype, swap_func)                      \
+        DEF_FLOAT_ENCODER(name##_enc_native, double, type, utype, NO_SWAP)    \
+        DEF_FLOAT_ENCODER(name##_enc_swap, double, type, utype, swap_func)    \
+        DEF_FLOAT_ENCODER(name##_enc_native_f, float, type, utype, NO_SWAP)   \
+        DEF_FLOAT_ENCODER(name##_enc_swap_f, float, type, utype, swap_func)
+
+DEF_FLOAT_ENCODERS(f32, float, uint32_t, bswap32)
+DEF_FLOAT_ENCODERS(f64, double, uint64_t, bswap64)
+
+#define DEF_FIXP_ENCODER(name, in, swap_func)                                 \
+        static void name(char *dst, in const *src, size_t num) {              \
+                for (size_t i = 0; i < num; ++i) {                            \
+                        uint32_t v = swap_func(fixp_from_double(src[i]));     \
+                        memcpy(dst + i * sizeof(v), &v, sizeof(v));           \
+                }                                                             \
+        }
+
+DEF_FIXP_ENCODER(fixp_enc_native, double, NO_SWAP)
+DEF_FIXP_ENCODER(fixp_enc_swap, double, bswap32)
+DEF_FIXP_ENCODER(fixp_enc_native_f, float, NO_SWAP)
+DEF_FIXP_ENCODER(fixp_enc_swap_f, float, bswap32)
+
+static void ibm_enc_native(char *dst, double const *src, size_t num) {
+        seis_segy_double_to_ibm(dst, src, num, false);
+}
+
+static void ibm_enc_swap(char *dst, double const *src, size_t num) {
+        seis_segy_double_to_ibm(dst, src, num, true);
+}
+
+static void ibm_enc_native_f(char *dst, float const *src, size_t num) {
+        float_to_ibm(dst, src, num, false);
+}
+
+static void ibm_enc_swap_f(char *dst, float const *src, size_t num) {
+        float_to_ibm(dst, src, num, true);
+}
+
+static struct {
+        int format_code;
+        SeisSegyEncodeFunc native, swap;
+        SeisSegyEncodeFloatFunc native_f, swap_f;
+} const encoders[] = {
+    {1, ibm_enc_native, ibm_enc_swap, ibm_enc_native_f, ibm_enc_swap_f},
+    {2, i32_enc_native, i32_enc_swap, i32_enc_native_f, i32_enc_swap_f},
+    {3, i16_enc_native, i16_enc_swap, i16_enc_native_f, i16_enc_swap_f},
+    {4, fixp_enc_native, fixp_enc_swap, fixp_enc_native_f, fixp_enc_swap_f},
+    {5, f32_enc_native, f32_enc_swap, f32_enc_native_f, f32_enc_swap_f},
+    {6, f64_enc_native, f64_enc_swap, f64_enc_native_f, f64_enc_swap_f},
+    {7, i24_enc_le, i24_enc_be, i24_enc_le_f, i24_enc_be_f},
+    {8, i8_enc_native, i8_enc_native, i8_enc_native_f, i8_enc_native_f},
+    {9, i64_enc_native, i64_enc_swap, i64_enc_native_f, i64_enc_swap_f},
+    {10, u32_enc_native, u32_enc_swap, u32_enc_native_f, u32_enc_swap_f},
+    {11, u16_enc_native, u16_enc_swap, u16_enc_native_f, u16_enc_swap_f},
+    {12, u64_enc_native, u64_enc_swap, u64_enc_native_f, u64_enc_swap_f},
+    {15, u24_enc_le, u24_enc_be, u24_enc_le_f, u24_enc_be_f},
+    {16, u8_enc_native, u8_enc_native, u8_enc_native_f, u8_enc_native_f}};
+
+SeisSegyConvertFunc seis_segy_get_converter(int format_code, bool swap) {
+        int idx = find_converters(format_code, &swap);
+        if (idx < 0)
+                return NULL;
+        return swap ? converters[idx].swap : converters[idx].native;
+}
+
+SeisSegyConvertFloatFunc seis_segy_get_float_converter(int format_code,
+                                                       bool swap) {
+        int idx = find_converters(format_code, &swap);
+        if (idx < 0)
+                return NULL;
+        return swap ? converters[idx].swap_f : converters[idx].native_f;
+}
+
+void seis_segy_ibm_to_double(double *dst, char const *src, size_t num,
+                             bool swap) {
+#ifdef SEIS_SEGY_X86_KERNELS
+        if (__builtin_cpu_supports("avx512f"))
+                ibm_avx512(dst, src, num, swap);
+        else if (__builtin_cpu_supports("avx2"))
+                ibm_avx2(dst, src, num, swap);
+        else
+                ibm_sse2(dst, src, num, swap);
+#else
+        ibm_scalar(dst, src, num, swap);
+#endif
+}
+
+SeisSegyEncodeFunc seis_segy_get_encoder(int format_code, bool swap) {
+        int idx = find_encoders(format_code, &swap);
+        if (idx < 0)
+                return NULL;
+        return swap ? encoders[idx].swap : encoders[idx].native;
+}
+
+SeisSegyEncodeFloatFunc seis_segy_get_float_encoder(int format_code,
+                                                    bool swap) {
+        int idx = find_encoders(format_code, &swap);
+        if (idx < 0)
+                return NULL;
+        return swap ? encoders[idx].swap_f : encoders[idx].native_f;
+}
+
+void seis_segy_double_to_ibm(char *dst, double const *src, size_t num,
+                             bool swap) {
+#ifdef SEIS_SEGY_X86_KERNELS
+        if (__builtin_cpu_supports("avx2"))
+                ibm_enc_avx2(dst, src, num, swap);
+        else
+                ibm_enc_sse2(dst, src, num, swap);
+#else
+        ibm_enc_scalar(dst, src, num, swap);
+#endif
+}
+
+bool seis_segy_ibm_to_double_kernel(SeisSegyKernel kernel, double *dst,
+                                    char const *src, size_t num, bool swap) {
+        switch (kernel) {
+        case SEIS_SEGY_KERNEL_SCALAR:
+                ibm_scalar(dst, src, num, swap);
+                return true;
+#ifdef SEIS_SEGY_X86_KERNELS
+        case SEIS_SEGY_KERNEL_SSE2:
+                ibm_sse2(dst, src, num, swap);
+                return true;
+        case SEIS_SEGY_KERNEL_AVX2:
+                if (!__builtin_cpu_supports("avx2"))
+                        return false;
+                ibm_avx2(dst, src, num, swap);
+                return true;
+        case SEIS_SEGY_KERNEL_AVX512:
+                if (!__builtin_cpu_supports("avx512f"))
+                        return false;
+                ibm_avx512(dst, src, num, swap);
+                return true;
+#endif
+        default:
+                return false;
+        }
+}
+
+bool seis_segy_double_to_ibm_kernel(SeisSegyKernel kernel, char *dst,
+                                    double const *src, size_t num, bool swap) {
+        switch (kernel) {
+        case SEIS_SEGY_KERNEL_SCALAR:
+                ibm_enc_scalar(dst, src, num, swap);
+                return true;
+#ifdef SEIS_SEGY_X86_KERNELS
+        case SEIS_SEGY_KERNEL_SSE2:
+                ibm_enc_sse2(dst, src, num, swap);
+                return true;
+        case SEIS_SEGY_KERNEL_AVX2:
+                if (!__builtin_cpu_supports("avx2"))
+                        return false;
+                ibm_enc_avx2(dst, src, num, swap);
+                return true;
+#endif
+        default:
+                return false;
+        }
+}
+
+int find_converters(int format_code, bool *swap) {
+        *swap = host_swap(format_code, *swap);
+        for (size_t i = 0; i < sizeof(converters) / sizeof(converters[0]); ++i)
+                if (converters[i].format_code == format_code)
+                        return (int)i;
+        return -1;
+}
+
+int find_encoders(int format_code, bool *swap) {
+        *swap = host_swap(format_code, *swap);
+        for (size_t i = 0; i < sizeof(encoders) / sizeof(encoders[0]); ++i)
+                if (encoders[i].format_code == format_code)
+                        return (int)i;
+        return -1;
+}
+
+/* 3 byte converters and encoders are listed for little endian host */
+bool host_swap(int format_code, bool swap) {
+        if (!host_is_little_endian() && (format_code == 7 || format_code == 15))
+                return !swap;
+        return swap;
+}
+
+/* adding and subtracting 2^52 rounds to nearest even in default rounding
+ * mode. Values from 2^52 up are integers already and get zero. Selecting
+ * constant keeps arithmetic unconditional for vectorizer. */
+double round_even(double v) {
+        double magic = copysign(isless(fabs(v), 0x1p52) ? 0x1p52 : 0, v);
+        return v + magic - magic;
+}
+
+/* biggest gain that keeps mantissa in 16 bits gives best precision. Gain
+ * is found from exponent bits, |val| < 2^(exp - 1022). Scaled value rounds
+ * to 2^15 from 32767.5 up, then gain is one less. Carry is found before
+ * rounding and results are picked with selects, so loop over samples has
+ * no branches and is vectorized. NaN gives zero mantissa. */
+uint32_t fixp_from_double(double val) {
+        uint64_t bits;
+        memcpy(&bits, &val, sizeof(bits));
+        int32_t exp = (int32_t)(bits >> 52 & 0x7ff);
+        /* zeros and subnormals get biggest gain by clamping */
+        int32_t gain = 1037 - exp;
+        gain = gain < 0 ? 0 : gain > 255 ? 255 : gain;
+        uint64_t scale_bits = (uint64_t)(1023 + gain) << 52;
+        double scale;
+        memcpy(&scale, &scale_bits, sizeof(scale));
+        gain -= isgreaterequal(fabs(val * scale), 32767.5) & (gain != 0);
+        scale_bits = (uint64_t)(1023 + gain) << 52;
+        memcpy(&scale, &scale_bits, sizeof(scale));
+        double mant = round_even(val * scale);
+        mant = isgreater(mant, 32767)   ? 32767
+               : isless(mant, -32768)   ? -32768
+               : isunordered(mant, mant) ? 0
+                                         : mant;
+        return (uint32_t)gain << 16 | (uint16_t)(int32_t)mant;
+}
+
+/* every IBM float is exact in double, so single rounding happens at
+ * narrowing */
+void ibm_to_float(float *dst, char const *src, size_t num, bool swap) {
+        double tmp[IBM_CHUNK];
+        while (num) {
+                size_t n = num < IBM_CHUNK ? num : IBM_CHUNK;
+                seis_segy_ibm_to_double(tmp, src, n, swap);
+                for (size_t i = 0; i < n; ++i)
+                        dst[i] = (float)tmp[i];
+                dst += n;
+                src += n * sizeof(uint32_t);
+                num -= n;
+        }
+}
+
+/* float to double is exact, so result is the same as for doubles */
+void float_to_ibm(char *dst, float const *src, size_t num, bool swap) {
+        double tmp[IBM_CHUNK];
+        while (num) {
+                size_t n = num < IBM_CHUNK ? num : IBM_CHUNK;
+                for (size_t i = 0; i < n; ++i)
+                        tmp[i] = src[i];
+                seis_segy_double_to_ibm(dst, tmp, n, swap);
+                dst += n * sizeof(uint32_t);
+                src += n;
+                num -= n;
+        }
+}
+
+void ibm_scalar(double *dst, char const *src, size_t num, bool swap) {
+        for (size_t i = 0; i < num; ++i) {
+                uint32_t ibm;
+                memcpy(&ibm, src + i * sizeof(ibm), sizeof(ibm));
+                if (swap)
+                        ibm = bswap32(ibm);
+                uint64_t scale_bits = (uint64_t)((ibm >> 24 & 0x7f) * 4 +
+                                                 IBM_EXP_BIAS)
+                                      << 52;
+                double scale;
+                memcpy(&scale, &scale_bits, sizeof(scale));
+                double res = (double)(int32_t)(ibm & 0x00ffffff) * scale;
+                uint64_t bits;
+                memcpy(&bits, &res, sizeof(bits));
+                bits |= (uint64_t)(ibm >> 31) << 63;
+                memcpy(dst + i, &bits, sizeof(bits));
+        }
+}
+
+/* NaN becomes zero, infinity and values above biggest IBM float are
+ * clamped to it. Values below smallest normalized IBM float underflow
+ * gradually: exponent is clamped to zero and fraction is left unnormalized,
+ * losing precision until values below about 16^-70 round to signed zero. */
+void ibm_enc_scalar(char *dst, double const *src, size_t num, bool swap) {
+        for (size_t i = 0; i < num; ++i) {
+                uint64_t bits;
+                memcpy(&bits, src + i, sizeof(bits));
+                uint32_t sign = (uint32_t)(bits >> 32) & 0x80000000;
+                bits &= ~(1ull << 63);
+                int32_t exp = (int32_t)((bits >> 52) + 1) / 4 -
+                              IBM_ENC_EXP_BIAS;
+                uint32_t ibm;
+                if (bits > 0x7ff0000000000000) {
+                        ibm = 0;
+                } else if (exp > 127) {
+                        ibm = sign | IBM_MAX;
+                } else {
+                        if (exp < 0)
+                                exp = 0;
+                        uint64_t scale_bits =
+                            (uint64_t)(IBM_ENC_SCALE_BIAS - 4 * exp) << 52;
+                        double val, scale;
+                        memcpy(&val, &bits, sizeof(val));
+                        memcpy(&scale, &scale_bits, sizeof(scale));
+                        uint32_t frac =
+                            (uint32_t)(val * scale + IBM_ENC_ROUND -
+                                       IBM_ENC_ROUND);
+                        /* rounding could carry to next hex digit. Clamped
+                         * exponent gives fraction below 2^20, so zero is
+                         * written with zero exponent. */
+                        if (frac == 1u << 24) {
+                                frac = 1u << 20;
+                                ++exp;
+                        }
+                        if (exp > 127)
+                                ibm = sign | IBM_MAX;
+                        else
+                                ibm = sign | (uint32_t)exp << 24 | frac;
+                }
+                if (swap)
+                        ibm = bswap32(ibm);
+                memcpy(dst + i * sizeof(ibm), &ibm, sizeof(ibm));
+        }
+}
+
+#ifdef SEIS_SEGY_X86_KERNELS
+
+/* SSE2 has no byte shuffle, bytes are swapped inside 16 bit words and then
+ * words are swapped */
+__attribute__((target("sse2"))) static __m128i sse2_bswap32(__m128i v) {
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflelo_epi16(v, 0xb1);
+        return _mm_shufflehi_epi16(v, 0xb1);
+}
+
+/* converts two values from low half of fraction, scale and sign vectors */
+__attribute__((target("sse2"))) static __m128d
+sse2_ibm_pair(__m128i frac, __m128i exp, __m128i sign) {
+        __m128i zero = _mm_setzero_si128();
+        __m128d scale = _mm_castsi128_pd(
+            _mm_slli_epi64(_mm_unpacklo_epi32(exp, zero), 52));
+        __m128d res = _mm_mul_pd(_mm_cvtepi32_pd(frac), scale);
+        __m128d sbit = _mm_castsi128_pd(_mm_unpacklo_epi32(zero, sign));
+        return _mm_or_pd(res, sbit);
+}
+
+__attribute__((target("sse2"))) void ibm_sse2(double *dst, char const *src,
+                                              size_t num, bool swap) {
+        __m128i const frac_mask = _mm_set1_epi32(0x00ffffff);
+        __m128i const exp_mask = _mm_set1_epi32(0x7f);
+        __m128i const sign_mask = _mm_set1_epi32((int)0x80000000);
+        __m128i const bias = _mm_set1_epi32(IBM_EXP_BIAS);
+        size_t i = 0;
+        for (; i + 4 <= num; i += 4) {
+                __m128i v = _mm_loadu_si128((__m128i const *)(src + i * 4));
+                if (swap)
+                        v = sse2_bswap32(v);
+                __m128i frac = _mm_and_si128(v, frac_mask);
+                __m128i exp = _mm_add_epi32(
+                    _mm_slli_epi32(
+                        _mm_and_si128(_mm_srli_epi32(v, 24), exp_mask), 2),
+                    bias);
+                __m128i sign = _mm_and_si128(v, sign_mask);
+                _mm_storeu_pd(dst + i, sse2_ibm_pair(frac, exp, sign));
+                _mm_storeu_pd(dst + i + 2,
+                              sse2_ibm_pair(_mm_srli_si128(frac, 8),
+                                            _mm_srli_si128(exp, 8),
+                                            _mm_srli_si128(sign, 8)));
+        }
+        ibm_scalar(dst + i, src + i * 4, num - i, swap);
+}
+
+/* converts four values */
+__attribute__((target("avx2"))) static __m256d
+avx2_ibm_quad(__m128i frac, __m128i exp, __m128i sign) {
+        __m256d scale =
+            _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_cvtepu32_epi64(exp),
+                                                  52));
+        __m256d res = _mm256_mul_pd(_mm256_cvtepi32_pd(frac), scale);
+        __m256d sbit = _mm256_castsi256_pd(
+            _mm256_slli_epi64(_mm256_cvtepu32_epi64(sign), 32));
+        return _mm256_or_pd(res, sbit);
+}
+
+__attribute__((target("avx2"))) void ibm_avx2(double *dst, char const *src,
+                                              size_t num, bool swap) {
+        __m256i const shuffle = _mm256_setr_epi8(
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0,
+            7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        __m256i const frac_mask = _mm256_set1_epi32(0x00ffffff);
+        __m256i const exp_mask = _mm256_set1_epi32(0x7f);
+        __m256i const sign_mask = _mm256_set1_epi32((int)0x80000000);
+        __m256i const bias = _mm256_set1_epi32(IBM_EXP_BIAS);
+        size_t i = 0;
+        for (; i + 8 <= num; i += 8) {
+                __m256i v =
+                    _mm256_loadu_si256((__m256i const *)(src + i * 4));
+                if (swap)
+                        v = _mm256_shuffle_epi8(v, shuffle);
+                __m256i frac = _mm256_and_si256(v, frac_mask);
+                __m256i exp = _mm256_add_epi32(
+                    _mm256_slli_epi32(
+                        _mm256_and_si256(_mm256_srli_epi32(v, 24), exp_mask),
+                        2),
+                    bias);
+                __m256i sign = _mm256_and_si256(v, sign_mask);
+                _mm256_storeu_pd(dst + i,
+                                 avx2_ibm_quad(_mm256_castsi256_si128(frac),
+                                               _mm256_castsi256_si128(exp),
+                                               _mm256_castsi256_si128(sign)));
+                _mm256_storeu_pd(
+                    dst + i + 4,
+                    avx2_ibm_quad(_mm256_extracti128_si256(frac, 1),
+                                  _mm256_extracti128_si256(exp, 1),
+                                  _mm256_extracti128_si256(sign, 1)));
+        }
+        ibm_scalar(dst + i, src + i * 4, num - i, swap);
+}
+
+/* converts eight values */
+__attribute__((target("avx512f"))) static __m512d
+avx512_ibm_oct(__m256i frac, __m256i exp, __m256i sign) {
+        __m512d scale = _mm512_castsi512_pd(
+            _mm512_slli_epi64(_mm512_cvtepu32_epi64(exp), 52));
+        __m512d res = _mm512_mul_pd(_mm512_cvtepi32_pd(frac), scale);
+        __m512i sbit = _mm512_slli_epi64(_mm512_cvtepu32_epi64(sign), 32);
+        return _mm512_castsi512_pd(
+            _mm512_or_si512(_mm512_castpd_si512(res), sbit));
+}
+
+/* byte shuffle needs AVX-512BW, rotations are in AVX-512F */
+__attribute__((target("avx512f"))) void
+ibm_avx512(double *dst, char const *src, size_t num, bool swap) {
+        __m512i const even_mask = _mm512_set1_epi32(0x00ff00ff);
+        __m512i const odd_mask = _mm512_set1_epi32((int)0xff00ff00);
+        __m512i const frac_mask = _mm512_set1_epi32(0x00ffffff);
+        __m512i const exp_mask = _mm512_set1_epi32(0x7f);
+        __m512i const sign_mask = _mm512_set1_epi32((int)0x80000000);
+        __m512i const bias = _mm512_set1_epi32(IBM_EXP_BIAS);
+        size_t i = 0;
+        for (; i + 16 <= num; i += 16) {
+                __m512i v = _mm512_loadu_si512(src + i * 4);
+                if (swap)
+                        v = _mm512_or_si512(
+                            _mm512_and_si512(_mm512_rol_epi32(v, 8),
+                                             even_mask),
+                            _mm512_and_si512(_mm512_ror_epi32(v, 8),
+                                             odd_mask));
+                __m512i frac = _mm512_and_si512(v, frac_mask);
+                __m512i exp = _mm512_add_epi32(
+                    _mm512_slli_epi32(
+                        _mm512_and_si512(_mm512_srli_epi32(v, 24), exp_mask),
+                        2),
+                    bias);
+                __m512i sign = _mm512_and_si512(v, sign_mask);
+                _mm512_storeu_pd(dst + i,
+                                 avx512_ibm_oct(_mm512_castsi512_si256(frac),
+                                                _mm512_castsi512_si256(exp),
+                                                _mm512_castsi512_si256(sign)));
+                _mm512_storeu_pd(
+                    dst + i + 8,
+                    avx512_ibm_oct(_mm512_extracti64x4_epi64(frac, 1),
+                                   _mm512_extracti64x4_epi64(exp, 1),
+                                   _mm512_extracti64x4_epi64(sign, 1)));
+        }
+        ibm_scalar(dst + i, src + i * 4, num - i, swap);
+}
+
+/* high 32 bits of four doubles, they hold sign and exponent */
+__attribute__((target("sse2"))) static __m128i sse2_high_words(__m128d a,
+                                                               __m128d b) {
+        return _mm_castps_si128(_mm_shuffle_ps(
+            _mm_castpd_ps(a), _mm_castpd_ps(b), _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+/* scales two absolute values to rounded fractions */
+__attribute__((target("sse2"))) static __m128i
+sse2_ibm_enc_pair(__m128d val, __m128i scale_exp) {
+        __m128d const round = _mm_set1_pd(IBM_ENC_ROUND);
+        __m128d scale = _mm_castsi128_pd(_mm_slli_epi64(
+            _mm_unpacklo_epi32(scale_exp, _mm_setzero_si128()), 52));
+        __m128d frac = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(val, scale), round),
+                                  round);
+        return _mm_cvttpd_epi32(frac);
+}
+
+/* SSE2 has no 32 bit min and max, clamping is done with masks. Lanes
+ * which overflow or hold NaN get garbage fraction and are replaced at the
+ * end. */
+__attribute__((target("sse2"))) void
+ibm_enc_sse2(char *dst, double const *src, size_t num, bool swap) {
+        __m128d const abs_mask =
+            _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffff));
+        __m128i const sign_mask = _mm_set1_epi32((int)0x80000000);
+        __m128i const one = _mm_set1_epi32(1);
+        __m128i const exp_bias = _mm_set1_epi32(IBM_ENC_EXP_BIAS);
+        __m128i const scale_bias = _mm_set1_epi32(IBM_ENC_SCALE_BIAS);
+        __m128i const max_exp = _mm_set1_epi32(127);
+        __m128i const carry_val = _mm_set1_epi32(1 << 24);
+        __m128i const carry_sub = _mm_set1_epi32((1 << 24) - (1 << 20));
+        __m128i const ibm_max = _mm_set1_epi32(IBM_MAX);
+        size_t i = 0;
+        for (; i + 4 <= num; i += 4) {
+                __m128d lo = _mm_loadu_pd(src + i);
+                __m128d hi = _mm_loadu_pd(src + i + 2);
+                __m128i top = sse2_high_words(lo, hi);
+                __m128i nan = sse2_high_words(_mm_cmpunord_pd(lo, lo),
+                                              _mm_cmpunord_pd(hi, hi));
+                __m128i sign = _mm_and_si128(top, sign_mask);
+                __m128i exp = _mm_sub_epi32(
+                    _mm_srli_epi32(
+                        _mm_add_epi32(
+                            _mm_srli_epi32(_mm_andnot_si128(sign_mask, top),
+                                           20),
+                            one),
+                        2),
+                    exp_bias);
+                __m128i over = _mm_cmpgt_epi32(exp, max_exp);
+                exp = _mm_andnot_si128(_mm_srai_epi32(exp, 31), exp);
+                exp = _mm_or_si128(_mm_andnot_si128(over, exp),
+                                   _mm_and_si128(over, max_exp));
+                __m128i scale_exp =
+                    _mm_sub_epi32(scale_bias, _mm_slli_epi32(exp, 2));
+                __m128i frac = _mm_unpacklo_epi64(
+                    sse2_ibm_enc_pair(_mm_and_pd(lo, abs_mask), scale_exp),
+                    sse2_ibm_enc_pair(_mm_and_pd(hi, abs_mask),
+                                      _mm_srli_si128(scale_exp, 8)));
+                __m128i carry = _mm_cmpeq_epi32(frac, carry_val);
+                frac = _mm_sub_epi32(frac, _mm_and_si128(carry, carry_sub));
+                exp = _mm_sub_epi32(exp, carry);
+                over = _mm_or_si128(over, _mm_cmpgt_epi32(exp, max_exp));
+                __m128i res = _mm_or_si128(_mm_slli_epi32(exp, 24), frac);
+                res = _mm_or_si128(_mm_andnot_si128(over, res),
+                                   _mm_and_si128(over, ibm_max));
+                res = _mm_andnot_si128(nan, _mm_or_si128(res, sign));
+                if (swap)
+                        res = sse2_bswap32(res);
+                _mm_storeu_si128((__m128i *)(dst + i * 4), res);
+        }
+        ibm_enc_scalar(dst + i * 4, src + i, num - i, swap);
+}
+
+/* high 32 bits of eight doubles. Shuffle works inside 128 bit lanes, so
+ * 64 bit parts are put in order afterwards. */
+__attribute__((target("avx2"))) static __m256i avx2_high_words(__m256d a,
+                                                               __m256d b) {
+        __m256 s = _mm256_shuffle_ps(_mm256_castpd_ps(a), _mm256_castpd_ps(b),
+                                     _MM_SHUFFLE(3, 1, 3, 1));
+        return _mm256_permute4x64_epi64(_mm256_castps_si256(s),
+                                        _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+/* scales four absolute values to rounded fractions */
+__attribute__((target("avx2"))) static __m128i
+avx2_ibm_enc_quad(__m256d val, __m128i scale_exp) {
+        __m256d const round = _mm256_set1_pd(IBM_ENC_ROUND);
+        __m256d scale = _mm256_castsi256_pd(
+            _mm256_slli_epi64(_mm256_cvtepu32_epi64(scale_exp), 52));
+        __m256d frac = _mm256_sub_pd(
+            _mm256_add_pd(_mm256_mul_pd(val, scale), round), round);
+        return _mm256_cvttpd_epi32(frac);
+}
+
+__attribute__((target("avx2"))) void
+ibm_enc_avx2(char *dst, double const *src, size_t num, bool swap) {
+        __m256i const shuffle = _mm256_setr_epi8(
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0,
+            7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        __m256d const abs_mask =
+            _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffff));
+        __m256i const sign_mask = _mm256_set1_epi32((int)0x80000000);
+        __m256i const one = _mm256_set1_epi32(1);
+        __m256i const exp_bias = _mm256_set1_epi32(IBM_ENC_EXP_BIAS);
+        __m256i const scale_bias = _mm256_set1_epi32(IBM_ENC_SCALE_BIAS);
+        __m256i const max_exp = _mm256_set1_epi32(127);
+        __m256i const carry_val = _mm256_set1_epi32(1 << 24);
+        __m256i const carry_sub = _mm256_set1_epi32((1 << 24) - (1 << 20));
+        __m256i const ibm_max = _mm256_set1_epi32(IBM_MAX);
+        size_t i = 0;
+        for (; i + 8 <= num; i += 8) {
+                __m256d lo = _mm256_loadu_pd(src + i);
+                __m256d hi = _mm256_loadu_pd(src + i + 4);
+                __m256i top = avx2_high_words(lo, hi);
+                __m256i nan =
+                    avx2_high_words(_mm256_cmp_pd(lo, lo, _CMP_UNORD_Q),
+                                    _mm256_cmp_pd(hi, hi, _CMP_UNORD_Q));
+                __m256i sign = _mm256_and_si256(top, sign_mask);
+                __m256i exp = _mm256_sub_epi32(
+                    _mm256_srli_epi32(
+                        _mm256_add_epi32(
+                            _mm256_srli_epi32(
+                                _mm256_andnot_si256(sign_mask, top), 20),
+                            one),
+                        2),
+                    exp_bias);
+                __m256i over = _mm256_cmpgt_epi32(exp, max_exp);
+                exp = _mm256_min_epi32(
+                    _mm256_max_epi32(exp, _mm256_setzero_si256()), max_exp);
+                __m256i scale_exp =
+                    _mm256_sub_epi32(scale_bias, _mm256_slli_epi32(exp, 2));
+                __m256i frac = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(avx2_ibm_enc_quad(
+                        _mm256_and_pd(lo, abs_mask),
+                        _mm256_castsi256_si128(scale_exp))),
+                    avx2_ibm_enc_quad(_mm256_and_pd(hi, abs_mask),
+                                      _mm256_extracti128_si256(scale_exp, 1)),
+                    1);
+                __m256i carry = _mm256_cmpeq_epi32(frac, carry_val);
+                frac = _mm256_sub_epi32(frac,
+                                        _mm256_and_si256(carry, carry_sub));
+                exp = _mm256_sub_epi32(exp, carry);
+                over = _mm256_or_si256(over, _mm256_cmpgt_epi32(exp, max_exp));
+                __m256i res = _mm256_or_si256(_mm256_slli_epi32(exp, 24), frac);
+                res = _mm256_blendv_epi8(res, ibm_max, over);
+                res = _mm256_andnot_si256(nan, _mm256_or_si256(res, sign));
+                if (swap)
+                        res = _mm256_shuffle_epi8(res, shuffle);
+                _mm256_storeu_si256((__m256i *)(dst + i * 4), res);
+        }
+        ibm_enc_scalar(dst + i * 4, src + i, num - i, swap);
+}
+
+#endif /* SEIS_SEGY_X86_KERNELS */
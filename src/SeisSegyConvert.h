@@ -0,0 +1,76 @@
+#ifndef SEIS_SEGY_CONVERT
+#define SEIS_SEGY_CONVERT
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Whole buffer sample converters and encoders. Sample buffers have no
+ * alignment requirements. IBM kernels are chosen at runtime by CPU
+ * features. */
+
+/* converts num samples of one format to doubles */
+typedef void (*SeisSegyConvertFunc)(double *dst, char const *src, size_t num);
+
+/* gets converter for SEGY format code. swap means bytes are in reverse to
+ * host order. Returns NULL for unknown format. */
+SeisSegyConvertFunc seis_segy_get_converter(int format_code, bool swap);
+
+/* converts num samples of one format to floats */
+typedef void (*SeisSegyConvertFloatFunc)(float *dst, char const *src,
+                                         size_t num);
+
+/* same as seis_segy_get_converter but for float output */
+SeisSegyConvertFloatFunc seis_segy_get_float_converter(int format_code,
+                                                       bool swap);
+
+/* converts num IBM floats to doubles. swap reverses byte order of every
+ * value before conversion. Every IBM float is exactly representable as
+ * double, so result doesn't depend on chosen kernel. */
+void seis_segy_ibm_to_double(double *dst, char const *src, size_t num,
+                             bool swap);
+
+/* converts num doubles to samples of one format */
+typedef void (*SeisSegyEncodeFunc)(char *dst, double const *src, size_t num);
+
+/* gets encoder for SEGY format code. swap means bytes should be written in
+ * reverse to host order. Integers are rounded to nearest even and
+ * saturated, NaN becomes zero. Returns NULL for unknown format. */
+SeisSegyEncodeFunc seis_segy_get_encoder(int format_code, bool swap);
+
+/* converts num floats to samples of one format */
+typedef void (*SeisSegyEncodeFloatFunc)(char *dst, float const *src,
+                                        size_t num);
+
+/* same as seis_segy_get_encoder but for float input */
+SeisSegyEncodeFloatFunc seis_segy_get_float_encoder(int format_code,
+                                                    bool swap);
+
+/* converts num doubles to IBM floats rounding to nearest even. Values above
+ * IBM range are clamped to biggest value, values below it get zero
+ * exponent and unnormalized fraction, so only ones below about 16^-70
+ * become signed zero. NaN becomes zero. Result doesn't depend on chosen
+ * kernel. */
+void seis_segy_double_to_ibm(char *dst, double const *src, size_t num,
+                             bool swap);
+
+/* IBM kernels. Other formats have single portable loop each. */
+typedef enum SeisSegyKernel {
+        SEIS_SEGY_KERNEL_SCALAR,
+        SEIS_SEGY_KERNEL_SSE2,
+        SEIS_SEGY_KERNEL_AVX2,
+        SEIS_SEGY_KERNEL_AVX512,
+        SEIS_SEGY_KERNELS_NUM
+} SeisSegyKernel;
+
+/* same as seis_segy_ibm_to_double with given kernel. Returns false if
+ * kernel isn't built or isn't supported by CPU. For testing and
+ * benchmarking. */
+bool seis_segy_ibm_to_double_kernel(SeisSegyKernel kernel, double *dst,
+                                    char const *src, size_t num, bool swap);
+
+/* same as seis_segy_double_to_ibm with given kernel. Returns false if
+ * kernel isn't built or isn't supported by CPU. */
+bool seis_segy_double_to_ibm_kernel(SeisSegyKernel kernel, char *dst,
+                                    double const *src, size_t num, bool swap);
+
+#endif /* SEIS_SEGY_CONVERT */
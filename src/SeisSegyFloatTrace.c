@@ -0,0 +1,69 @@
+#include "SeisSegyFloatTrace.h"
+#include <SeisTrace.h>
+#include <stdlib.h>
+
+struct SeisSegyFloatTrace {
+        SeisTraceHeader *hdr;
+        float *samples;
+        long long samp_num;
+        int rc;
+};
+
+SeisSegyFloatTrace *
+seis_segy_float_trace_new_with_header(long long samp_num,
+                                      SeisTraceHeader *hdr) {
+        SeisSegyFloatTrace *trc =
+            (SeisSegyFloatTrace *)malloc(sizeof(struct SeisSegyFloatTrace));
+        if (!trc)
+                goto error;
+        trc->samples = NULL;
+        if (samp_num) {
+                trc->samples = (float *)malloc(samp_num * sizeof(float));
+                if (!trc->samples)
+                        goto error;
+        }
+        trc->hdr = hdr;
+        trc->samp_num = samp_num;
+        trc->rc = 1;
+        return trc;
+error:
+        free(trc);
+        return NULL;
+}
+
+SeisSegyFloatTrace *seis_segy_float_trace_ref(SeisSegyFloatTrace *trc) {
+        ++trc->rc;
+        return trc;
+}
+
+void seis_segy_float_trace_unref(SeisSegyFloatTrace **trc) {
+        if (*trc)
+                if (--(*trc)->rc == 0) {
+                        seis_trace_header_unref(&(*trc)->hdr);
+                        free((*trc)->samples);
+                        free(*trc);
+                        *trc = NULL;
+                }
+}
+
+SeisTraceHeader *seis_segy_float_trace_get_header(SeisSegyFloatTrace *trc) {
+        return trc->hdr;
+}
+
+SeisTraceHeader const *
+seis_segy_float_trace_get_header_const(SeisSegyFloatTrace const *trc) {
+        return trc->hdr;
+}
+
+float *seis_segy_float_trace_get_samples(SeisSegyFloatTrace *trc) {
+        return trc->samples;
+}
+
+float const *
+seis_segy_float_trace_get_samples_const(SeisSegyFloatTrace const *trc) {
+        return trc->samples;
+}
+
+long long seis_segy_float_trace_get_samples_num(SeisSegyFloatTrace const *trc) {
+        return trc->samp_num;
+}
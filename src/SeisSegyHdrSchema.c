@@ -0,0 +1,171 @@
+#include "SeisSegyHdrSchema.h"
+#include "SeisSegyBytes.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BIND_INT(f, name, swap)                                                \
+        do {                                                                   \
+                (f)->get_int = (swap) ? get_##name##_sw : get_##name;          \
+                (f)->put_int = (swap) ? put_##name##_sw : put_##name;          \
+        } while (0)
+
+#define BIND_REAL(f, name, swap)                                               \
+        do {                                                                   \
+                (f)->get_real = (swap) ? get_##name##_sw : get_##name;         \
+                (f)->put_real = (swap) ? put_##name##_sw : put_##name;         \
+        } while (0)
+
+SeisSegyHdrSchema *seis_segy_hdr_schema_new(void) {
+        SeisSegyHdrSchema *s =
+            (SeisSegyHdrSchema *)malloc(sizeof(struct SeisSegyHdrSchema));
+        if (!s)
+                return NULL;
+        s->fields = NULL;
+        s->blocks = NULL;
+        s->blocks_num = 0;
+        s->fields_num = 0;
+        s->names = NULL;
+        s->slots_num = 0;
+        s->add_hdr_num_slot = -1;
+        s->samp_num_slot = -1;
+        s->swap = false;
+        s->rc = 1;
+        return s;
+}
+
+SeisSegyHdrSchema *seis_segy_hdr_schema_ref(SeisSegyHdrSchema *s) {
+        ++s->rc;
+        return s;
+}
+
+void seis_segy_hdr_schema_unref(SeisSegyHdrSchema **s) {
+        if (*s) {
+                if (--(*s)->rc == 0) {
+                        free((*s)->fields);
+                        free((*s)->blocks);
+                        free((*s)->names);
+                        free(*s);
+                }
+                *s = NULL;
+        }
+}
+
+bool seis_segy_hdr_field_bind(SeisSegyHdrField *f, bool swap) {
+        f->get_int = NULL;
+        f->put_int = NULL;
+        f->get_real = NULL;
+        f->put_real = NULL;
+        switch (f->format) {
+        case i8:
+                BIND_INT(f, i8, swap);
+                break;
+        case u8:
+                BIND_INT(f, u8, swap);
+                break;
+        case i16:
+                BIND_INT(f, i16, swap);
+                break;
+        case u16:
+                BIND_INT(f, u16, swap);
+                break;
+        case i32:
+                BIND_INT(f, i32, swap);
+                break;
+        case u32:
+                BIND_INT(f, u32, swap);
+                break;
+        case i64:
+                BIND_INT(f, i64, swap);
+                break;
+        case u64:
+                BIND_INT(f, u64, swap);
+                break;
+        case f32:
+                BIND_REAL(f, f32, swap);
+                break;
+        case f64:
+                BIND_REAL(f, f64, swap);
+                break;
+        case b64:
+                break;
+        default:
+                return false;
+        }
+        return true;
+}
+
+int seis_segy_hdr_schema_slot(SeisSegyHdrSchema const *s, char const *name) {
+        for (size_t i = 0; i < s->fields_num; ++i)
+                if (!strcmp(s->fields[i].name, name))
+                        return s->fields[i].slot;
+        return -1;
+}
+
+bool seis_segy_hdr_schema_get_int(SeisSegyHdrSchema const *s, size_t block,
+                                  char const *buf, int slot, long long *val) {
+        if (block >= s->blocks_num)
+                return false;
+        SeisSegyHdrField const *f = s->fields + s->blocks[block];
+        SeisSegyHdrField const *end = s->fields + s->blocks[block + 1];
+        for (; f != end; ++f)
+                if (f->slot == slot) {
+                        if (!f->get_int)
+                                return false;
+                        *val = f->get_int(buf + f->offset);
+                        return true;
+                }
+        return false;
+}
+
+SeisSegyHdrField const *
+seis_segy_hdr_schema_find_last(SeisSegyHdrSchema const *s, size_t blocks_num,
+                               int slot) {
+        if (blocks_num > s->blocks_num)
+                blocks_num = s->blocks_num;
+        SeisSegyHdrField const *f = s->fields + s->blocks[blocks_num];
+        while (f-- != s->fields)
+                if (f->slot == slot && (f->get_int || f->get_real))
+                        return f;
+        return NULL;
+}
+
+void seis_segy_hdr_schema_decode(SeisSegyHdrSchema const *s, size_t block,
+                                 char const *buf, SeisTraceHeader *hdr) {
+        if (block >= s->blocks_num)
+                return;
+        SeisSegyHdrField const *f = s->fields + s->blocks[block];
+        SeisSegyHdrField const *end = s->fields + s->blocks[block + 1];
+        for (; f != end; ++f)
+                if (f->get_int)
+                        seis_trace_header_set_int(hdr, f->name,
+                                                  f->get_int(buf + f->offset));
+                else if (f->get_real)
+                        seis_trace_header_set_real(
+                            hdr, f->name, f->get_real(buf + f->offset));
+}
+
+void seis_segy_hdr_schema_encode(SeisSegyHdrSchema const *s, size_t block,
+                                 SeisTraceHeader const *hdr, char *buf) {
+        memset(buf, 0, SEIS_SEGY_TRACE_HEADER_SIZE);
+        if (block >= s->blocks_num)
+                return;
+        SeisSegyHdrField const *f = s->fields + s->blocks[block];
+        SeisSegyHdrField const *end = s->fields + s->blocks[block + 1];
+        for (; f != end; ++f) {
+                char *ptr = buf + f->offset;
+                if (f->put_int) {
+                        long long const *i = seis_trace_header_value_get_int(
+                            seis_trace_header_get(hdr, f->name));
+                        f->put_int(ptr, i ? *i : 0);
+                } else if (f->put_real) {
+                        double const *d = seis_trace_header_value_get_real(
+                            seis_trace_header_get(hdr, f->name));
+                        f->put_real(ptr, d ? *d : 0);
+                } else {
+                        /* b64 fields hold their own name */
+                        size_t size = strlen(f->name);
+                        memcpy(ptr, f->name, size > 8 ? 8 : size);
+                }
+        }
+}
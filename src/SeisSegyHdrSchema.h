@@ -0,0 +1,76 @@
+#ifndef SEIS_SEGY_HDR_SCHEMA
+#define SEIS_SEGY_HDR_SCHEMA
+
+#include "SeisCommonSegy.h"
+#include <SeisTrace.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Trace header map compiled for one byte order. Every field knows its
+ * place in 240 bytes block and has accessors picked ahead, so headers are
+ * decoded and encoded without looking at formats. Fields with equal names
+ * share slot number, it is used instead of name in lookups. Schema is
+ * immutable after compilation and shared by reference counting, remap
+ * compiles new one. */
+
+typedef struct SeisSegyHdrField {
+        char const *name;
+        int slot;
+        int block;
+        int offset;
+        enum FORMAT format;
+        /* only one pair is set, none for b64 */
+        long long (*get_int)(char const *buf);
+        void (*put_int)(char *buf, long long val);
+        double (*get_real)(char const *buf);
+        void (*put_real)(char *buf, double val);
+} SeisSegyHdrField;
+
+typedef struct SeisSegyHdrSchema {
+        SeisSegyHdrField *fields;
+        /* fields of block i are from blocks[i] to blocks[i + 1] */
+        size_t *blocks;
+        size_t blocks_num;
+        size_t fields_num;
+        char *names;
+        int slots_num;
+        /* slots used by reader itself, -1 if not in map */
+        int add_hdr_num_slot;
+        int samp_num_slot;
+        bool swap;
+        int rc;
+} SeisSegyHdrSchema;
+
+/* empty schema, NULL if there is no memory */
+SeisSegyHdrSchema *seis_segy_hdr_schema_new(void);
+
+SeisSegyHdrSchema *seis_segy_hdr_schema_ref(SeisSegyHdrSchema *s);
+
+void seis_segy_hdr_schema_unref(SeisSegyHdrSchema **s);
+
+/* sets accessors of field for byte order, returns false for unknown
+ * format */
+bool seis_segy_hdr_field_bind(SeisSegyHdrField *f, bool swap);
+
+/* slot of field with name or -1 */
+int seis_segy_hdr_schema_slot(SeisSegyHdrSchema const *s, char const *name);
+
+/* decodes integer field of slot from block without touching other
+ * fields. Returns false if block has no such integer field. */
+bool seis_segy_hdr_schema_get_int(SeisSegyHdrSchema const *s, size_t block,
+                                  char const *buf, int slot, long long *val);
+
+/* field of slot decoded last from first blocks_num blocks or NULL */
+SeisSegyHdrField const *
+seis_segy_hdr_schema_find_last(SeisSegyHdrSchema const *s, size_t blocks_num,
+                               int slot);
+
+/* sets all fields of block in trace header, later fields win */
+void seis_segy_hdr_schema_decode(SeisSegyHdrSchema const *s, size_t block,
+                                 char const *buf, SeisTraceHeader *hdr);
+
+/* fills block buffer from trace header, missing values are zeros */
+void seis_segy_hdr_schema_encode(SeisSegyHdrSchema const *s, size_t block,
+                                 SeisTraceHeader const *hdr, char *buf);
+
+#endif
@@ -0,0 +1,122 @@
+#include "SeisSegyLazyHeader.h"
+#include "SeisCommonSegy.h"
+#include "SeisSegyHdrSchema.h"
+#include "SeisSegyLazyHeaderPrivate.h"
+#include <SeisTrace.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum LAZY_STATE { LAZY_UNKNOWN, LAZY_INT, LAZY_REAL, LAZY_MISSING };
+
+/* cached value of one slot */
+struct SeisSegyLazyValue {
+        union {
+                long long i;
+                double d;
+        } val;
+        enum LAZY_STATE state;
+};
+
+struct SeisSegyLazyHeader {
+        SeisSegyHdrSchema *schema;
+        char *raw;
+        size_t blocks_num;
+        int rc;
+        struct SeisSegyLazyValue cache[];
+};
+
+static struct SeisSegyLazyValue const *lookup(SeisSegyLazyHeader *hdr,
+                                              char const *name);
+
+SeisSegyLazyHeader *seis_segy_lazy_header_new(SeisSegyHdrSchema *schema,
+                                              char const *blocks,
+                                              size_t blocks_num) {
+        size_t size = blocks_num * SEIS_SEGY_TRACE_HEADER_SIZE;
+        SeisSegyLazyHeader *hdr = (SeisSegyLazyHeader *)malloc(
+            sizeof(struct SeisSegyLazyHeader) +
+            schema->slots_num * sizeof(struct SeisSegyLazyValue));
+        if (!hdr)
+                return NULL;
+        hdr->raw = (char *)malloc(size);
+        if (!hdr->raw) {
+                free(hdr);
+                return NULL;
+        }
+        memcpy(hdr->raw, blocks, size);
+        for (int i = 0; i < schema->slots_num; ++i)
+                hdr->cache[i].state = LAZY_UNKNOWN;
+        hdr->schema = seis_segy_hdr_schema_ref(schema);
+        hdr->blocks_num = blocks_num;
+        hdr->rc = 1;
+        return hdr;
+}
+
+SeisSegyLazyHeader *seis_segy_lazy_header_ref(SeisSegyLazyHeader *hdr) {
+        ++hdr->rc;
+        return hdr;
+}
+
+void seis_segy_lazy_header_unref(SeisSegyLazyHeader **hdr) {
+        if (*hdr)
+                if (--(*hdr)->rc == 0) {
+                        seis_segy_hdr_schema_unref(&(*hdr)->schema);
+                        free((*hdr)->raw);
+                        free(*hdr);
+                        *hdr = NULL;
+                }
+}
+
+long long const *seis_segy_lazy_header_get_int(SeisSegyLazyHeader *hdr,
+                                               char const *name) {
+        struct SeisSegyLazyValue const *v = lookup(hdr, name);
+        return v && v->state == LAZY_INT ? &v->val.i : NULL;
+}
+
+double const *seis_segy_lazy_header_get_real(SeisSegyLazyHeader *hdr,
+                                             char const *name) {
+        struct SeisSegyLazyValue const *v = lookup(hdr, name);
+        return v && v->state == LAZY_REAL ? &v->val.d : NULL;
+}
+
+SeisTraceHeader *seis_segy_lazy_header_decode(SeisSegyLazyHeader const *hdr) {
+        SeisTraceHeader *res = seis_trace_header_new();
+        if (!res)
+                return NULL;
+        for (size_t i = 0; i < hdr->blocks_num; ++i)
+                seis_segy_hdr_schema_decode(
+                    hdr->schema, i, hdr->raw + i * SEIS_SEGY_TRACE_HEADER_SIZE,
+                    res);
+        return res;
+}
+
+char const *seis_segy_lazy_header_get_raw(SeisSegyLazyHeader const *hdr,
+                                          size_t *size) {
+        *size = hdr->blocks_num * SEIS_SEGY_TRACE_HEADER_SIZE;
+        return hdr->raw;
+}
+
+/* last field of slot wins as in eager decoding */
+struct SeisSegyLazyValue const *lookup(SeisSegyLazyHeader *hdr,
+                                       char const *name) {
+        int slot = seis_segy_hdr_schema_slot(hdr->schema, name);
+        if (slot < 0)
+                return NULL;
+        struct SeisSegyLazyValue *v = hdr->cache + slot;
+        if (v->state != LAZY_UNKNOWN)
+                return v;
+        SeisSegyHdrField const *f =
+            seis_segy_hdr_schema_find_last(hdr->schema, hdr->blocks_num, slot);
+        char const *ptr =
+            f ? hdr->raw + f->block * SEIS_SEGY_TRACE_HEADER_SIZE + f->offset
+              : NULL;
+        if (f && f->get_int) {
+                v->val.i = f->get_int(ptr);
+                v->state = LAZY_INT;
+        } else if (f && f->get_real) {
+                v->val.d = f->get_real(ptr);
+                v->state = LAZY_REAL;
+        } else {
+                v->state = LAZY_MISSING;
+        }
+        return v;
+}
@@ -0,0 +1,14 @@
+#ifndef SEIS_SEGY_LAZY_HEADER_PRIVATE
+#define SEIS_SEGY_LAZY_HEADER_PRIVATE
+
+#include "SeisSegyHdrSchema.h"
+#include "SeisSegyLazyHeader.h"
+#include <stddef.h>
+
+/* copies blocks_num raw header blocks and takes reference to schema.
+ * Returns NULL if there is no memory. */
+SeisSegyLazyHeader *seis_segy_lazy_header_new(SeisSegyHdrSchema *schema,
+                                              char const *blocks,
+                                              size_t blocks_num);
+
+#endif
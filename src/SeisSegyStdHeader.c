@@ -0,0 +1,192 @@
+#include "SeisSegyStdHeader.h"
+#include "SeisCommonSegy.h"
+#include "SeisSegyBytes.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LABEL_OFFSET 232
+
+/* member, offset and type of every field as in default trace header map,
+ * labels at LABEL_OFFSET are copied as is */
+#define MAIN_FIELDS(X)                                                         \
+        X(trc_seq_line, 0, i32)                                                \
+        X(trc_seq_sgy, 4, i32)                                                 \
+        X(ffid, 8, i32)                                                        \
+        X(chan, 12, i32)                                                       \
+        X(esp, 16, i32)                                                        \
+        X(ens_no, 20, i32)                                                     \
+        X(seq_no, 24, i32)                                                     \
+        X(trace_id, 28, i16)                                                   \
+        X(vert_sum, 30, i16)                                                   \
+        X(hor_sum, 32, i16)                                                    \
+        X(data_use, 34, i16)                                                   \
+        X(offset, 36, i32)                                                     \
+        X(r_elev, 40, i32)                                                     \
+        X(s_elev, 44, i32)                                                     \
+        X(s_depth, 48, i32)                                                    \
+        X(r_datum, 52, i32)                                                    \
+        X(s_datum, 56, i32)                                                    \
+        X(s_water, 60, i32)                                                    \
+        X(r_water, 64, i32)                                                    \
+        X(elev_scalar, 68, i16)                                                \
+        X(coord_scalar, 70, i16)                                               \
+        X(sou_x, 72, i32)                                                      \
+        X(sou_y, 76, i32)                                                      \
+        X(rec_x, 80, i32)                                                      \
+        X(rec_y, 84, i32)                                                      \
+        X(coord_units, 88, i16)                                                \
+        X(weath_vel, 90, i16)                                                  \
+        X(subweath_vel, 92, i16)                                               \
+        X(s_uphole, 94, i16)                                                   \
+        X(r_uphole, 96, i16)                                                   \
+        X(s_stat, 98, i16)                                                     \
+        X(r_stat, 100, i16)                                                    \
+        X(tot_stat, 102, i16)                                                  \
+        X(lag_a, 104, i16)                                                     \
+        X(lag_b, 106, i16)                                                     \
+        X(delay_time, 108, i16)                                                \
+        X(mute_start, 110, i16)                                                \
+        X(mute_end, 112, i16)                                                  \
+        X(samp_num, 114, i16)                                                  \
+        X(samp_int, 116, i16)                                                  \
+        X(gain_type, 118, i16)                                                 \
+        X(gain_const, 120, i16)                                                \
+        X(init_gain, 122, i16)                                                 \
+        X(correlated, 124, i16)                                                \
+        X(sw_start, 126, i16)                                                  \
+        X(sw_end, 128, i16)                                                    \
+        X(sw_length, 130, i16)                                                 \
+        X(sw_type, 132, i16)                                                   \
+        X(sw_taper_start, 134, i16)                                            \
+        X(sw_taper_end, 136, i16)                                              \
+        X(taper_type, 138, i16)                                                \
+        X(alias_filt_freq, 140, i16)                                           \
+        X(alias_filt_slope, 142, i16)                                          \
+        X(notch_filt_freq, 144, i16)                                           \
+        X(notch_filt_slope, 146, i16)                                          \
+        X(low_cut_freq, 148, i16)                                              \
+        X(high_cut_freq, 150, i16)                                             \
+        X(low_cut_slope, 152, i16)                                             \
+        X(high_cut_slope, 154, i16)                                            \
+        X(year, 156, i16)                                                      \
+        X(day, 158, i16)                                                       \
+        X(hour, 160, i16)                                                      \
+        X(minute, 162, i16)                                                    \
+        X(second, 164, i16)                                                    \
+        X(time_basis_code, 166, i16)                                           \
+        X(trace_weight, 168, i16)                                              \
+        X(group_num_roll, 170, i16)                                            \
+        X(group_num_first, 172, i16)                                           \
+        X(group_num_last, 174, i16)                                            \
+        X(gap_size, 176, i16)                                                  \
+        X(over_travel, 178, i16)                                               \
+        X(cdp_x, 180, i32)                                                     \
+        X(cdp_y, 184, i32)                                                     \
+        X(iline, 188, i32)                                                     \
+        X(xline, 192, i32)                                                     \
+        X(sp_num, 196, i32)                                                    \
+        X(sp_num_scalar, 200, i16)                                             \
+        X(tr_val_unit, 202, i16)                                               \
+        X(trans_const_mant, 204, i32)                                          \
+        X(trans_const_exp, 208, i16)                                           \
+        X(trans_units, 210, i16)                                               \
+        X(device_id, 212, i16)                                                 \
+        X(time_scalar, 214, i16)                                               \
+        X(source_type, 216, i16)                                               \
+        X(sou_v_dir, 218, i16)                                                 \
+        X(sou_x_dir, 220, i16)                                                 \
+        X(sou_i_dir, 222, i16)                                                 \
+        X(sou_meas_mant, 224, i32)                                             \
+        X(sou_meas_exp, 228, i16)                                              \
+        X(sou_meas_unit, 230, i16)
+
+/* map names both fields at 160 and 168 CDP_X_R, standard has CDP Y at
+ * 168 */
+#define EXT_FIELDS(X)                                                          \
+        X(ext_trc_seq_line, 0, u64)                                            \
+        X(ext_trc_seq_sgy, 8, u64)                                             \
+        X(ext_ffid, 16, i64)                                                   \
+        X(ext_ens_no, 24, i64)                                                 \
+        X(ext_r_elev_r, 32, f64)                                               \
+        X(ext_r_depth_r, 40, f64)                                              \
+        X(ext_s_elev_r, 48, f64)                                               \
+        X(ext_s_depth_r, 56, f64)                                              \
+        X(ext_r_datum_r, 64, f64)                                              \
+        X(ext_s_datum_r, 72, f64)                                              \
+        X(ext_s_water_r, 80, f64)                                              \
+        X(ext_r_water_r, 88, f64)                                              \
+        X(ext_sou_x_r, 96, f64)                                                \
+        X(ext_sou_y_r, 104, f64)                                               \
+        X(ext_rec_x_r, 112, f64)                                               \
+        X(ext_rec_y_r, 120, f64)                                               \
+        X(ext_offset_r, 128, f64)                                              \
+        X(ext_samp_num, 136, u32)                                              \
+        X(ext_nanosec, 140, i32)                                               \
+        X(ext_samp_int_r, 144, f64)                                            \
+        X(ext_sens_id, 152, i32)                                               \
+        X(ext_add_trc_hdr, 156, u16)                                           \
+        X(ext_last_tr_flag, 158, u16)                                          \
+        X(ext_cdp_x_r, 160, f64)                                               \
+        X(ext_cdp_y_r, 168, f64)
+
+/* accessors are shared with trace header schema */
+#define GET_FIELD(member, offset, type)                                        \
+        hdr->member = (swap ? get_##type##_sw : get_##type)(buf + (offset));
+#define ZERO_FIELD(member, offset, type) hdr->member = 0;
+#define PUT_FIELD(member, offset, type)                                        \
+        (swap ? put_##type##_sw : put_##type)(buf + (offset), hdr->member);
+
+/* swap is constant at every call below, so both byte orders get straight
+ * code without per field branches */
+static inline void decode(SeisSegyStdHeader *hdr, char const *buf,
+                          size_t size, bool swap) {
+        MAIN_FIELDS(GET_FIELD)
+        memcpy(hdr->seg00000, buf + LABEL_OFFSET, sizeof(hdr->seg00000));
+        hdr->has_ext = size >= 2 * SEIS_SEGY_TRACE_HEADER_SIZE;
+        if (hdr->has_ext) {
+                buf += SEIS_SEGY_TRACE_HEADER_SIZE;
+                EXT_FIELDS(GET_FIELD)
+                memcpy(hdr->seg00001, buf + LABEL_OFFSET,
+                       sizeof(hdr->seg00001));
+        } else {
+                EXT_FIELDS(ZERO_FIELD)
+                memset(hdr->seg00001, 0, sizeof(hdr->seg00001));
+        }
+}
+
+static inline void encode(SeisSegyStdHeader const *hdr, char *buf,
+                          size_t size, bool swap) {
+        MAIN_FIELDS(PUT_FIELD)
+        memcpy(buf + LABEL_OFFSET, hdr->seg00000, sizeof(hdr->seg00000));
+        if (hdr->has_ext && size >= 2 * SEIS_SEGY_TRACE_HEADER_SIZE) {
+                buf += SEIS_SEGY_TRACE_HEADER_SIZE;
+                /* there are bytes without fields */
+                memset(buf, 0, SEIS_SEGY_TRACE_HEADER_SIZE);
+                EXT_FIELDS(PUT_FIELD)
+                memcpy(buf + LABEL_OFFSET, hdr->seg00001,
+                       sizeof(hdr->seg00001));
+        }
+}
+
+bool seis_segy_std_header_decode(SeisSegyStdHeader *hdr, char const *headers,
+                                 size_t size, bool big_endian) {
+        if (size < SEIS_SEGY_TRACE_HEADER_SIZE)
+                return false;
+        if (big_endian == host_is_little_endian())
+                decode(hdr, headers, size, true);
+        else
+                decode(hdr, headers, size, false);
+        return true;
+}
+
+bool seis_segy_std_header_encode(SeisSegyStdHeader const *hdr, char *headers,
+                                 size_t size, bool big_endian) {
+        if (size < SEIS_SEGY_TRACE_HEADER_SIZE)
+                return false;
+        if (big_endian == host_is_little_endian())
+                encode(hdr, headers, size, true);
+        else
+                encode(hdr, headers, size, false);
+        return true;
+}
@@ -0,0 +1,137 @@
+#include "SeisISegy.h"
+#include "SeisOSegy.h"
+#include "SeisSegyBackend.h"
+#include <SeisTrace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct user_data {
+        char const *buf;
+        size_t size;
+        int closed;
+};
+
+/* custom backend without view makes reader use its buffer */
+static long long user_read_at(void *data, void *buf, size_t num,
+                              size_t offset) {
+        struct user_data *d = (struct user_data *)data;
+        if (offset >= d->size)
+                return 0;
+        if (num > d->size - offset)
+                num = d->size - offset;
+        /* short reads must be handled by reader */
+        if (num > 1000)
+                num = 1000;
+        memcpy(buf, d->buf + offset, num);
+        return num;
+}
+
+static long long user_size(void *data) {
+        return ((struct user_data *)data)->size;
+}
+
+static void user_close(void *data) { ((struct user_data *)data)->closed = 1; }
+
+static char *load_file(char const *file_name, size_t *size) {
+        FILE *file = fopen(file_name, "rb");
+        if (!file)
+                return NULL;
+        fseek(file, 0, SEEK_END);
+        *size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        char *buf = malloc(*size);
+        if (buf && fread(buf, 1, *size, file) != *size) {
+                free(buf);
+                buf = NULL;
+        }
+        fclose(file);
+        return buf;
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        size_t size;
+        char *orig = load_file(argv[1], &size);
+        if (!orig)
+                return 1;
+        struct user_data data = {orig, size, 0};
+        SeisSegyBackendOps ops = {user_read_at, NULL, user_size,
+                                  NULL,         NULL, user_close};
+        SeisSegyBackend *in = seis_segy_backend_new(&ops, &data);
+        SeisSegyBackend *out = seis_segy_backend_memory_new_writable();
+        SeisSegyBackend *back = NULL;
+        SeisISegy *isgy = seis_isegy_new();
+        SeisOSegy *osgy = seis_osegy_new();
+        SeisTrace *trc = NULL;
+        SeisSegyErr const *ierr = NULL, *oerr = NULL;
+        if (!in || !out || !isgy || !osgy)
+                goto error;
+        ierr = seis_isegy_get_error(isgy);
+        oerr = seis_osegy_get_error(osgy);
+        seis_isegy_open_backend(isgy, in);
+        seis_segy_backend_unref(&in);
+        if (ierr->code)
+                goto error;
+        seis_osegy_set_text_header(osgy, seis_isegy_get_text_header(isgy, 0));
+        seis_osegy_set_binary_header(osgy, seis_isegy_get_binary_header(isgy));
+        seis_osegy_open_backend(osgy, out);
+        if (oerr->code)
+                goto error;
+        size_t traces_num = 0;
+        while (!seis_isegy_end_of_data(isgy)) {
+                trc = seis_isegy_read_trace(isgy);
+                if (ierr->code)
+                        goto error;
+                seis_osegy_write_trace(osgy, trc);
+                if (oerr->code)
+                        goto error;
+                seis_trace_unref(&trc);
+                ++traces_num;
+        }
+        seis_isegy_unref(&isgy);
+        seis_osegy_unref(&osgy);
+        if (!data.closed)
+                goto error;
+        size_t out_size;
+        char const *out_buf = seis_segy_backend_memory_get_data(out, &out_size);
+        if (!out_buf || out_size != size || memcmp(out_buf, orig, size))
+                goto error;
+        /* written data is read straight from memory */
+        back = seis_segy_backend_memory_new(out_buf, out_size);
+        isgy = seis_isegy_new();
+        if (!back || !isgy)
+                goto error;
+        ierr = seis_isegy_get_error(isgy);
+        seis_isegy_open_backend(isgy, back);
+        if (ierr->code)
+                goto error;
+        while (!seis_isegy_end_of_data(isgy)) {
+                trc = seis_isegy_read_trace(isgy);
+                if (ierr->code)
+                        goto error;
+                seis_trace_unref(&trc);
+                --traces_num;
+        }
+        if (traces_num)
+                goto error;
+        seis_isegy_unref(&isgy);
+        seis_segy_backend_unref(&back);
+        seis_segy_backend_unref(&out);
+        free(orig);
+        return 0;
+error:
+        if (ierr && ierr->code)
+                printf("%s\n", ierr->message);
+        if (oerr && oerr->code)
+                printf("%s\n", oerr->message);
+        seis_trace_unref(&trc);
+        seis_isegy_unref(&isgy);
+        seis_osegy_unref(&osgy);
+        seis_segy_backend_unref(&in);
+        seis_segy_backend_unref(&back);
+        seis_segy_backend_unref(&out);
+        free(orig);
+        return 1;
+}
@@ -0,0 +1,474 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "SeisSegyConvert.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* values checked at once */
+#define CHUNK (1 << 16)
+/* values drawn from 64 bit spaces */
+#define SAMPLED_NUM (1 << 24)
+/* minimal time of every benchmark in seconds */
+#define BENCH_TIME 0.2
+
+struct format {
+        int code;
+        int size;
+        char const *name;
+};
+
+static struct format const formats[] = {
+    {1, 4, "ibm"},  {2, 4, "i32"},  {3, 2, "i16"},  {4, 4, "fixp"},
+    {5, 4, "f32"},  {6, 8, "f64"},  {7, 3, "i24"},  {8, 1, "i8"},
+    {9, 8, "i64"},  {10, 4, "u32"}, {11, 2, "u16"}, {12, 8, "u64"},
+    {15, 3, "u24"}, {16, 1, "u8"}};
+
+static char const *const kernel_names[SEIS_SEGY_KERNELS_NUM] = {
+    "scalar", "sse2", "avx2", "avx512"};
+
+static uint32_t pat[CHUNK];
+static char src[2][CHUNK * sizeof(uint64_t)];
+static char enc[CHUNK * sizeof(uint64_t)];
+static double ref[CHUNK], dbl[CHUNK];
+static float flt[CHUNK], flt_out[CHUNK];
+static uint32_t expect[CHUNK], expect_f32[CHUNK];
+
+static uint32_t swap32(uint32_t v) {
+        return v << 24 | (v & 0xff00) << 8 | (v >> 8 & 0xff00) | v >> 24;
+}
+
+static uint64_t swap64(uint64_t v) {
+        return (uint64_t)swap32((uint32_t)v) << 32 | swap32(v >> 32);
+}
+
+static uint64_t next_random(uint64_t *state) {
+        uint64_t x = (*state += 0x9e3779b97f4a7c15ull);
+        x = (x ^ x >> 30) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ x >> 27) * 0x94d049bb133111ebull;
+        return x ^ x >> 31;
+}
+
+/* fills native and swapped copies of 32 bit patterns */
+static void fill_src32(uint32_t const *v, size_t num) {
+        for (size_t i = 0; i < num; ++i) {
+                uint32_t s = swap32(v[i]);
+                memcpy(src[0] + i * 4, v + i, 4);
+                memcpy(src[1] + i * 4, &s, 4);
+        }
+}
+
+/* compares encoded 32 bit values with expected ones in host order */
+static long long diff32(char const *buf, uint32_t const *exp, size_t num,
+                        bool swap) {
+        for (size_t i = 0; i < num; ++i) {
+                uint32_t v;
+                memcpy(&v, buf + i * 4, 4);
+                if ((swap ? swap32(v) : v) != exp[i])
+                        return (long long)i;
+        }
+        return -1;
+}
+
+static long long diff_bits(void const *a, void const *b, size_t size,
+                           size_t num) {
+        if (!memcmp(a, b, size * num))
+                return -1;
+        for (size_t i = 0; i < num; ++i)
+                if (memcmp((char const *)a + i * size,
+                           (char const *)b + i * size, size))
+                        return (long long)i;
+        return -1;
+}
+
+/* powers of 16 for IBM exponents, fraction is scaled by 16^-6 */
+static double ibm_scale[128];
+
+/* IBM float with libm, independent of kernels' bit tricks */
+static double ref_ibm_to_double(uint32_t ibm) {
+        double d = (double)(ibm & 0xffffff) * ibm_scale[ibm >> 24 & 0x7f];
+        return ibm >> 31 ? -d : d;
+}
+
+/* encoding of decoded IBM float is its normalized form */
+static uint32_t ref_ibm_normalize(uint32_t ibm) {
+        uint32_t sign = ibm & 0x80000000;
+        uint32_t exp = ibm >> 24 & 0x7f;
+        uint32_t frac = ibm & 0xffffff;
+        if (!frac)
+                return sign;
+        while (frac < 0x100000 && exp) {
+                frac <<= 4;
+                --exp;
+        }
+        return sign | exp << 24 | frac;
+}
+
+/* float to IBM with integer arithmetic only. Every float is inside of
+ * normalized IBM range, so only rounding and its carry are handled. */
+static uint32_t ref_float_to_ibm(uint32_t bits) {
+        uint32_t sign = bits & 0x80000000;
+        int be = (int)(bits >> 23 & 0xff);
+        uint64_t m = bits & 0x7fffff;
+        if (be == 0xff)
+                return m ? 0 : sign | 0x7fffffff;
+        int e2 = be ? be - 150 : -149;
+        if (be)
+                m |= 0x800000;
+        if (!m)
+                return sign;
+        int top = 23;
+        while (!(m >> top))
+                --top;
+        /* value is in [2^t, 2^(t+1)), IBM exponent x gives 16^x > value */
+        int t = top + e2;
+        int x = (t >= 0 ? t / 4 : -((-t + 3) / 4)) + 1;
+        int shift = e2 + 24 - 4 * x;
+        uint64_t frac;
+        if (shift >= 0) {
+                frac = m << shift;
+        } else {
+                uint64_t half = 1ull << (-shift - 1);
+                uint64_t rest = m & ((half << 1) - 1);
+                frac = m >> -shift;
+                if (rest > half || (rest == half && frac & 1))
+                        ++frac;
+        }
+        if (frac == 0x1000000) {
+                frac = 0x100000;
+                ++x;
+        }
+        return sign | (uint32_t)(x + 64) << 24 | (uint32_t)frac;
+}
+
+/* double to IBM with libm, covers underflow and overflow too */
+static uint32_t ref_double_to_ibm(double v) {
+        if (isnan(v))
+                return 0;
+        uint32_t sign = signbit(v) ? 0x80000000 : 0;
+        double a = fabs(v);
+        if (isinf(a))
+                return sign | 0x7fffffff;
+        if (a == 0)
+                return sign;
+        int e2;
+        frexp(a, &e2);
+        int exp = (e2 >= 0 ? (e2 + 3) / 4 : -(-e2 / 4)) + 64;
+        if (exp > 127)
+                return sign | 0x7fffffff;
+        if (exp < 0)
+                exp = 0;
+        double frac = nearbyint(ldexp(a, 24 - 4 * (exp - 64)));
+        if (frac == 0x1p24) {
+                frac = 0x1p20;
+                if (++exp > 127)
+                        return sign | 0x7fffffff;
+        }
+        return sign | (uint32_t)exp << 24 | (uint32_t)frac;
+}
+
+/* 64 bit integer encoding, rounded to nearest even and saturated */
+static uint64_t ref_double_to_int64(double v, bool is_signed) {
+        if (isnan(v))
+                return 0;
+        double r = nearbyint(v);
+        if (is_signed)
+                return r >= 0x1p63    ? INT64_MAX
+                       : r <= -0x1p63 ? (uint64_t)INT64_MIN
+                                      : (uint64_t)(int64_t)r;
+        return r >= 0x1p64 ? UINT64_MAX : r <= 0 ? 0 : (uint64_t)r;
+}
+
+static int report(char const *what, bool swap, char const *kernel,
+                  uint64_t value) {
+        printf("%s %s %s: mismatch at 0x%llx\n", what,
+               swap ? "swapped" : "native", kernel,
+               (unsigned long long)value);
+        return 1;
+}
+
+/* fills patterns from index base of every step-th 32 bit value, returns
+ * their number */
+static size_t fill_patterns(uint64_t base, uint64_t step) {
+        uint64_t total = ((1ull << 32) + step - 1) / step;
+        size_t num = total - base < CHUNK ? (size_t)(total - base) : CHUNK;
+        for (size_t i = 0; i < num; ++i)
+                pat[i] = (uint32_t)((base + i) * step);
+        return num;
+}
+
+/* every IBM bit pattern is decoded by every kernel and encoded back */
+static int sweep_ibm(uint64_t step) {
+        for (uint64_t base = 0; base * step < (1ull << 32); base += CHUNK) {
+                size_t num = fill_patterns(base, step);
+                for (size_t i = 0; i < num; ++i) {
+                        ref[i] = ref_ibm_to_double(pat[i]);
+                        flt[i] = (float)ref[i];
+                        expect[i] = ref_ibm_normalize(pat[i]);
+                }
+                fill_src32(pat, num);
+                for (int s = 0; s < 2; ++s) {
+                        long long bad;
+                        for (int k = 0; k < SEIS_SEGY_KERNELS_NUM; ++k) {
+                                if (!seis_segy_ibm_to_double_kernel(
+                                        (SeisSegyKernel)k, dbl, src[s],
+                                        num, s))
+                                        continue;
+                                bad = diff_bits(dbl, ref, sizeof(double),
+                                                num);
+                                if (bad >= 0)
+                                        return report("ibm decode", s,
+                                                      kernel_names[k],
+                                                      pat[bad]);
+                                if (!seis_segy_double_to_ibm_kernel(
+                                        (SeisSegyKernel)k, enc, ref, num,
+                                        s))
+                                        continue;
+                                bad = diff32(enc, expect, num, s);
+                                if (bad >= 0)
+                                        return report("ibm round trip", s,
+                                                      kernel_names[k],
+                                                      pat[bad]);
+                        }
+                        seis_segy_get_float_converter(1, s)(flt_out, src[s],
+                                                            num);
+                        bad = diff_bits(flt_out, flt, sizeof(float), num);
+                        if (bad >= 0)
+                                return report("ibm to float", s, "auto",
+                                              pat[bad]);
+                }
+        }
+        return 0;
+}
+
+/* every IEEE single bit pattern is encoded to IBM by every kernel and goes
+ * through format 5 both ways */
+static int sweep_float(uint64_t step) {
+        for (uint64_t base = 0; base * step < (1ull << 32); base += CHUNK) {
+                size_t num = fill_patterns(base, step);
+                for (size_t i = 0; i < num; ++i) {
+                        memcpy(flt + i, pat + i, sizeof(float));
+                        ref[i] = flt[i];
+                        expect[i] = ref_float_to_ibm(pat[i]);
+                        /* widening quiets signaling NaN, payload stays */
+                        bool nan = (pat[i] & 0x7fffffff) > 0x7f800000;
+                        expect_f32[i] = nan ? pat[i] | 0x400000 : pat[i];
+                }
+                fill_src32(pat, num);
+                for (int s = 0; s < 2; ++s) {
+                        long long bad;
+                        for (int k = 0; k < SEIS_SEGY_KERNELS_NUM; ++k) {
+                                if (!seis_segy_double_to_ibm_kernel(
+                                        (SeisSegyKernel)k, enc, ref, num,
+                                        s))
+                                        continue;
+                                bad = diff32(enc, expect, num, s);
+                                if (bad >= 0)
+                                        return report("float to ibm", s,
+                                                      kernel_names[k],
+                                                      pat[bad]);
+                        }
+                        seis_segy_get_float_encoder(1, s)(enc, flt, num);
+                        bad = diff32(enc, expect, num, s);
+                        if (bad >= 0)
+                                return report("float to ibm", s, "auto",
+                                              pat[bad]);
+                        /* decoding widens exactly, encoding narrows back */
+                        seis_segy_get_converter(5, s)(dbl, src[s], num);
+                        bad = diff_bits(dbl, ref, sizeof(double), num);
+                        if (bad >= 0)
+                                return report("f32 decode", s, "auto",
+                                              pat[bad]);
+                        seis_segy_get_float_converter(5, s)(flt_out, src[s],
+                                                            num);
+                        bad = diff_bits(flt_out, flt, sizeof(float), num);
+                        if (bad >= 0)
+                                return report("f32 float decode", s, "auto",
+                                              pat[bad]);
+                        seis_segy_get_float_encoder(5, s)(enc, flt, num);
+                        bad = diff32(enc, pat, num, s);
+                        if (bad >= 0)
+                                return report("f32 float encode", s, "auto",
+                                              pat[bad]);
+                        seis_segy_get_encoder(5, s)(enc, ref, num);
+                        bad = diff32(enc, expect_f32, num, s);
+                        if (bad >= 0)
+                                return report("f32 encode", s, "auto",
+                                              pat[bad]);
+                }
+        }
+        return 0;
+}
+
+/* random bit patterns and random integers of all magnitudes */
+static void fill_sampled(uint64_t *state, uint64_t *bits) {
+        for (size_t i = 0; i < CHUNK; ++i) {
+                uint64_t x = next_random(state);
+                if (i % 2) {
+                        double u = (double)(x >> 11) * 0x1p-53;
+                        double v = ldexp(u, (int)(x % 67));
+                        v = x >> 10 & 1 ? -v : v;
+                        memcpy(&x, &v, sizeof(x));
+                }
+                bits[i] = x;
+                memcpy(ref + i, &x, sizeof(x));
+        }
+}
+
+static int sweep_sampled(void) {
+        static uint64_t bits[CHUNK], out[CHUNK];
+        uint64_t state = 0;
+        for (size_t done = 0; done < SAMPLED_NUM; done += CHUNK) {
+                fill_sampled(&state, bits);
+                for (size_t i = 0; i < CHUNK; ++i) {
+                        uint64_t s = swap64(bits[i]);
+                        memcpy(src[0] + i * 8, bits + i, 8);
+                        memcpy(src[1] + i * 8, &s, 8);
+                        expect[i] = ref_double_to_ibm(ref[i]);
+                }
+                for (int s = 0; s < 2; ++s) {
+                        long long bad;
+                        for (int k = 0; k < SEIS_SEGY_KERNELS_NUM; ++k) {
+                                if (!seis_segy_double_to_ibm_kernel(
+                                        (SeisSegyKernel)k, enc, ref, CHUNK,
+                                        s))
+                                        continue;
+                                bad = diff32(enc, expect, CHUNK, s);
+                                if (bad >= 0)
+                                        return report("double to ibm", s,
+                                                      kernel_names[k],
+                                                      bits[bad]);
+                        }
+                        seis_segy_get_converter(6, s)(dbl, src[s], CHUNK);
+                        bad = diff_bits(dbl, ref, sizeof(double), CHUNK);
+                        if (bad >= 0)
+                                return report("f64 decode", s, "auto",
+                                              bits[bad]);
+                        seis_segy_get_encoder(6, s)(enc, ref, CHUNK);
+                        bad = diff_bits(enc, src[s], sizeof(double), CHUNK);
+                        if (bad >= 0)
+                                return report("f64 encode", s, "auto",
+                                              bits[bad]);
+                        for (int u = 0; u < 2; ++u) {
+                                int code = u ? 12 : 9;
+                                seis_segy_get_converter(code, s)(dbl, src[s],
+                                                                 CHUNK);
+                                for (size_t i = 0; i < CHUNK; ++i)
+                                        if (dbl[i] !=
+                                            (u ? (double)bits[i]
+                                               : (double)(int64_t)bits[i]))
+                                                return report(
+                                                    "int64 decode", s, "auto",
+                                                    bits[i]);
+                                seis_segy_get_encoder(code, s)(enc, ref,
+                                                               CHUNK);
+                                memcpy(out, enc, CHUNK * sizeof(uint64_t));
+                                for (size_t i = 0; i < CHUNK; ++i)
+                                        if ((s ? swap64(out[i]) : out[i]) !=
+                                            ref_double_to_int64(ref[i], !u))
+                                                return report(
+                                                    "int64 encode", s, "auto",
+                                                    bits[i]);
+                        }
+                }
+        }
+        return 0;
+}
+
+static double seconds(void) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* runs call repeatedly for BENCH_TIME and prints rate of file bytes */
+#define BENCH(label, order, kernel, bytes, call)                              \
+        do {                                                                  \
+                double start = seconds(), elapsed;                            \
+                size_t iters = 0;                                             \
+                do {                                                          \
+                        call;                                                 \
+                        ++iters;                                              \
+                        elapsed = seconds() - start;                          \
+                } while (elapsed < BENCH_TIME);                               \
+                printf("%-14s %-7s %-7s %-6s %8.2f GB/s\n", label, f->name,  \
+                       order, kernel,                                         \
+                       (double)(bytes) * (double)iters / elapsed / 1e9);      \
+        } while (0)
+
+/* samples look like seismic trace scaled to range of format */
+static void fill_bench(struct format const *f) {
+        double amp = f->code == 1 || f->code == 4 || f->code == 5 ||
+                             f->code == 6
+                         ? 1000
+                         : ldexp(1, f->size * 8 - 2);
+        for (size_t i = 0; i < CHUNK; ++i) {
+                ref[i] = amp * sin((double)i * 0.01) * exp(-(double)i / CHUNK);
+                flt[i] = (float)ref[i];
+        }
+}
+
+static void bench(void) {
+        size_t num = sizeof(formats) / sizeof(formats[0]);
+        for (size_t n = 0; n < num; ++n) {
+                struct format const *f = formats + n;
+                size_t bytes = (size_t)f->size * CHUNK;
+                fill_bench(f);
+                for (int s = 0; s < 2; ++s) {
+                        char const *order = s ? "swapped" : "native";
+                        seis_segy_get_encoder(f->code, s)(src[s], ref, CHUNK);
+                        BENCH("decode", order, "auto", bytes,
+                              seis_segy_get_converter(f->code, s)(
+                                  dbl, src[s], CHUNK));
+                        BENCH("decode float", order, "auto", bytes,
+                              seis_segy_get_float_converter(f->code, s)(
+                                  flt_out, src[s], CHUNK));
+                        BENCH("encode", order, "auto", bytes,
+                              seis_segy_get_encoder(f->code, s)(enc, ref,
+                                                                CHUNK));
+                        BENCH("encode float", order, "auto", bytes,
+                              seis_segy_get_float_encoder(f->code, s)(
+                                  enc, flt, CHUNK));
+                        if (f->code != 1)
+                                continue;
+                        for (int k = 0; k < SEIS_SEGY_KERNELS_NUM; ++k) {
+                                SeisSegyKernel kernel = (SeisSegyKernel)k;
+                                if (seis_segy_ibm_to_double_kernel(
+                                        kernel, dbl, src[s], 1, s))
+                                        BENCH("decode", order,
+                                              kernel_names[k], bytes,
+                                              seis_segy_ibm_to_double_kernel(
+                                                  kernel, dbl, src[s], CHUNK,
+                                                  s));
+                                if (seis_segy_double_to_ibm_kernel(
+                                        kernel, enc, ref, 1, s))
+                                        BENCH("encode", order,
+                                              kernel_names[k], bytes,
+                                              seis_segy_double_to_ibm_kernel(
+                                                  kernel, enc, ref, CHUNK,
+                                                  s));
+                        }
+                }
+        }
+}
+
+/* without arguments every 32 bit pattern is checked, number argument
+ * checks every n-th one, --bench measures throughput */
+int main(int argc, char *argv[]) {
+        if (argc > 1 && !strcmp(argv[1], "--bench")) {
+                bench();
+                return 0;
+        }
+        uint64_t step = argc > 1 ? strtoull(argv[1], NULL, 10) : 1;
+        if (!step)
+                return 1;
+        for (int i = 0; i < 128; ++i)
+                ibm_scale[i] = ldexp(1, 4 * i - 280);
+        if (sweep_ibm(step) || sweep_float(step) || sweep_sampled())
+                return 1;
+        return 0;
+}
@@ -0,0 +1,116 @@
+#include "SeisISegy.h"
+#include "SeisOSegy.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* writes all traces of input with fixed point samples */
+static int convert(char const *in_name, char const *out_name) {
+        int result = 1;
+        SeisTrace *trc = NULL;
+        SeisISegy *isgy = seis_isegy_new();
+        SeisOSegy *osgy = seis_osegy_new();
+        if (!isgy || !osgy)
+                goto exit;
+        SeisSegyErr const *ierr = seis_isegy_get_error(isgy);
+        SeisSegyErr const *oerr = seis_osegy_get_error(osgy);
+        seis_isegy_open(isgy, in_name);
+        if (ierr->code)
+                goto exit;
+        SeisSegyBinHdr bh = *seis_isegy_get_binary_header(isgy);
+        bh.format_code = 4;
+        seis_osegy_set_text_header(osgy, seis_isegy_get_text_header(isgy, 0));
+        seis_osegy_set_binary_header(osgy, &bh);
+        seis_osegy_open(osgy, out_name);
+        if (oerr->code)
+                goto exit;
+        while (!seis_isegy_end_of_data(isgy)) {
+                trc = seis_isegy_read_trace(isgy);
+                if (!trc || seis_osegy_write_trace(osgy, trc))
+                        goto exit;
+                seis_trace_unref(&trc);
+        }
+        result = 0;
+exit:
+        if (result && isgy && osgy)
+                printf("%s%s\n", seis_isegy_get_error(isgy)->message,
+                       seis_osegy_get_error(osgy)->message);
+        seis_trace_unref(&trc);
+        seis_isegy_unref(&isgy);
+        seis_osegy_unref(&osgy);
+        return result;
+}
+
+/* compares samples of both files, decoded values should be exact in second
+ * conversion and within mantissa precision in first */
+static int compare(char const *ref_name, char const *test_name, int exact) {
+        int result = 1;
+        SeisTrace *ref = NULL, *test = NULL;
+        SeisISegy *rsgy = seis_isegy_new();
+        SeisISegy *tsgy = seis_isegy_new();
+        if (!rsgy || !tsgy)
+                goto exit;
+        seis_isegy_open(rsgy, ref_name);
+        seis_isegy_open(tsgy, test_name);
+        if (seis_isegy_get_error(rsgy)->code ||
+            seis_isegy_get_error(tsgy)->code)
+                goto exit;
+        if (seis_isegy_get_binary_header(tsgy)->format_code != 4)
+                goto exit;
+        while (!seis_isegy_end_of_data(rsgy)) {
+                ref = seis_isegy_read_trace(rsgy);
+                test = seis_isegy_read_trace(tsgy);
+                if (!ref || !test)
+                        goto exit;
+                long long num = seis_trace_get_samples_num(ref);
+                if (num != seis_trace_get_samples_num(test))
+                        goto exit;
+                double const *r = seis_trace_get_samples_const(ref);
+                double const *t = seis_trace_get_samples_const(test);
+                for (long long i = 0; i < num; ++i)
+                        if (exact ? r[i] != t[i]
+                                  : fabs(r[i] - t[i]) > fabs(r[i]) / 16384) {
+                                printf("sample %lld: %.17g != %.17g\n", i,
+                                       t[i], r[i]);
+                                goto exit;
+                        }
+                seis_trace_unref(&ref);
+                seis_trace_unref(&test);
+        }
+        result = !seis_isegy_end_of_data(tsgy);
+exit:
+        seis_trace_unref(&ref);
+        seis_trace_unref(&test);
+        seis_isegy_unref(&rsgy);
+        seis_isegy_unref(&tsgy);
+        return result;
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        char const *suffixes[] = {"_tmp_fixp1", "_tmp_fixp2"};
+        char *names[2] = {NULL, NULL};
+        int result = 1;
+        for (int i = 0; i < 2; ++i) {
+                names[i] = (char *)malloc(strlen(argv[1]) +
+                                          strlen(suffixes[i]) + 1);
+                if (!names[i])
+                        goto exit;
+                strcpy(names[i], argv[1]);
+                strcat(names[i], suffixes[i]);
+        }
+        if (convert(argv[1], names[0]) || compare(argv[1], names[0], 0))
+                goto exit;
+        if (convert(names[0], names[1]) || compare(names[0], names[1], 1))
+                goto exit;
+        result = 0;
+exit:
+        for (int i = 0; i < 2; ++i) {
+                if (names[i])
+                        remove(names[i]);
+                free(names[i]);
+        }
+        return result;
+}
@@ -0,0 +1,160 @@
+#include "SeisISegy.h"
+#include "SeisISegyColumns.h"
+#include "SeisOSegy.h"
+#include <SeisTrace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VAR_TRACES_NUM 50
+
+static char const *const names[] = {"FFID", "CHAN", "TRC_SEQ_LINE", "CDP_X",
+                                    "SAMP_NUM"};
+
+#define NAMES_NUM (sizeof(names) / sizeof(names[0]))
+
+static void free_columns(SeisSegyHeaderColumn *columns) {
+        for (size_t i = 0; i < NAMES_NUM; ++i) {
+                free(columns[i].ints);
+                free(columns[i].reals);
+        }
+}
+
+/* columns should match headers read one by one */
+static int check(char const *file_name, SeisSegyIOMode mode,
+                 unsigned threads_num) {
+        int result = 1;
+        SeisTraceHeader *hdr = NULL;
+        SeisSegyHeaderColumn columns[NAMES_NUM];
+        SeisSegyErr err;
+        size_t traces_num = 0, i = 0;
+        for (size_t j = 0; j < NAMES_NUM; ++j)
+                columns[j].name = names[j];
+        SeisISegy *sgy = seis_isegy_new();
+        if (!sgy)
+                return 1;
+        seis_isegy_set_io_mode(sgy, mode);
+        seis_isegy_open(sgy, file_name);
+        if (seis_isegy_get_error(sgy)->code)
+                goto exit;
+        if (seis_isegy_extract_header_columns(sgy, columns, NAMES_NUM,
+                                              threads_num, &traces_num, &err))
+                goto exit;
+        for (; !seis_isegy_end_of_data(sgy); ++i) {
+                hdr = seis_isegy_read_trace_header(sgy);
+                if (!hdr || i >= traces_num)
+                        goto exit;
+                for (size_t j = 0; j < NAMES_NUM; ++j) {
+                        long long const *v = seis_trace_header_value_get_int(
+                            seis_trace_header_get(hdr, names[j]));
+                        if (columns[j].is_real || !v ||
+                            columns[j].ints[i] != *v)
+                                goto exit;
+                }
+                seis_trace_header_unref(&hdr);
+        }
+        if (i != traces_num || !traces_num)
+                goto exit;
+        result = 0;
+exit:
+        if (result)
+                printf("%s: columns differ from headers at trace %zu\n",
+                       file_name, i);
+        seis_trace_header_unref(&hdr);
+        free_columns(columns);
+        seis_isegy_unref(&sgy);
+        return result;
+}
+
+static int check_unknown(char const *file_name) {
+        SeisSegyHeaderColumn column = {.name = "NO_SUCH_FIELD"};
+        SeisSegyErr err;
+        size_t traces_num;
+        SeisISegy *sgy = seis_isegy_new();
+        if (!sgy)
+                return 1;
+        seis_isegy_open(sgy, file_name);
+        int result =
+            seis_isegy_get_error(sgy)->code ||
+            seis_isegy_extract_header_columns(sgy, &column, 1, 1, &traces_num,
+                                              &err) !=
+                SEIS_SEGY_ERR_BAD_PARAMS ||
+            column.ints || column.reals;
+        seis_isegy_unref(&sgy);
+        return result;
+}
+
+/* copy of file with different samples number in every trace */
+static int write_variable(char const *in_name, char const *out_name) {
+        int result = 1;
+        SeisTrace *trc = NULL;
+        SeisISegy *isgy = seis_isegy_new();
+        SeisOSegy *osgy = seis_osegy_new();
+        if (!isgy || !osgy)
+                goto exit;
+        seis_isegy_open(isgy, in_name);
+        if (seis_isegy_get_error(isgy)->code)
+                goto exit;
+        SeisSegyBinHdr bh = *seis_isegy_get_binary_header(isgy);
+        bh.SEGY_rev_major_ver = 1;
+        bh.fixed_tr_length = 0;
+        bh.ext_text_headers_num = 0;
+        bh.max_num_add_tr_headers = 0;
+        bh.num_of_trailer_stanza = 0;
+        seis_osegy_set_text_header(osgy, seis_isegy_get_text_header(isgy, 0));
+        seis_osegy_set_binary_header(osgy, &bh);
+        seis_osegy_open(osgy, out_name);
+        if (seis_osegy_get_error(osgy)->code)
+                goto exit;
+        for (long long t = 0; t < VAR_TRACES_NUM; ++t) {
+                SeisTraceHeader *hdr = seis_trace_header_new();
+                if (!hdr)
+                        goto exit;
+                long long samp_num = 1 + t * 7 % 23;
+                seis_trace_header_set_int(hdr, "FFID", t / 10 + 1);
+                seis_trace_header_set_int(hdr, "CHAN", t % 10 + 1);
+                seis_trace_header_set_int(hdr, "TRC_SEQ_LINE", t + 1);
+                seis_trace_header_set_int(hdr, "CDP_X", -t * 25);
+                seis_trace_header_set_int(hdr, "SAMP_NUM", samp_num);
+                trc = seis_trace_new_with_header(samp_num, hdr);
+                if (!trc)
+                        goto exit;
+                memset(seis_trace_get_samples(trc), 0,
+                       samp_num * sizeof(double));
+                if (seis_osegy_write_trace(osgy, trc))
+                        goto exit;
+                seis_trace_unref(&trc);
+        }
+        result = 0;
+exit:
+        if (result && osgy)
+                printf("%s\n", seis_osegy_get_error(osgy)->message);
+        seis_trace_unref(&trc);
+        seis_isegy_unref(&isgy);
+        seis_osegy_unref(&osgy);
+        return result;
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        unsigned const threads[] = {1, 3, 0};
+        for (size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); ++i)
+                if (check(argv[1], SEIS_SEGY_IO_STDIO, threads[i]) ||
+                    check(argv[1], SEIS_SEGY_IO_MMAP, threads[i]))
+                        return 1;
+        if (check_unknown(argv[1]))
+                return 1;
+        char const *suffix = "_tmp_columns";
+        char *var_name = (char *)malloc(strlen(argv[1]) + strlen(suffix) + 1);
+        if (!var_name)
+                return 1;
+        strcpy(var_name, argv[1]);
+        strcat(var_name, suffix);
+        int result = write_variable(argv[1], var_name) ||
+                     check(var_name, SEIS_SEGY_IO_STDIO, 1) ||
+                     check(var_name, SEIS_SEGY_IO_MMAP, 1);
+        remove(var_name);
+        free(var_name);
+        return result;
+}
@@ -0,0 +1,96 @@
+#include "SeisISegy.h"
+#include <SeisTrace.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define TRACES_NUM 5
+
+static char const *const wanted[] = {"FFID", "CHAN", "OFFSET"};
+
+#define WANTED_NUM (sizeof(wanted) / sizeof(wanted[0]))
+
+static bool has_field(SeisTraceHeader const *hdr, char const *name) {
+        SeisTraceHeaderValue v = seis_trace_header_get(hdr, name);
+        return seis_trace_header_value_get_int(v) ||
+               seis_trace_header_value_get_real(v);
+}
+
+static bool same_int(SeisTraceHeader const *a, SeisTraceHeader const *b,
+                     char const *name) {
+        long long const *l =
+            seis_trace_header_value_get_int(seis_trace_header_get(a, name));
+        long long const *r =
+            seis_trace_header_value_get_int(seis_trace_header_get(b, name));
+        return l && r && *l == *r;
+}
+
+/* projected headers keep wanted fields and samples number only */
+static int check_projected(SeisTraceHeader const *hdr,
+                           SeisTraceHeader const *ref) {
+        for (size_t i = 0; i < WANTED_NUM; ++i)
+                if (!same_int(hdr, ref, wanted[i]))
+                        return 1;
+        if (!same_int(hdr, ref, "SAMP_NUM"))
+                return 1;
+        return has_field(hdr, "TRC_SEQ_LINE") || has_field(hdr, "CDP_X");
+}
+
+static int check(char const *name, bool before_open) {
+        int result = 1;
+        SeisTraceHeader *refs[TRACES_NUM] = {NULL};
+        SeisTraceHeader *hdr = NULL;
+        SeisISegy *sgy = seis_isegy_new();
+        if (!sgy)
+                return 1;
+        SeisSegyErr const *err = seis_isegy_get_error(sgy);
+        seis_isegy_open(sgy, name);
+        if (err->code)
+                goto exit;
+        for (size_t i = 0; i < TRACES_NUM; ++i) {
+                refs[i] = seis_isegy_read_trace_header(sgy);
+                if (!refs[i] || !has_field(refs[i], "TRC_SEQ_LINE"))
+                        goto exit;
+        }
+        seis_isegy_unref(&sgy);
+        sgy = seis_isegy_new();
+        if (!sgy)
+                goto exit;
+        err = seis_isegy_get_error(sgy);
+        if (before_open &&
+            seis_isegy_set_header_fields(sgy, wanted, WANTED_NUM))
+                goto exit;
+        seis_isegy_open(sgy, name);
+        if (err->code)
+                goto exit;
+        if (!before_open &&
+            seis_isegy_set_header_fields(sgy, wanted, WANTED_NUM))
+                goto exit;
+        for (size_t i = 0; i < TRACES_NUM; ++i) {
+                hdr = seis_isegy_read_trace_header(sgy);
+                if (!hdr || check_projected(hdr, refs[i]))
+                        goto exit;
+                seis_trace_header_unref(&hdr);
+        }
+        /* all fields are back after reset */
+        if (seis_isegy_set_header_fields(sgy, NULL, 0))
+                goto exit;
+        seis_isegy_rewind(sgy);
+        hdr = seis_isegy_read_trace_header(sgy);
+        if (!hdr || !same_int(hdr, refs[0], "TRC_SEQ_LINE"))
+                goto exit;
+        result = 0;
+exit:
+        if (result && sgy)
+                printf("%s\n", err->message);
+        seis_trace_header_unref(&hdr);
+        for (size_t i = 0; i < TRACES_NUM; ++i)
+                seis_trace_header_unref(&refs[i]);
+        seis_isegy_unref(&sgy);
+        return result;
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        return check(argv[1], true) || check(argv[1], false);
+}
@@ -0,0 +1,175 @@
+#include "SeisISegy.h"
+#include "SeisOSegy.h"
+#include <SeisTrace.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACES_NUM 3
+
+struct field {
+        char const *name;
+        int offset;
+        enum FORMAT format;
+        long long int_val;
+        double real_val;
+};
+
+/* remapped fields of every format over unused part of main header */
+static struct field const fields[] = {
+    {"T_I8", 181, i8, -5, 0},
+    {"T_U8", 182, u8, 200, 0},
+    {"T_I16", 183, i16, -1234, 0},
+    {"T_U16", 185, u16, 60000, 0},
+    {"T_I32", 187, i32, -123456789, 0},
+    {"T_U32", 191, u32, 4000000000, 0},
+    {"T_I64", 195, i64, -(1ll << 40) - 3, 0},
+    {"T_U64", 203, u64, (1ll << 50) + 7, 0},
+    {"T_F32", 211, f32, 0, 1.5},
+    {"T_F64", 215, f64, 0, -2.25e10}};
+
+#define FIELDS_NUM (sizeof(fields) / sizeof(fields[0]))
+
+static bool is_real(struct field const *f) {
+        return f->format == f32 || f->format == f64;
+}
+
+static int write_file(char const *in_name, char const *out_name,
+                      int32_t endianness) {
+        int result = 1;
+        SeisTrace *trc = NULL;
+        SeisISegy *isgy = seis_isegy_new();
+        SeisOSegy *osgy = seis_osegy_new();
+        if (!isgy || !osgy)
+                goto exit;
+        seis_isegy_open(isgy, in_name);
+        if (seis_isegy_get_error(isgy)->code)
+                goto exit;
+        SeisSegyBinHdr bh = *seis_isegy_get_binary_header(isgy);
+        bh.endianness = endianness;
+        seis_osegy_set_text_header(osgy, seis_isegy_get_text_header(isgy, 0));
+        seis_osegy_set_binary_header(osgy, &bh);
+        /* writer is remapped before open */
+        for (size_t i = 0; i < FIELDS_NUM; ++i)
+                if (seis_osegy_remap_trace_header(osgy, fields[i].name, 1,
+                                                  fields[i].offset,
+                                                  fields[i].format))
+                        goto exit;
+        seis_osegy_open(osgy, out_name);
+        if (seis_osegy_get_error(osgy)->code)
+                goto exit;
+        for (size_t t = 0; t < TRACES_NUM; ++t) {
+                trc = seis_isegy_read_trace(isgy);
+                if (!trc)
+                        goto exit;
+                SeisTraceHeader *hdr = seis_trace_get_header(trc);
+                for (size_t i = 0; i < FIELDS_NUM; ++i)
+                        if (is_real(&fields[i]))
+                                seis_trace_header_set_real(
+                                    hdr, fields[i].name, fields[i].real_val);
+                        else
+                                seis_trace_header_set_int(
+                                    hdr, fields[i].name, fields[i].int_val + t);
+                if (seis_osegy_write_trace(osgy, trc))
+                        goto exit;
+                seis_trace_unref(&trc);
+        }
+        result = 0;
+exit:
+        if (result && osgy)
+                printf("%s\n", seis_osegy_get_error(osgy)->message);
+        seis_trace_unref(&trc);
+        seis_isegy_unref(&isgy);
+        seis_osegy_unref(&osgy);
+        return result;
+}
+
+static int check_header(SeisTraceHeader const *hdr, size_t t) {
+        for (size_t i = 0; i < FIELDS_NUM; ++i) {
+                SeisTraceHeaderValue v =
+                    seis_trace_header_get(hdr, fields[i].name);
+                bool ok;
+                if (is_real(&fields[i])) {
+                        double const *d = seis_trace_header_value_get_real(v);
+                        ok = d && *d == fields[i].real_val;
+                } else {
+                        long long const *l = seis_trace_header_value_get_int(v);
+                        ok = l && *l == fields[i].int_val + (long long)t;
+                }
+                if (!ok) {
+                        printf("trace %zu: wrong %s\n", t, fields[i].name);
+                        return 1;
+                }
+        }
+        return 0;
+}
+
+/* integer bytes in file follow byte order of binary header */
+static int check_raw(SeisSegyRawTrace const *raw, size_t t) {
+        unsigned char const *b =
+            (unsigned char const *)raw->headers + fields[4].offset - 1;
+        uint32_t bits = 0;
+        for (int j = 0; j < 4; ++j)
+                bits = bits << 8 | b[raw->big_endian ? j : 3 - j];
+        if ((int32_t)bits != fields[4].int_val + (long long)t) {
+                printf("trace %zu: wrong raw %s\n", t, fields[4].name);
+                return 1;
+        }
+        return 0;
+}
+
+static int check_file(char const *name) {
+        int result = 1;
+        SeisTrace *trc = NULL;
+        SeisISegy *sgy = seis_isegy_new();
+        if (!sgy)
+                return 1;
+        seis_isegy_open(sgy, name);
+        if (seis_isegy_get_error(sgy)->code)
+                goto exit;
+        /* reader is remapped after open */
+        for (size_t i = 0; i < FIELDS_NUM; ++i)
+                if (seis_isegy_remap_trace_header(sgy, fields[i].name, 1,
+                                                  fields[i].offset,
+                                                  fields[i].format))
+                        goto exit;
+        for (size_t t = 0; t < TRACES_NUM; ++t) {
+                trc = seis_isegy_read_trace(sgy);
+                if (!trc || check_header(seis_trace_get_header(trc), t))
+                        goto exit;
+                seis_trace_unref(&trc);
+        }
+        seis_isegy_rewind(sgy);
+        SeisSegyRawTrace raw;
+        for (size_t t = 0; t < TRACES_NUM; ++t)
+                if (seis_isegy_read_raw_trace(sgy, &raw) || check_raw(&raw, t))
+                        goto exit;
+        result = 0;
+exit:
+        if (result)
+                printf("%s\n", seis_isegy_get_error(sgy)->message);
+        seis_trace_unref(&trc);
+        seis_isegy_unref(&sgy);
+        return result;
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        char const *suffix = "_tmp_hdr_schema";
+        char *tmp_name = (char *)malloc(strlen(argv[1]) + strlen(suffix) + 1);
+        if (!tmp_name)
+                return 1;
+        strcpy(tmp_name, argv[1]);
+        strcat(tmp_name, suffix);
+        int32_t const orders[] = {0, 0x01020304};
+        int result = 0;
+        for (size_t i = 0; i < 2 && !result; ++i)
+                result = write_file(argv[1], tmp_name, orders[i]) ||
+                         check_file(tmp_name);
+        remove(tmp_name);
+        free(tmp_name);
+        return result;
+}
@@ -0,0 +1,118 @@
+#include "SeisISegy.h"
+#include <SeisTrace.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACES_NUM 4
+
+static uint32_t const edge[] = {
+    0x00000000, 0x80000000, 0x7fffffff, 0xffffffff, 0x00000001,
+    0x80000001, 0x41100000, 0xc1100000, 0x00100000, 0x7f0fffff,
+    0x41000001, 0x00ffffff, 0x80ffffff, 0x40000000, 0xc0000000};
+
+/* formula used before vector kernels */
+static double reference(uint32_t ibm) {
+        int sign = ibm >> 31 ? -1 : 1;
+        int exp = ibm >> 24 & 0x7f;
+        uint32_t fraction = ibm & 0x00ffffff;
+        return fraction / pow(2, 24) * pow(16, exp - 64) * sign;
+}
+
+static uint32_t pattern(size_t i) {
+        size_t edge_num = sizeof(edge) / sizeof(edge[0]);
+        if (i < edge_num)
+                return edge[i];
+        /* values are spread over all exponents and signs */
+        return (uint32_t)(i * 2654435761u) ^ (uint32_t)(i << 7);
+}
+
+static int check(SeisTrace const *trc, size_t first) {
+        double const *samples = seis_trace_get_samples_const(trc);
+        for (long long i = 0; i < seis_trace_get_samples_num(trc); ++i) {
+                double ref = reference(pattern(first + i));
+                if (memcmp(&ref, samples + i, sizeof(ref))) {
+                        printf("sample %lld: %a != %a\n", i, samples[i], ref);
+                        return 1;
+                }
+        }
+        return 0;
+}
+
+int main(int argc, char *argv[]) {
+        char *tmp_name = NULL;
+        SeisTrace *trc = NULL;
+        if (argc < 2)
+                return 1;
+        SeisISegy *sgy = seis_isegy_new();
+        if (!sgy)
+                return 1;
+        SeisSegyErr const *err = seis_isegy_get_error(sgy);
+        seis_isegy_open(sgy, argv[1]);
+        if (err->code)
+                goto error;
+        size_t samp_num = seis_isegy_get_binary_header(sgy)->samp_per_tr;
+        size_t offsets[TRACES_NUM];
+        for (size_t i = 0; i < TRACES_NUM; ++i)
+                offsets[i] = seis_isegy_get_trace_offset(sgy, i);
+        seis_isegy_unref(&sgy);
+        /* copy of file with samples replaced by test patterns */
+        tmp_name = (char *)malloc(strlen(argv[1]) + strlen("_tmp_ibm") + 1);
+        if (!tmp_name)
+                return 1;
+        strcpy(tmp_name, argv[1]);
+        strcat(tmp_name, "_tmp_ibm");
+        FILE *in = fopen(argv[1], "rb");
+        FILE *out = fopen(tmp_name, "wb");
+        if (!in || !out)
+                return 1;
+        int c;
+        while ((c = fgetc(in)) != EOF)
+                fputc(c, out);
+        fclose(in);
+        for (size_t t = 0; t < TRACES_NUM; ++t) {
+                fseek(out, offsets[t] + 240, SEEK_SET);
+                for (size_t i = 0; i < samp_num; ++i) {
+                        uint32_t v = pattern(t * samp_num + i);
+                        unsigned char be[4] = {v >> 24, v >> 16, v >> 8, v};
+                        fwrite(be, 1, 4, out);
+                }
+        }
+        fclose(out);
+        sgy = seis_isegy_new();
+        if (!sgy)
+                goto error;
+        err = seis_isegy_get_error(sgy);
+        seis_isegy_open(sgy, tmp_name);
+        if (err->code)
+                goto error;
+        for (size_t t = 0; t < TRACES_NUM; ++t) {
+                trc = seis_isegy_read_trace(sgy);
+                if (!trc || check(trc, t * samp_num))
+                        goto error;
+                seis_trace_unref(&trc);
+        }
+        /* positional reading decodes in place */
+        SeisSegyErr perr;
+        for (size_t t = 0; t < TRACES_NUM; ++t) {
+                trc = seis_isegy_read_trace_at(sgy, offsets[t], NULL, &perr);
+                if (!trc || check(trc, t * samp_num))
+                        goto error;
+                seis_trace_unref(&trc);
+        }
+        remove(tmp_name);
+        free(tmp_name);
+        seis_isegy_unref(&sgy);
+        return 0;
+error:
+        seis_trace_unref(&trc);
+        if (sgy)
+                printf("%s\n", err->message);
+        if (tmp_name)
+                remove(tmp_name);
+        free(tmp_name);
+        seis_isegy_unref(&sgy);
+        return 1;
+}
@@ -0,0 +1,200 @@
+#include "SeisISegy.h"
+#include "SeisOSegy.h"
+#include <SeisTrace.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACES_NUM 4
+
+static double const edge[] = {0.0,
+                              -0.0,
+                              1.0,
+                              -1.0,
+                              16.0,
+                              0.0625,
+                              0.1,
+                              -123.456,
+                              /* rounding ties go to even fraction */
+                              1.0 + 0x1p-21,
+                              1.0 + 0x3p-21,
+                              /* rounding carries to next exponent */
+                              1.0 - 0x1p-30,
+                              -(16.0 - 0x1p-30),
+                              /* biggest IBM value and overflow */
+                              0x0.ffffffp252,
+                              0x0.fffffff8p252,
+                              0x1p252,
+                              1e300,
+                              -1e300,
+                              INFINITY,
+                              -INFINITY,
+                              NAN,
+                              /* smallest normalized value and underflow */
+                              0x1p-260,
+                              0x1p-270,
+                              -0x1p-270,
+                              0x1p-281,
+                              0x3p-282,
+                              0x1p-285,
+                              1e-80,
+                              -1e-80,
+                              1e-300,
+                              0x1p-1074};
+
+/* exact encoding written with libm */
+static uint32_t reference(double v) {
+        if (isnan(v))
+                return 0;
+        uint32_t sign = signbit(v) ? 0x80000000 : 0;
+        double a = fabs(v);
+        if (isinf(a))
+                return sign | 0x7fffffff;
+        if (a == 0)
+                return sign;
+        int e2;
+        frexp(a, &e2);
+        /* smallest power of 16 above value */
+        int exp = (e2 >= 0 ? (e2 + 3) / 4 : -(-e2 / 4)) + 64;
+        if (exp > 127)
+                return sign | 0x7fffffff;
+        if (exp < 0)
+                exp = 0;
+        double frac = nearbyint(ldexp(a, 24 - 4 * (exp - 64)));
+        if (frac == 0x1p24) {
+                frac = 0x1p20;
+                if (++exp > 127)
+                        return sign | 0x7fffffff;
+        }
+        return sign | (uint32_t)exp << 24 | (uint32_t)frac;
+}
+
+/* edge values followed by random bit patterns of all exponents */
+static double value(size_t i, bool single) {
+        size_t edge_num = sizeof(edge) / sizeof(edge[0]);
+        double v;
+        if (i < edge_num) {
+                v = edge[i];
+        } else {
+                uint64_t x = i * 0x9e3779b97f4a7c15ull;
+                x ^= x >> 29;
+                x *= 0xbf58476d1ce4e5b9ull;
+                x ^= x >> 32;
+                memcpy(&v, &x, sizeof(v));
+        }
+        return single ? (float)v : v;
+}
+
+static int write_file(char const *in_name, char const *out_name,
+                      int32_t endianness, bool single) {
+        int result = 1;
+        SeisTrace *trc = NULL;
+        SeisSegyFloatTrace *ftrc = NULL;
+        SeisISegy *isgy = seis_isegy_new();
+        SeisOSegy *osgy = seis_osegy_new();
+        if (!isgy || !osgy)
+                goto exit;
+        seis_isegy_open(isgy, in_name);
+        if (seis_isegy_get_error(isgy)->code)
+                goto exit;
+        SeisSegyBinHdr bh = *seis_isegy_get_binary_header(isgy);
+        bh.endianness = endianness;
+        seis_osegy_set_text_header(osgy, seis_isegy_get_text_header(isgy, 0));
+        seis_osegy_set_binary_header(osgy, &bh);
+        seis_osegy_open(osgy, out_name);
+        if (seis_osegy_get_error(osgy)->code)
+                goto exit;
+        for (size_t t = 0; t < TRACES_NUM; ++t) {
+                size_t first = t * bh.samp_per_tr;
+                if (single) {
+                        ftrc = seis_isegy_read_trace_float(isgy);
+                        if (!ftrc)
+                                goto exit;
+                        float *s = seis_segy_float_trace_get_samples(ftrc);
+                        for (long i = 0; i < bh.samp_per_tr; ++i)
+                                s[i] = (float)value(first + i, true);
+                        if (seis_osegy_write_trace_float(osgy, ftrc))
+                                goto exit;
+                        seis_segy_float_trace_unref(&ftrc);
+                } else {
+                        trc = seis_isegy_read_trace(isgy);
+                        if (!trc)
+                                goto exit;
+                        double *s = seis_trace_get_samples(trc);
+                        for (long i = 0; i < bh.samp_per_tr; ++i)
+                                s[i] = value(first + i, false);
+                        if (seis_osegy_write_trace(osgy, trc))
+                                goto exit;
+                        seis_trace_unref(&trc);
+                }
+        }
+        result = 0;
+exit:
+        seis_trace_unref(&trc);
+        seis_segy_float_trace_unref(&ftrc);
+        seis_isegy_unref(&isgy);
+        seis_osegy_unref(&osgy);
+        return result;
+}
+
+static int check_file(char const *name, bool single) {
+        int result = 1;
+        SeisISegy *sgy = seis_isegy_new();
+        if (!sgy)
+                return 1;
+        seis_isegy_open(sgy, name);
+        if (seis_isegy_get_error(sgy)->code)
+                goto exit;
+        SeisSegyRawTrace raw;
+        for (size_t t = 0; t < TRACES_NUM; ++t) {
+                if (seis_isegy_read_raw_trace(sgy, &raw))
+                        goto exit;
+                for (long long i = 0; i < raw.samp_num; ++i) {
+                        unsigned char const *b =
+                            (unsigned char const *)raw.samples + i * 4;
+                        uint32_t ibm =
+                            raw.big_endian
+                                ? (uint32_t)b[0] << 24 | b[1] << 16 |
+                                      b[2] << 8 | b[3]
+                                : (uint32_t)b[3] << 24 | b[2] << 16 |
+                                      b[1] << 8 | b[0];
+                        double v = value(t * raw.samp_num + i, single);
+                        if (ibm != reference(v)) {
+                                printf("%a: %08x != %08x\n", v, ibm,
+                                       reference(v));
+                                goto exit;
+                        }
+                }
+        }
+        result = 0;
+exit:
+        seis_isegy_unref(&sgy);
+        return result;
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        /* underflow keeps unnormalized fraction with zero exponent */
+        if (reference(1e-80) != 0x00004be3 || reference(-1e-80) != 0x80004be3)
+                return 1;
+        char const *suffix = "_tmp_ibm_enc";
+        char *tmp_name = (char *)malloc(strlen(argv[1]) + strlen(suffix) + 1);
+        if (!tmp_name)
+                return 1;
+        strcpy(tmp_name, argv[1]);
+        strcat(tmp_name, suffix);
+        int32_t const orders[] = {0, 0x01020304};
+        int result = 0;
+        for (size_t i = 0; i < 4 && !result; ++i) {
+                bool single = i % 2;
+                result = write_file(argv[1], tmp_name, orders[i / 2], single) ||
+                         check_file(tmp_name, single);
+        }
+        remove(tmp_name);
+        free(tmp_name);
+        return result;
+}
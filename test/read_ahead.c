@@ -0,0 +1,70 @@
+#include "SeisISegy.h"
+#include <SeisTrace.h>
+#include <stdio.h>
+#include <string.h>
+
+static int same_trace(SeisISegy *a, SeisISegy *b) {
+        SeisTrace *ta = seis_isegy_read_trace(a);
+        SeisTrace *tb = seis_isegy_read_trace(b);
+        int res = ta && tb;
+        if (res) {
+                long long num = seis_trace_get_samples_num(ta);
+                res = num == seis_trace_get_samples_num(tb) &&
+                      !memcmp(seis_trace_get_samples_const(ta),
+                              seis_trace_get_samples_const(tb),
+                              num * sizeof(double));
+        }
+        seis_trace_unref(&ta);
+        seis_trace_unref(&tb);
+        return res;
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        SeisISegy *plain = seis_isegy_new();
+        if (!plain)
+                return 1;
+        SeisISegy *ahead = seis_isegy_new();
+        if (!ahead)
+                return 1;
+        SeisSegyErr const *perr = seis_isegy_get_error(plain);
+        SeisSegyErr const *aerr = seis_isegy_get_error(ahead);
+        seis_isegy_open(plain, argv[1]);
+        if (perr->code)
+                goto error;
+        /* small buffer makes read ahead switch blocks often */
+        seis_isegy_set_buffer_size(ahead, 5003);
+        seis_isegy_set_read_ahead(ahead, true);
+        seis_isegy_open(ahead, argv[1]);
+        if (aerr->code)
+                goto error;
+        size_t middle = 0, traces_num = 0;
+        while (!seis_isegy_end_of_data(plain)) {
+                if (seis_isegy_end_of_data(ahead))
+                        goto error;
+                if (traces_num++ == 5)
+                        middle = seis_isegy_get_offset(plain);
+                if (!same_trace(plain, ahead))
+                        goto error;
+        }
+        if (!seis_isegy_end_of_data(ahead))
+                goto error;
+        /* read ahead must follow position changes */
+        seis_isegy_rewind(plain);
+        seis_isegy_rewind(ahead);
+        if (!same_trace(plain, ahead))
+                goto error;
+        seis_isegy_set_offset(plain, middle);
+        seis_isegy_set_offset(ahead, middle);
+        if (!same_trace(plain, ahead) || !same_trace(plain, ahead))
+                goto error;
+        seis_isegy_unref(&plain);
+        seis_isegy_unref(&ahead);
+        return 0;
+error:
+        printf("%s\n%s\n", perr->message, aerr->message);
+        seis_isegy_unref(&plain);
+        seis_isegy_unref(&ahead);
+        return 1;
+}
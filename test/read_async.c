@@ -0,0 +1,60 @@
+#include "SeisISegy.h"
+#include "SeisISegyAsync.h"
+#include "ref_traces.h"
+#include <SeisTrace.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define QUEUE_DEPTH 8
+
+static int check(SeisISegy *sgy, RefTraces const *refs) {
+        int result = 1;
+        size_t num = refs->num;
+        size_t *indices = NULL;
+        char *seen = NULL;
+        SeisTrace *trc = NULL;
+        SeisISegyAsync *as = seis_isegy_async_new(sgy, QUEUE_DEPTH);
+        if (!as)
+                return 1;
+        SeisSegyErr const *err = seis_isegy_async_get_error(as);
+        indices = malloc(num * sizeof(size_t));
+        seen = calloc(num * 2, 1);
+        if (!indices || !seen)
+                goto exit;
+        /* first half of sequence numbers maps to reversed indices, second
+         * half to offsets in file order */
+        for (size_t i = 0; i < num; ++i)
+                indices[i] = num - 1 - i;
+        if (seis_isegy_async_submit_indices(as, indices, num) ||
+            seis_isegy_async_submit_offsets(as, refs->offsets, num) ||
+            seis_isegy_async_pending(as) != num * 2)
+                goto exit;
+        while (seis_isegy_async_pending(as)) {
+                size_t seq;
+                trc = seis_isegy_async_reap(as, &seq);
+                if (!trc || seq >= num * 2 || seen[seq])
+                        goto exit;
+                seen[seq] = 1;
+                size_t idx = seq < num ? indices[seq] : seq - num;
+                if (ref_traces_compare(trc, refs->traces[idx]))
+                        goto exit;
+                seis_trace_unref(&trc);
+        }
+        if (seis_isegy_async_reap(as, NULL))
+                goto exit;
+        result = 0;
+exit:
+        if (result)
+                printf("asynchronous reading differs: %s\n", err->message);
+        seis_trace_unref(&trc);
+        seis_isegy_async_unref(&as);
+        free(indices);
+        free(seen);
+        return result;
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        return ref_traces_check_modes(argv[1], check);
+}
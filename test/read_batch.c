@@ -0,0 +1,60 @@
+#include "SeisISegy.h"
+#include "SeisISegyBatch.h"
+#include "ref_traces.h"
+#include <SeisTrace.h>
+#include <stdio.h>
+
+#define BATCH_SIZE 7
+
+static int check_threads(SeisISegy *sgy, SeisTrace *const *refs,
+                         size_t traces_num, unsigned threads_num) {
+        SeisTrace *traces[BATCH_SIZE] = {NULL};
+        SeisISegyBatch *batch = seis_isegy_batch_new(sgy, threads_num);
+        if (!batch)
+                return 1;
+        SeisSegyErr const *err = seis_isegy_batch_get_error(batch);
+        if (threads_num &&
+            seis_isegy_batch_get_threads_num(batch) != threads_num)
+                goto error;
+        for (size_t first = 0; first < traces_num; first += BATCH_SIZE) {
+                size_t num = traces_num - first < BATCH_SIZE
+                                 ? traces_num - first
+                                 : BATCH_SIZE;
+                if (seis_isegy_batch_read(batch, first, num, traces))
+                        goto error;
+                for (size_t i = 0; i < num; ++i) {
+                        if (ref_traces_compare(traces[i], refs[first + i]))
+                                goto error;
+                        seis_trace_unref(&traces[i]);
+                }
+        }
+        /* batch crossing end of file fails and gives no traces */
+        if (seis_isegy_batch_read(batch, traces_num - 1, 2, traces) !=
+                SEIS_SEGY_ERR_FILE_READ ||
+            traces[0] || traces[1])
+                goto error;
+        seis_isegy_batch_unref(&batch);
+        return 0;
+error:
+        printf("%s\n", err->message);
+        for (size_t i = 0; i < BATCH_SIZE; ++i)
+                seis_trace_unref(&traces[i]);
+        seis_isegy_batch_unref(&batch);
+        return 1;
+}
+
+/* batch traces should match sequentially read ones */
+static int check(SeisISegy *sgy, RefTraces const *refs) {
+        /* last batch is incomplete */
+        if (refs->num < 2 || refs->num % BATCH_SIZE == 0)
+                return 1;
+        return check_threads(sgy, refs->traces, refs->num, 1) ||
+               check_threads(sgy, refs->traces, refs->num, 4) ||
+               check_threads(sgy, refs->traces, refs->num, 0);
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        return ref_traces_check_modes(argv[1], check);
+}
@@ -0,0 +1,69 @@
+#include "SeisISegy.h"
+#include <SeisTrace.h>
+#include <stdio.h>
+#include <string.h>
+
+/* buffer smaller than trace, buffer not multiple of trace and default one */
+static size_t const sizes[] = {100, 5003, 0};
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        size_t sizes_num = sizeof(sizes) / sizeof(sizes[0]);
+        SeisISegy *sgy[sizeof(sizes) / sizeof(sizes[0])] = {NULL};
+        SeisTrace *trc[sizeof(sizes) / sizeof(sizes[0])] = {NULL};
+        SeisSegyErr const *err = NULL;
+        for (size_t i = 0; i < sizes_num; ++i) {
+                sgy[i] = seis_isegy_new();
+                if (!sgy[i])
+                        goto error;
+                err = seis_isegy_get_error(sgy[i]);
+                seis_isegy_set_buffer_size(sgy[i], sizes[i]);
+                seis_isegy_open(sgy[i], argv[1]);
+                if (err->code)
+                        goto error;
+        }
+        size_t traces_num = 0;
+        while (!seis_isegy_end_of_data(sgy[0])) {
+                for (size_t i = 0; i < sizes_num; ++i) {
+                        err = seis_isegy_get_error(sgy[i]);
+                        if (seis_isegy_end_of_data(sgy[i]))
+                                goto error;
+                        /* every other trace exercises skipping */
+                        if (traces_num % 2) {
+                                SeisTraceHeader *hdr =
+                                    seis_isegy_read_trace_header(sgy[i]);
+                                seis_trace_header_unref(&hdr);
+                        } else {
+                                trc[i] = seis_isegy_read_trace(sgy[i]);
+                        }
+                        if (err->code)
+                                goto error;
+                }
+                if (!(traces_num % 2))
+                        for (size_t i = 1; i < sizes_num; ++i) {
+                                long long num =
+                                    seis_trace_get_samples_num(trc[0]);
+                                if (num != seis_trace_get_samples_num(trc[i]))
+                                        goto error;
+                                if (memcmp(seis_trace_get_samples_const(trc[0]),
+                                           seis_trace_get_samples_const(trc[i]),
+                                           num * sizeof(double)))
+                                        goto error;
+                        }
+                for (size_t i = 0; i < sizes_num; ++i)
+                        seis_trace_unref(&trc[i]);
+                ++traces_num;
+        }
+        for (size_t i = 0; i < sizes_num; ++i)
+                seis_isegy_unref(&sgy[i]);
+        return 0;
+error:
+        if (err)
+                printf("%s\n", err->message);
+        for (size_t i = 0; i < sizes_num; ++i) {
+                seis_trace_unref(&trc[i]);
+                seis_isegy_unref(&sgy[i]);
+        }
+        return 1;
+}
@@ -0,0 +1,75 @@
+#include "SeisISegy.h"
+#include <SeisTrace.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define READERS_NUM 3
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        SeisISegy *sgy[READERS_NUM] = {NULL};
+        SeisTrace *trc[READERS_NUM] = {NULL};
+        SeisSegyErr const *err = NULL;
+        for (int i = 0; i < READERS_NUM; ++i) {
+                sgy[i] = seis_isegy_new();
+                if (!sgy[i])
+                        goto error;
+                err = seis_isegy_get_error(sgy[i]);
+                if (i)
+                        seis_isegy_set_io_mode(sgy[i], SEIS_SEGY_IO_DIRECT);
+                /* small buffer leaves some records without aligned block */
+                if (i == 1)
+                        seis_isegy_set_buffer_size(sgy[i], 8192);
+                if (i == 2)
+                        seis_isegy_set_read_ahead(sgy[i], true);
+                seis_isegy_open(sgy[i], argv[1]);
+                if (err->code)
+                        goto error;
+        }
+        size_t last = 0;
+        bool again = true;
+        while (!seis_isegy_end_of_data(sgy[0])) {
+                last = seis_isegy_get_offset(sgy[0]);
+                for (int i = 0; i < READERS_NUM; ++i) {
+                        err = seis_isegy_get_error(sgy[i]);
+                        if (seis_isegy_get_offset(sgy[i]) != last)
+                                goto error;
+                        trc[i] = seis_isegy_read_trace(sgy[i]);
+                        if (err->code)
+                                goto error;
+                }
+                for (int i = 1; i < READERS_NUM; ++i) {
+                        long long num = seis_trace_get_samples_num(trc[0]);
+                        if (num != seis_trace_get_samples_num(trc[i]))
+                                goto error;
+                        if (memcmp(seis_trace_get_samples_const(trc[0]),
+                                   seis_trace_get_samples_const(trc[i]),
+                                   num * sizeof(double)))
+                                goto error;
+                }
+                for (int i = 0; i < READERS_NUM; ++i)
+                        seis_trace_unref(&trc[i]);
+                /* last trace is read second time after going back */
+                if (seis_isegy_end_of_data(sgy[0]) && again) {
+                        again = false;
+                        for (int i = 0; i < READERS_NUM; ++i)
+                                seis_isegy_set_offset(sgy[i], last);
+                }
+        }
+        for (int i = 0; i < READERS_NUM; ++i)
+                if (!seis_isegy_end_of_data(sgy[i]))
+                        goto error;
+        for (int i = 0; i < READERS_NUM; ++i)
+                seis_isegy_unref(&sgy[i]);
+        return 0;
+error:
+        if (err)
+                printf("%s\n", err->message);
+        for (int i = 0; i < READERS_NUM; ++i) {
+                seis_trace_unref(&trc[i]);
+                seis_isegy_unref(&sgy[i]);
+        }
+        return 1;
+}
@@ -0,0 +1,163 @@
+#include "SeisISegy.h"
+#include "SeisSegyBackend.h"
+#include <SeisTrace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+/* writes file as two gzip members like parallel compressors do. Samples
+ * compress too well to get many deflate blocks, so blocks are ended
+ * often. */
+static int compress_file(char const *src, char const *dst) {
+        FILE *in = fopen(src, "rb");
+        if (!in)
+                return 1;
+        fseek(in, 0, SEEK_END);
+        long half = ftell(in) / 2;
+        fseek(in, 0, SEEK_SET);
+        char buf[4096];
+        long done = 0;
+        int res = 1;
+        gzFile out = gzopen(dst, "wb");
+        if (!out)
+                goto error;
+        size_t got;
+        while ((got = fread(buf, 1, sizeof(buf), in))) {
+                if (done < half && done + (long)got >= half) {
+                        size_t first = half - done;
+                        gzwrite(out, buf, first);
+                        gzclose(out);
+                        out = gzopen(dst, "ab");
+                        if (!out)
+                                goto error;
+                        gzwrite(out, buf + first, got - first);
+                } else {
+                        gzwrite(out, buf, got);
+                }
+                gzflush(out, Z_PARTIAL_FLUSH);
+                done += got;
+        }
+        res = gzclose(out) != Z_OK;
+error:
+        fclose(in);
+        return res;
+}
+
+static int same_trace(SeisTrace *ta, SeisTrace *tb) {
+        int res = ta && tb;
+        if (res) {
+                long long num = seis_trace_get_samples_num(ta);
+                res = num == seis_trace_get_samples_num(tb) &&
+                      !memcmp(seis_trace_get_samples_const(ta),
+                              seis_trace_get_samples_const(tb),
+                              num * sizeof(double));
+        }
+        seis_trace_unref(&ta);
+        seis_trace_unref(&tb);
+        return res;
+}
+
+/* random reads go backwards to make decompressor restart */
+static int check_random(SeisISegy const *plain, SeisISegy const *gz,
+                        size_t traces_num) {
+        SeisSegyErr perr, gerr;
+        for (size_t i = traces_num; i-- > 0;) {
+                size_t offset = seis_isegy_get_trace_offset(plain, i);
+                if (!same_trace(
+                        seis_isegy_read_trace_at(plain, offset, NULL, &perr),
+                        seis_isegy_read_trace_at(gz, offset, NULL, &gerr)))
+                        return 1;
+        }
+        return 0;
+}
+
+int main(int argc, char *argv[]) {
+        char *gz_name = NULL, *idx_name = NULL;
+        SeisSegyBackend *b = NULL;
+        SeisISegy *small = NULL;
+        if (argc < 2)
+                return 1;
+        SeisISegy *plain = seis_isegy_new();
+        if (!plain)
+                return 1;
+        SeisISegy *gz = seis_isegy_new();
+        if (!gz)
+                return 1;
+        SeisSegyErr const *perr = seis_isegy_get_error(plain);
+        SeisSegyErr const *gerr = seis_isegy_get_error(gz);
+        size_t size = strlen(argv[1]) + strlen("_tmp.gz.idx") + 1;
+        gz_name = (char *)malloc(size);
+        idx_name = (char *)malloc(size);
+        if (!gz_name || !idx_name)
+                goto error;
+        strcpy(gz_name, argv[1]);
+        strcat(gz_name, "_tmp.gz");
+        strcpy(idx_name, gz_name);
+        strcat(idx_name, ".idx");
+        remove(idx_name);
+        if (compress_file(argv[1], gz_name))
+                goto error;
+        seis_isegy_open(plain, argv[1]);
+        if (perr->code)
+                goto error;
+        seis_isegy_set_seek_index(gz, idx_name);
+        seis_isegy_open(gz, gz_name);
+        if (gerr->code)
+                goto error;
+        size_t traces_num = 0;
+        while (!seis_isegy_end_of_data(plain)) {
+                if (seis_isegy_end_of_data(gz))
+                        goto error;
+                if (!same_trace(seis_isegy_read_trace(plain),
+                                seis_isegy_read_trace(gz)))
+                        goto error;
+                ++traces_num;
+        }
+        if (!seis_isegy_end_of_data(gz))
+                goto error;
+        if (check_random(plain, gz, traces_num))
+                goto error;
+        /* saved index is used by next reader */
+        seis_isegy_unref(&gz);
+        gz = seis_isegy_new();
+        if (!gz)
+                goto error;
+        gerr = seis_isegy_get_error(gz);
+        seis_isegy_set_seek_index(gz, idx_name);
+        seis_isegy_open(gz, gz_name);
+        if (gerr->code || check_random(plain, gz, traces_num))
+                goto error;
+        /* many saved states in small file */
+        b = seis_segy_backend_gzip_new(gz_name, NULL, 16384);
+        small = seis_isegy_new();
+        if (!b || !small)
+                goto error;
+        seis_isegy_open_backend(small, b);
+        if (seis_isegy_get_error(small)->code ||
+            check_random(plain, small, traces_num))
+                goto error;
+        remove(gz_name);
+        remove(idx_name);
+        free(gz_name);
+        free(idx_name);
+        seis_segy_backend_unref(&b);
+        seis_isegy_unref(&small);
+        seis_isegy_unref(&plain);
+        seis_isegy_unref(&gz);
+        return 0;
+error:
+        if (gz)
+                printf("%s\n%s\n", perr->message, gerr->message);
+        if (gz_name)
+                remove(gz_name);
+        if (idx_name)
+                remove(idx_name);
+        free(gz_name);
+        free(idx_name);
+        seis_segy_backend_unref(&b);
+        seis_isegy_unref(&small);
+        seis_isegy_unref(&plain);
+        seis_isegy_unref(&gz);
+        return 1;
+}
@@ -0,0 +1,96 @@
+#include "SeisISegy.h"
+#include "SeisSegyLazyHeader.h"
+#include <SeisTrace.h>
+#include <stdio.h>
+#include <string.h>
+
+static char const *const names[] = {"TRC_SEQ_LINE", "FFID", "CHAN", "OFFSET",
+                                    "CDP_X",        "CDP_Y", "SAMP_NUM"};
+
+#define NAMES_NUM (sizeof(names) / sizeof(names[0]))
+
+static int same_int(long long const *l, SeisTraceHeader const *ref,
+                    char const *name) {
+        long long const *r =
+            seis_trace_header_value_get_int(seis_trace_header_get(ref, name));
+        return l && r && *l == *r;
+}
+
+/* lazy fields should match eagerly decoded header */
+static int check(SeisSegyLazyHeader *lazy, SeisTraceHeader const *ref) {
+        for (size_t i = 0; i < NAMES_NUM; ++i) {
+                /* second call is served from cache */
+                if (!same_int(seis_segy_lazy_header_get_int(lazy, names[i]),
+                              ref, names[i]) ||
+                    !same_int(seis_segy_lazy_header_get_int(lazy, names[i]),
+                              ref, names[i]))
+                        return 1;
+                if (seis_segy_lazy_header_get_real(lazy, names[i]))
+                        return 1;
+        }
+        if (seis_segy_lazy_header_get_int(lazy, "NO_SUCH_FIELD"))
+                return 1;
+        SeisTraceHeader *full = seis_segy_lazy_header_decode(lazy);
+        if (!full)
+                return 1;
+        int result = 0;
+        for (size_t i = 0; i < NAMES_NUM; ++i)
+                if (!same_int(seis_trace_header_value_get_int(
+                                  seis_trace_header_get(full, names[i])),
+                              ref, names[i]))
+                        result = 1;
+        seis_trace_header_unref(&full);
+        return result;
+}
+
+int main(int argc, char *argv[]) {
+        int result = 1;
+        SeisSegyLazyHeader *lazy = NULL, *first = NULL;
+        SeisTraceHeader *ref = NULL;
+        if (argc < 2)
+                return 1;
+        SeisISegy *eager = seis_isegy_new();
+        SeisISegy *sgy = seis_isegy_new();
+        if (!eager || !sgy)
+                goto exit;
+        seis_isegy_open(eager, argv[1]);
+        seis_isegy_open(sgy, argv[1]);
+        if (seis_isegy_get_error(eager)->code ||
+            seis_isegy_get_error(sgy)->code)
+                goto exit;
+        size_t traces_num = 0;
+        while (!seis_isegy_end_of_data(sgy)) {
+                lazy = seis_isegy_read_lazy_header(sgy);
+                ref = seis_isegy_read_trace_header(eager);
+                if (!lazy || !ref || check(lazy, ref))
+                        goto exit;
+                size_t size;
+                char const *raw = seis_segy_lazy_header_get_raw(lazy, &size);
+                if (size < SEIS_SEGY_TRACE_HEADER_SIZE || !raw)
+                        goto exit;
+                if (!first)
+                        first = seis_segy_lazy_header_ref(lazy);
+                seis_segy_lazy_header_unref(&lazy);
+                seis_trace_header_unref(&ref);
+                ++traces_num;
+        }
+        if (!traces_num || !seis_isegy_end_of_data(eager))
+                goto exit;
+        /* header keeps its layout after remap and reader destruction */
+        seis_isegy_remap_trace_header(sgy, "FFID", 1, 1, i32);
+        seis_isegy_unref(&sgy);
+        seis_isegy_rewind(eager);
+        ref = seis_isegy_read_trace_header(eager);
+        if (!ref || check(first, ref))
+                goto exit;
+        result = 0;
+exit:
+        if (result)
+                printf("lazy header differs from decoded one\n");
+        seis_segy_lazy_header_unref(&lazy);
+        seis_segy_lazy_header_unref(&first);
+        seis_trace_header_unref(&ref);
+        seis_isegy_unref(&eager);
+        seis_isegy_unref(&sgy);
+        return result;
+}
@@ -0,0 +1,69 @@
+#include "SeisISegy.h"
+#include <SeisTrace.h>
+#include <stdio.h>
+#include <string.h>
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        SeisISegy *file_sgy = seis_isegy_new();
+        if (!file_sgy)
+                return 1;
+        SeisISegy *map_sgy = seis_isegy_new();
+        if (!map_sgy)
+                return 1;
+        SeisSegyErr const *ferr = seis_isegy_get_error(file_sgy);
+        SeisSegyErr const *merr = seis_isegy_get_error(map_sgy);
+        SeisTrace *ftrc = NULL, *mtrc = NULL;
+        seis_isegy_open(file_sgy, argv[1]);
+        if (ferr->code)
+                goto error;
+        seis_isegy_set_io_mode(map_sgy, SEIS_SEGY_IO_MMAP);
+        seis_isegy_open(map_sgy, argv[1]);
+        if (merr->code)
+                goto error;
+        size_t first = seis_isegy_get_offset(map_sgy);
+        while (!seis_isegy_end_of_data(file_sgy)) {
+                if (seis_isegy_end_of_data(map_sgy))
+                        goto error;
+                ftrc = seis_isegy_read_trace(file_sgy);
+                if (ferr->code)
+                        goto error;
+                mtrc = seis_isegy_read_trace(map_sgy);
+                if (merr->code)
+                        goto error;
+                long long num = seis_trace_get_samples_num(ftrc);
+                if (num != seis_trace_get_samples_num(mtrc))
+                        goto error;
+                if (memcmp(seis_trace_get_samples_const(ftrc),
+                           seis_trace_get_samples_const(mtrc),
+                           num * sizeof(double)))
+                        goto error;
+                seis_trace_unref(&ftrc);
+                seis_trace_unref(&mtrc);
+        }
+        if (!seis_isegy_end_of_data(map_sgy))
+                goto error;
+        /* indexed access goes back to the first trace */
+        seis_isegy_set_access_hint(map_sgy, SEIS_SEGY_ACCESS_RANDOM);
+        seis_isegy_set_offset(map_sgy, first);
+        mtrc = seis_isegy_read_trace(map_sgy);
+        if (merr->code)
+                goto error;
+        SeisTraceHeaderValue v = seis_trace_header_get(
+            seis_trace_get_header_const(mtrc), "TRC_SEQ_LINE");
+        long long const *seq = seis_trace_header_value_get_int(v);
+        if (!seq || *seq != 1)
+                goto error;
+        seis_trace_unref(&mtrc);
+        seis_isegy_unref(&file_sgy);
+        seis_isegy_unref(&map_sgy);
+        return 0;
+error:
+        seis_trace_unref(&ftrc);
+        seis_trace_unref(&mtrc);
+        printf("%s\n%s\n", ferr->message, merr->message);
+        seis_isegy_unref(&file_sgy);
+        seis_isegy_unref(&map_sgy);
+        return 1;
+}
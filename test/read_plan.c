@@ -0,0 +1,76 @@
+#include "SeisISegy.h"
+#include "SeisISegyReadPlan.h"
+#include "ref_traces.h"
+#include <SeisTrace.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int check_plan(SeisISegy *sgy, RefTraces const *refs,
+                      size_t const *indices, size_t num, size_t max_gap,
+                      size_t ranges_num) {
+        SeisTrace *trc = NULL;
+        SeisISegyReadPlan *plan =
+            seis_isegy_read_plan_new(sgy, indices, num, max_gap);
+        if (!plan)
+                return 1;
+        SeisSegyErr const *err = seis_isegy_read_plan_get_error(plan);
+        if (seis_isegy_read_plan_get_ranges_num(plan) != ranges_num)
+                goto error;
+        for (size_t i = 0; i < num; ++i) {
+                if (seis_isegy_read_plan_end(plan))
+                        goto error;
+                trc = seis_isegy_read_plan_next(plan);
+                if (ref_traces_compare(trc, refs->traces[indices[i]]))
+                        goto error;
+                seis_trace_unref(&trc);
+        }
+        if (!seis_isegy_read_plan_end(plan) || seis_isegy_read_plan_next(plan))
+                goto error;
+        seis_isegy_read_plan_unref(&plan);
+        return 0;
+error:
+        printf("%s\n", err->message);
+        seis_trace_unref(&trc);
+        seis_isegy_read_plan_unref(&plan);
+        return 1;
+}
+
+static int check(SeisISegy *sgy, RefTraces const *refs) {
+        size_t num = refs->num;
+        if (num < 4 || num % 7 == 0)
+                return 1;
+        size_t *indices = malloc(num * sizeof(size_t));
+        if (!indices)
+                return 1;
+        int result = 1;
+        /* every trace in scattered order gives single range */
+        for (size_t i = 0; i < num; ++i)
+                indices[i] = (i * 7 + 3) % num;
+        if (check_plan(sgy, refs, indices, num, 0, 1))
+                goto exit;
+        /* every other trace, with and without merging of gaps */
+        size_t half = 0;
+        for (size_t i = num - 1; i < num; i -= 2)
+                indices[half++] = i;
+        if (check_plan(sgy, refs, indices, half, 0, half))
+                goto exit;
+        if (check_plan(sgy, refs, indices, half,
+                       seis_isegy_get_trace_offset(sgy, 1) -
+                           seis_isegy_get_trace_offset(sgy, 0),
+                       1))
+                goto exit;
+        /* repeated trace */
+        indices[1] = indices[0];
+        if (check_plan(sgy, refs, indices, 2, 0, 1))
+                goto exit;
+        result = 0;
+exit:
+        free(indices);
+        return result;
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        return ref_traces_check_modes(argv[1], check);
+}
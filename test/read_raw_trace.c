@@ -0,0 +1,60 @@
+#include "SeisISegy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* raw record should be byte copy of file */
+int main(int argc, char *argv[]) {
+        char *buf = NULL;
+        FILE *file = NULL;
+        if (argc < 2)
+                return 1;
+        SeisISegy *sgy = seis_isegy_new();
+        if (!sgy)
+                return 1;
+        SeisSegyErr const *err = seis_isegy_get_error(sgy);
+        seis_isegy_open(sgy, argv[1]);
+        if (err->code)
+                goto error;
+        SeisSegyBinHdr const *bh = seis_isegy_get_binary_header(sgy);
+        file = fopen(argv[1], "rb");
+        if (!file)
+                goto error;
+        SeisSegyRawTrace raw;
+        size_t traces = 0;
+        while (!seis_isegy_end_of_data(sgy)) {
+                size_t offset = seis_isegy_get_offset(sgy);
+                if (seis_isegy_read_raw_trace(sgy, &raw))
+                        goto error;
+                if (raw.format_code != bh->format_code ||
+                    raw.samp_num != bh->samp_per_tr ||
+                    raw.headers_size !=
+                        SEIS_SEGY_TRACE_HEADER_SIZE *
+                            (size_t)(1 + bh->max_num_add_tr_headers))
+                        goto error;
+                size_t size = raw.headers_size + raw.samples_size;
+                buf = (char *)realloc(buf, size);
+                if (!buf || fseek(file, offset, SEEK_SET) ||
+                    fread(buf, 1, size, file) != size)
+                        goto error;
+                if (memcmp(buf, raw.headers, raw.headers_size) ||
+                    memcmp(buf + raw.headers_size, raw.samples,
+                           raw.samples_size))
+                        goto error;
+                ++traces;
+        }
+        /* test files are big endian */
+        if (!traces || !raw.big_endian)
+                goto error;
+        fclose(file);
+        free(buf);
+        seis_isegy_unref(&sgy);
+        return 0;
+error:
+        printf("%s\n", err->message);
+        if (file)
+                fclose(file);
+        free(buf);
+        seis_isegy_unref(&sgy);
+        return 1;
+}
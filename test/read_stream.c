@@ -0,0 +1,107 @@
+#include "SeisISegy.h"
+#include "SeisSegyBackend.h"
+#include <SeisTrace.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+struct feed {
+        char const *file_name;
+        int fd;
+};
+
+/* writes file to pipe in small pieces like slow producer would do */
+static void *feed_pipe(void *arg) {
+        struct feed *f = (struct feed *)arg;
+        char buf[1000];
+        FILE *file = fopen(f->file_name, "rb");
+        if (file) {
+                size_t got;
+                while ((got = fread(buf, 1, sizeof(buf), file)))
+                        if (write(f->fd, buf, got) != (ssize_t)got)
+                                break;
+                fclose(file);
+        }
+        close(f->fd);
+        return NULL;
+}
+
+static int same_trace(SeisISegy *a, SeisISegy *b) {
+        SeisTrace *ta = seis_isegy_read_trace(a);
+        SeisTrace *tb = seis_isegy_read_trace(b);
+        int res = ta && tb;
+        if (res) {
+                long long num = seis_trace_get_samples_num(ta);
+                res = num == seis_trace_get_samples_num(tb) &&
+                      !memcmp(seis_trace_get_samples_const(ta),
+                              seis_trace_get_samples_const(tb),
+                              num * sizeof(double));
+        }
+        seis_trace_unref(&ta);
+        seis_trace_unref(&tb);
+        return res;
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        int fds[2];
+        if (pipe(fds))
+                return 1;
+        struct feed f = {argv[1], fds[1]};
+        pthread_t feeder;
+        if (pthread_create(&feeder, NULL, feed_pipe, &f))
+                return 1;
+        SeisSegyBackend *b = seis_segy_backend_stream_new(fds[0], true);
+        if (!b)
+                return 1;
+        SeisISegy *plain = seis_isegy_new();
+        if (!plain)
+                return 1;
+        SeisISegy *stream = seis_isegy_new();
+        if (!stream)
+                return 1;
+        SeisSegyErr const *perr = seis_isegy_get_error(plain);
+        SeisSegyErr const *serr = seis_isegy_get_error(stream);
+        seis_isegy_open(plain, argv[1]);
+        if (perr->code)
+                goto error;
+        /* buffer smaller than trace makes stream buffer grow */
+        seis_isegy_set_buffer_size(stream, 301);
+        seis_isegy_open_backend(stream, b);
+        if (serr->code)
+                goto error;
+        SeisSegyErr err;
+        SeisTrace *trc = seis_isegy_read_trace_at(
+            stream, seis_isegy_get_trace_offset(stream, 0), NULL, &err);
+        if (trc || !err.code)
+                goto error;
+        while (!seis_isegy_end_of_data(plain)) {
+                if (seis_isegy_end_of_data(stream))
+                        goto error;
+                if (!same_trace(plain, stream))
+                        goto error;
+        }
+        if (!seis_isegy_end_of_data(stream) || serr->code)
+                goto error;
+        if (seis_isegy_get_stanzas_num(plain) !=
+            seis_isegy_get_stanzas_num(stream))
+                goto error;
+        /* stream can't go back */
+        seis_isegy_rewind(stream);
+        if (seis_isegy_read_trace(stream) || !serr->code)
+                goto error;
+        pthread_join(feeder, NULL);
+        seis_segy_backend_unref(&b);
+        seis_isegy_unref(&plain);
+        seis_isegy_unref(&stream);
+        return 0;
+error:
+        printf("%s\n%s\n", perr->message, serr->message);
+        pthread_join(feeder, NULL);
+        seis_segy_backend_unref(&b);
+        seis_isegy_unref(&plain);
+        seis_isegy_unref(&stream);
+        return 1;
+}
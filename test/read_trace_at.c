@@ -0,0 +1,64 @@
+#include "SeisISegy.h"
+#include "ref_traces.h"
+#include <SeisTrace.h>
+#include <pthread.h>
+#include <stdio.h>
+
+#define THREADS_NUM 4
+
+struct job {
+        SeisISegy const *sgy;
+        RefTraces const *refs;
+        int idx;
+        int failed;
+};
+
+static void *worker(void *arg) {
+        struct job *job = (struct job *)arg;
+        RefTraces const *refs = job->refs;
+        SeisSegyErr err;
+        for (size_t i = job->idx; i < refs->num; i += THREADS_NUM) {
+                size_t next;
+                SeisTrace *trc = seis_isegy_read_trace_at(
+                    job->sgy, refs->offsets[i], &next, &err);
+                int bad = ref_traces_compare(trc, refs->traces[i]);
+                if (i + 1 < refs->num && next != refs->offsets[i + 1])
+                        bad = 1;
+                seis_trace_unref(&trc);
+                if (bad)
+                        goto error;
+        }
+        return NULL;
+error:
+        job->failed = 1;
+        return NULL;
+}
+
+static int check(SeisISegy *sgy, RefTraces const *refs) {
+        for (size_t i = 0; i < refs->num; ++i)
+                if (refs->offsets[i] != seis_isegy_get_trace_offset(sgy, i))
+                        return 1;
+        pthread_t threads[THREADS_NUM];
+        struct job jobs[THREADS_NUM];
+        for (int i = 0; i < THREADS_NUM; ++i) {
+                jobs[i] = (struct job){sgy, refs, i, 0};
+                pthread_create(&threads[i], NULL, worker, &jobs[i]);
+        }
+        int failed = 0;
+        for (int i = 0; i < THREADS_NUM; ++i) {
+                pthread_join(threads[i], NULL);
+                failed |= jobs[i].failed;
+        }
+        /* positional reads must not move sequential cursor */
+        if (!seis_isegy_end_of_data(sgy))
+                failed = 1;
+        if (failed)
+                printf("positional reading differs\n");
+        return failed;
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        return ref_traces_check_modes(argv[1], check);
+}
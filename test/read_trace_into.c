@@ -0,0 +1,91 @@
+#include "SeisISegy.h"
+#include <SeisTrace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* trace read into caller buffers should match allocated one */
+static int compare(SeisTrace *trc, SeisTraceHeader const *hdr,
+                   double const *samples, size_t num) {
+        if ((long long)num != seis_trace_get_samples_num(trc))
+                return 1;
+        if (memcmp(samples, seis_trace_get_samples_const(trc),
+                   num * sizeof(double)))
+                return 1;
+        char const *names[] = {"TRC_SEQ_LINE", "FFID", "SOU_X", "SAMP_NUM"};
+        for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+                long long const *l = seis_trace_header_value_get_int(
+                    seis_trace_header_get(hdr, names[i]));
+                long long const *r = seis_trace_header_value_get_int(
+                    seis_trace_header_get(seis_trace_get_header(trc),
+                                          names[i]));
+                if (!l || !r || *l != *r)
+                        return 1;
+        }
+        return 0;
+}
+
+int main(int argc, char *argv[]) {
+        SeisTrace *trc = NULL;
+        SeisTraceHeader *hdr = NULL;
+        double *samples = NULL;
+        float *fsamples = NULL;
+        if (argc < 2)
+                return 1;
+        SeisISegy *sgy = seis_isegy_new();
+        SeisISegy *ref = seis_isegy_new();
+        if (!sgy || !ref)
+                return 1;
+        SeisSegyErr const *err = seis_isegy_get_error(sgy);
+        seis_isegy_open(sgy, argv[1]);
+        seis_isegy_open(ref, argv[1]);
+        if (err->code || seis_isegy_get_error(ref)->code)
+                goto error;
+        size_t capacity = seis_isegy_get_binary_header(sgy)->samp_per_tr;
+        samples = (double *)malloc(capacity * sizeof(double));
+        fsamples = (float *)malloc(capacity * sizeof(float));
+        hdr = seis_trace_header_new();
+        if (!samples || !fsamples || !hdr)
+                goto error;
+        size_t num, traces = 0;
+        while (!seis_isegy_end_of_data(sgy)) {
+                if (seis_isegy_read_trace_into(sgy, hdr, samples, capacity,
+                                               &num))
+                        goto error;
+                trc = seis_isegy_read_trace(ref);
+                if (!trc || compare(trc, hdr, samples, num))
+                        goto error;
+                seis_trace_unref(&trc);
+                ++traces;
+        }
+        seis_isegy_rewind(sgy);
+        while (!seis_isegy_end_of_data(sgy)) {
+                if (seis_isegy_read_trace_into_float(sgy, hdr, fsamples,
+                                                     capacity, &num))
+                        goto error;
+                --traces;
+        }
+        if (traces)
+                goto error;
+        /* too small buffer is reported with needed size */
+        seis_isegy_rewind(sgy);
+        if (seis_isegy_read_trace_into(sgy, hdr, samples, capacity - 1,
+                                       &num) != SEIS_SEGY_ERR_BAD_PARAMS ||
+            num != capacity)
+                goto error;
+        free(samples);
+        free(fsamples);
+        seis_trace_header_unref(&hdr);
+        seis_isegy_unref(&sgy);
+        seis_isegy_unref(&ref);
+        return 0;
+error:
+        printf("%s\n", err->message);
+        free(samples);
+        free(fsamples);
+        seis_trace_unref(&trc);
+        seis_trace_header_unref(&hdr);
+        seis_isegy_unref(&sgy);
+        seis_isegy_unref(&ref);
+        return 1;
+}
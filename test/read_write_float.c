@@ -0,0 +1,109 @@
+#include "SeisISegy.h"
+#include "SeisOSegy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* float samples should be rounded double samples */
+static int compare(SeisSegyFloatTrace const *ftrc, SeisTrace const *trc) {
+        long long num = seis_segy_float_trace_get_samples_num(ftrc);
+        if (num != seis_trace_get_samples_num(trc))
+                return 1;
+        float const *fs = seis_segy_float_trace_get_samples_const(ftrc);
+        double const *ds = seis_trace_get_samples_const(trc);
+        for (long long i = 0; i < num; ++i)
+                if (fs[i] != (float)ds[i]) {
+                        printf("sample %lld: %g != %g\n", i, fs[i], ds[i]);
+                        return 1;
+                }
+        return 0;
+}
+
+int main(int argc, char *argv[]) {
+        char *tmp_name = NULL;
+        if (argc < 2)
+                return 1;
+        SeisISegy *isgy = seis_isegy_new();
+        SeisISegy *dsgy = seis_isegy_new();
+        if (!isgy || !dsgy)
+                return 1;
+        SeisSegyErr const *ierr = seis_isegy_get_error(isgy);
+        SeisOSegy *osgy = seis_osegy_new();
+        if (!osgy)
+                return 1;
+        SeisSegyErr const *oerr = seis_osegy_get_error(osgy);
+        SeisSegyFloatTrace *ftrc = NULL;
+        SeisTrace *trc = NULL;
+        seis_isegy_open(isgy, argv[1]);
+        if (ierr->code)
+                goto error;
+        seis_isegy_open(dsgy, argv[1]);
+        if (seis_isegy_get_error(dsgy)->code)
+                goto error;
+        seis_osegy_set_text_header(osgy, seis_isegy_get_text_header(isgy, 0));
+        seis_osegy_set_binary_header(osgy, seis_isegy_get_binary_header(isgy));
+        char const *tmp_suffix = "_tmp_output_float";
+        tmp_name = (char *)malloc(strlen(tmp_suffix) + strlen(argv[1]) + 1);
+        if (!tmp_name)
+                goto error;
+        strcpy(tmp_name, argv[1]);
+        strcat(tmp_name, tmp_suffix);
+        seis_osegy_open(osgy, tmp_name);
+        if (oerr->code)
+                goto error;
+        while (!seis_isegy_end_of_data(isgy)) {
+                ftrc = seis_isegy_read_trace_float(isgy);
+                if (ierr->code)
+                        goto error;
+                trc = seis_isegy_read_trace(dsgy);
+                if (!trc || compare(ftrc, trc))
+                        goto error;
+                seis_osegy_write_trace_float(osgy, ftrc);
+                if (oerr->code)
+                        goto error;
+                seis_segy_float_trace_unref(&ftrc);
+                seis_trace_unref(&trc);
+        }
+        seis_isegy_unref(&isgy);
+        seis_isegy_unref(&dsgy);
+        seis_osegy_unref(&osgy);
+        /* samples of tested formats are exact in float */
+        FILE *orig_file = fopen(argv[1], "rb");
+        if (!orig_file)
+                goto error;
+        FILE *test_file = fopen(tmp_name, "rb");
+        if (!test_file)
+                goto error;
+        int orig = 0, test = 0;
+        size_t counter = 0;
+        do {
+                orig = fgetc(orig_file);
+                test = fgetc(test_file);
+                ++counter;
+                if (orig != test) {
+                        printf("Not equal: %zd\nOrig: %d, Test: %d\n", counter,
+                               orig, test);
+                        goto error;
+                }
+        } while (orig != EOF);
+        fclose(orig_file);
+        fclose(test_file);
+        remove(tmp_name);
+        free(tmp_name);
+        return 0;
+error:
+        seis_segy_float_trace_unref(&ftrc);
+        seis_trace_unref(&trc);
+        if (isgy && osgy) {
+                if (ierr->code)
+                        printf("%s\n", ierr->message);
+                else
+                        printf("%s\n", oerr->message);
+        }
+        seis_isegy_unref(&isgy);
+        seis_isegy_unref(&dsgy);
+        seis_osegy_unref(&osgy);
+        if (tmp_name)
+                free(tmp_name);
+        return 1;
+}
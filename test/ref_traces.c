@@ -0,0 +1,72 @@
+#include "ref_traces.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void free_refs(RefTraces *refs) {
+        for (size_t i = 0; i < refs->num; ++i)
+                seis_trace_unref(&refs->traces[i]);
+        free(refs->traces);
+        free(refs->offsets);
+}
+
+static int check_mode(char const *file_name, SeisSegyIOMode mode,
+                      RefTracesCheck check) {
+        int result = 1;
+        RefTraces refs = {NULL, NULL, 0};
+        size_t capacity = 0;
+        SeisISegy *sgy = seis_isegy_new();
+        if (!sgy)
+                return 1;
+        SeisSegyErr const *err = seis_isegy_get_error(sgy);
+        seis_isegy_set_io_mode(sgy, mode);
+        seis_isegy_open(sgy, file_name);
+        if (err->code)
+                goto exit;
+        while (!seis_isegy_end_of_data(sgy)) {
+                if (refs.num == capacity) {
+                        capacity = capacity ? capacity * 2 : 64;
+                        void *res = realloc(refs.traces,
+                                            capacity * sizeof(SeisTrace *));
+                        if (!res)
+                                goto exit;
+                        refs.traces = (SeisTrace **)res;
+                        res = realloc(refs.offsets, capacity * sizeof(size_t));
+                        if (!res)
+                                goto exit;
+                        refs.offsets = (size_t *)res;
+                }
+                refs.offsets[refs.num] = seis_isegy_get_offset(sgy);
+                refs.traces[refs.num] = seis_isegy_read_trace(sgy);
+                if (err->code)
+                        goto exit;
+                ++refs.num;
+        }
+        result = check(sgy, &refs);
+exit:
+        if (err->code)
+                printf("%s\n", err->message);
+        free_refs(&refs);
+        seis_isegy_unref(&sgy);
+        return result;
+}
+
+int ref_traces_check_modes(char const *file_name, RefTracesCheck check) {
+        return check_mode(file_name, SEIS_SEGY_IO_STDIO, check) ||
+               check_mode(file_name, SEIS_SEGY_IO_MMAP, check);
+}
+
+int ref_traces_compare(SeisTrace const *trc, SeisTrace const *ref) {
+        long long num = seis_trace_get_samples_num(ref);
+        if (!trc || num != seis_trace_get_samples_num(trc))
+                return 1;
+        if (memcmp(seis_trace_get_samples_const(trc),
+                   seis_trace_get_samples_const(ref), num * sizeof(double)))
+                return 1;
+        char const *name = "TRC_SEQ_LINE";
+        long long const *l = seis_trace_header_value_get_int(
+            seis_trace_header_get(seis_trace_get_header_const(trc), name));
+        long long const *r = seis_trace_header_value_get_int(
+            seis_trace_header_get(seis_trace_get_header_const(ref), name));
+        return !l || !r || *l != *r;
+}
@@ -0,0 +1,26 @@
+#ifndef REF_TRACES_H
+#define REF_TRACES_H
+
+#include "SeisISegy.h"
+#include <SeisTrace.h>
+#include <stddef.h>
+
+/* Traces of file read one by one, reference for other ways of reading.
+ * Offsets are positions of traces in file. */
+typedef struct RefTraces {
+        SeisTrace **traces;
+        size_t *offsets;
+        size_t num;
+} RefTraces;
+
+/* checks reader opened in some mode against references, reader is at end
+ * of data. Returns 0 on success. */
+typedef int (*RefTracesCheck)(SeisISegy *sgy, RefTraces const *refs);
+
+/* reads references and runs check for stdio and mapped reading */
+int ref_traces_check_modes(char const *file_name, RefTracesCheck check);
+
+/* 0 if trace has same samples and sequence number as reference */
+int ref_traces_compare(SeisTrace const *trc, SeisTrace const *ref);
+
+#endif /* REF_TRACES_H */
@@ -0,0 +1,229 @@
+#include "SeisISegy.h"
+#include <SeisTrace.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMP_NUM 61
+#define TRACES_NUM 3
+
+struct format {
+        int code;
+        int size;
+        bool is_signed;
+        bool is_float;
+};
+
+static struct format const formats[] = {
+    {1, 4, true, false},   {2, 4, true, false},   {3, 2, true, false},
+    {4, 4, true, false},   {5, 4, true, true},    {6, 8, true, true},
+    {7, 3, true, false},   {8, 1, true, false},   {9, 8, true, false},
+    {10, 4, false, false}, {11, 2, false, false}, {12, 8, false, false},
+    {15, 3, false, false}, {16, 1, false, false}};
+
+static bool host_is_le(void) {
+        uint16_t one = 1;
+        char first;
+        memcpy(&first, &one, sizeof(first));
+        return first;
+}
+
+/* writes value of given size in host order, reversed if swap is set */
+static void put(unsigned char *dst, uint64_t v, int size, bool swap) {
+        unsigned char le[8];
+        for (int i = 0; i < 8; ++i)
+                le[i] = (unsigned char)(v >> (8 * i));
+        bool le_out = host_is_le() != swap;
+        for (int i = 0; i < size; ++i)
+                dst[i] = le_out ? le[i] : le[size - 1 - i];
+}
+
+/* integer pattern covering both ends of range of every type */
+static uint64_t raw_value(struct format const *f, size_t i) {
+        int bits = f->size * 8;
+        uint64_t mask = bits == 64 ? UINT64_MAX : (1ull << bits) - 1;
+        switch (i) {
+        case 0:
+                return 0;
+        case 1:
+                return mask;
+        case 2:
+                return mask >> 1;
+        case 3:
+                return (mask >> 1) + 1;
+        }
+        return (i * 0x9e3779b97f4a7c15ull ^ i << 11) & mask;
+}
+
+static double expected(struct format const *f, size_t i, uint64_t *raw) {
+        uint64_t v = raw_value(f, i);
+        int bits = f->size * 8;
+        if (f->code == 1) {
+                /* integer in unnormalized IBM form, 16^6 cancels fraction */
+                int32_t n = (int32_t)(v & 0xffffff) - 0x800000;
+                *raw = (uint64_t)(n < 0) << 31 | 70u << 24 |
+                       (uint32_t)(n < 0 ? -n : n);
+                return n;
+        }
+        if (f->code == 4) {
+                /* fixed point, top byte is zero, gain is next one */
+                *raw = v & 0xffffff;
+                double d = (int16_t)(v & 0xffff);
+                for (int gain = (int)(*raw >> 16); gain; --gain)
+                        d /= 2;
+                return d;
+        }
+        *raw = v;
+        if (f->is_float) {
+                double d = ((double)i - SAMP_NUM) * 0.37;
+                if (f->size == 4) {
+                        float fl = (float)d;
+                        uint32_t b;
+                        memcpy(&b, &fl, sizeof(b));
+                        *raw = b;
+                        return fl;
+                }
+                memcpy(raw, &d, sizeof(d));
+                return d;
+        }
+        if (!f->is_signed)
+                return (double)v;
+        if (bits < 64 && v >> (bits - 1))
+                return (double)(int64_t)(v - (1ull << bits));
+        return (double)(int64_t)v;
+}
+
+static int write_file(char const *name, struct format const *f, bool swap) {
+        unsigned char hdr[3600] = {0};
+        memset(hdr, 0x40, 3200);
+        put(hdr + 3216, 1000, 2, swap);
+        put(hdr + 3220, SAMP_NUM, 2, swap);
+        put(hdr + 3224, f->code, 2, swap);
+        put(hdr + 3296, swap ? 0 : 0x01020304, 4, false);
+        FILE *out = fopen(name, "wb");
+        if (!out)
+                return 1;
+        fwrite(hdr, 1, sizeof(hdr), out);
+        for (size_t t = 0; t < TRACES_NUM; ++t) {
+                unsigned char trc[240 + SAMP_NUM * 8] = {0};
+                put(trc, t + 1, 4, swap);
+                for (size_t i = 0; i < SAMP_NUM; ++i) {
+                        uint64_t raw;
+                        expected(f, t * SAMP_NUM + i, &raw);
+                        put(trc + 240 + i * f->size, raw, f->size, swap);
+                }
+                fwrite(trc, 1, 240 + SAMP_NUM * f->size, out);
+        }
+        fclose(out);
+        return 0;
+}
+
+static int check(SeisTrace const *trc, struct format const *f, size_t t) {
+        double const *samples = seis_trace_get_samples_const(trc);
+        if (seis_trace_get_samples_num(trc) != SAMP_NUM)
+                return 1;
+        for (size_t i = 0; i < SAMP_NUM; ++i) {
+                uint64_t raw;
+                double ref = expected(f, t * SAMP_NUM + i, &raw);
+                if (memcmp(&ref, samples + i, sizeof(ref))) {
+                        printf("format %d sample %zu: %.17g != %.17g\n",
+                               f->code, i, samples[i], ref);
+                        return 1;
+                }
+        }
+        return 0;
+}
+
+/* float output is rounded once from exact value */
+static int check_float(SeisSegyFloatTrace const *trc, struct format const *f,
+                       size_t t) {
+        float const *samples = seis_segy_float_trace_get_samples_const(trc);
+        if (seis_segy_float_trace_get_samples_num(trc) != SAMP_NUM)
+                return 1;
+        for (size_t i = 0; i < SAMP_NUM; ++i) {
+                uint64_t raw = raw_value(f, t * SAMP_NUM + i);
+                double val = expected(f, t * SAMP_NUM + i, &raw);
+                float ref = (float)val;
+                /* 64 bit integers are rounded directly to float */
+                if (f->size == 8 && !f->is_float)
+                        ref = f->is_signed ? (float)(int64_t)raw : (float)raw;
+                if (memcmp(&ref, samples + i, sizeof(ref))) {
+                        printf("format %d float sample %zu: %.9g != %.9g\n",
+                               f->code, i, samples[i], ref);
+                        return 1;
+                }
+        }
+        return 0;
+}
+
+static int check_file(char const *name, struct format const *f) {
+        int result = 1;
+        SeisTrace *trc = NULL;
+        SeisISegy *sgy = seis_isegy_new();
+        if (!sgy)
+                return 1;
+        SeisSegyErr const *err = seis_isegy_get_error(sgy);
+        seis_isegy_open(sgy, name);
+        if (err->code)
+                goto error;
+        for (size_t t = 0; t < TRACES_NUM; ++t) {
+                trc = seis_isegy_read_trace(sgy);
+                if (!trc || check(trc, f, t))
+                        goto error;
+                seis_trace_unref(&trc);
+        }
+        seis_isegy_rewind(sgy);
+        for (size_t t = 0; t < TRACES_NUM; ++t) {
+                SeisSegyFloatTrace *ftrc = seis_isegy_read_trace_float(sgy);
+                int res = !ftrc || check_float(ftrc, f, t);
+                seis_segy_float_trace_unref(&ftrc);
+                if (res)
+                        goto error;
+        }
+        /* positional reading decodes in place */
+        SeisSegyErr perr;
+        for (size_t t = TRACES_NUM; t-- > 0;) {
+                trc = seis_isegy_read_trace_at(
+                    sgy, seis_isegy_get_trace_offset(sgy, t), NULL, &perr);
+                if (!trc || check(trc, f, t))
+                        goto error;
+                seis_trace_unref(&trc);
+        }
+        result = 0;
+error:
+        if (result && err->code)
+                printf("format %d: %s\n", f->code, err->message);
+        seis_trace_unref(&trc);
+        seis_isegy_unref(&sgy);
+        return result;
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        /* files are written next to sample file */
+        char *tmp_name =
+            (char *)malloc(strlen(argv[1]) + strlen("_tmp_formats") + 1);
+        if (!tmp_name)
+                return 1;
+        strcpy(tmp_name, argv[1]);
+        strcat(tmp_name, "_tmp_formats");
+        for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); ++i)
+                for (int swap = 0; swap < 2; ++swap) {
+                        if (write_file(tmp_name, formats + i, swap))
+                                goto error;
+                        int res = check_file(tmp_name, formats + i);
+                        remove(tmp_name);
+                        if (res) {
+                                printf("failed with swap %d\n", swap);
+                                goto error;
+                        }
+                }
+        free(tmp_name);
+        return 0;
+error:
+        free(tmp_name);
+        return 1;
+}
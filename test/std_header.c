@@ -0,0 +1,261 @@
+#include "SeisISegy.h"
+#include "SeisOSegy.h"
+#include "SeisSegyStdHeader.h"
+#include <SeisTrace.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIZE SEIS_SEGY_TRACE_HEADER_SIZE
+
+struct field {
+        char const *name;
+        size_t offset;
+        int size;
+};
+
+/* few fields of every size and sign to check names and offsets */
+static struct field const fields[] = {
+    {"TRC_SEQ_LINE", offsetof(SeisSegyStdHeader, trc_seq_line), 4},
+    {"FFID", offsetof(SeisSegyStdHeader, ffid), 4},
+    {"CHAN", offsetof(SeisSegyStdHeader, chan), 4},
+    {"TRACE_ID", offsetof(SeisSegyStdHeader, trace_id), 2},
+    {"OFFSET", offsetof(SeisSegyStdHeader, offset), 4},
+    {"COORD_SCALAR", offsetof(SeisSegyStdHeader, coord_scalar), 2},
+    {"SOU_X", offsetof(SeisSegyStdHeader, sou_x), 4},
+    {"REC_Y", offsetof(SeisSegyStdHeader, rec_y), 4},
+    {"SAMP_NUM", offsetof(SeisSegyStdHeader, samp_num), 2},
+    {"SAMP_INT", offsetof(SeisSegyStdHeader, samp_int), 2},
+    {"CDP_X", offsetof(SeisSegyStdHeader, cdp_x), 4},
+    {"CDP_Y", offsetof(SeisSegyStdHeader, cdp_y), 4},
+    {"INLINE", offsetof(SeisSegyStdHeader, iline), 4},
+    {"SOU_MEAS_UNIT", offsetof(SeisSegyStdHeader, sou_meas_unit), 2}};
+
+#define FIELDS_NUM (sizeof(fields) / sizeof(fields[0]))
+
+static long long member(SeisSegyStdHeader const *hdr, struct field const *f) {
+        char const *ptr = (char const *)hdr + f->offset;
+        if (f->size == 2) {
+                int16_t v;
+                memcpy(&v, ptr, sizeof(v));
+                return v;
+        }
+        int32_t v;
+        memcpy(&v, ptr, sizeof(v));
+        return v;
+}
+
+/* struct gives same values as header map and keeps all header bytes */
+static int check_read(char const *file_name) {
+        int result = 1;
+        SeisTraceHeader *ref = NULL;
+        SeisSegyStdHeader hdr;
+        SeisSegyRawTrace raw;
+        char buf[2 * SIZE];
+        SeisISegy *eager = seis_isegy_new();
+        SeisISegy *std = seis_isegy_new();
+        SeisISegy *rd = seis_isegy_new();
+        if (!eager || !std || !rd)
+                goto exit;
+        seis_isegy_open(eager, file_name);
+        seis_isegy_open(std, file_name);
+        seis_isegy_open(rd, file_name);
+        if (seis_isegy_get_error(eager)->code ||
+            seis_isegy_get_error(std)->code || seis_isegy_get_error(rd)->code)
+                goto exit;
+        while (!seis_isegy_end_of_data(std)) {
+                ref = seis_isegy_read_trace_header(eager);
+                if (!ref || seis_isegy_read_std_header(std, &hdr) ||
+                    seis_isegy_read_raw_trace(rd, &raw))
+                        goto exit;
+                for (size_t i = 0; i < FIELDS_NUM; ++i) {
+                        long long const *v = seis_trace_header_value_get_int(
+                            seis_trace_header_get(ref, fields[i].name));
+                        if (!v || *v != member(&hdr, fields + i)) {
+                                printf("%s differs\n", fields[i].name);
+                                goto exit;
+                        }
+                }
+                size_t size = raw.headers_size < 2 * SIZE ? raw.headers_size
+                                                           : 2 * SIZE;
+                if (!seis_segy_std_header_encode(&hdr, buf, size,
+                                                 raw.big_endian) ||
+                    memcmp(buf, raw.headers, SIZE))
+                        goto exit;
+                seis_trace_header_unref(&ref);
+        }
+        if (!seis_isegy_end_of_data(eager))
+                goto exit;
+        result = 0;
+exit:
+        seis_trace_header_unref(&ref);
+        seis_isegy_unref(&eager);
+        seis_isegy_unref(&std);
+        seis_isegy_unref(&rd);
+        return result;
+}
+
+static int copy_file(char const *in_name, char const *out_name,
+                     int32_t endianness) {
+        int result = 1;
+        SeisTrace *trc = NULL;
+        SeisSegyStdHeader hdr;
+        SeisISegy *smpls = seis_isegy_new();
+        SeisISegy *hdrs = seis_isegy_new();
+        SeisOSegy *out = seis_osegy_new();
+        if (!smpls || !hdrs || !out)
+                goto exit;
+        seis_isegy_open(smpls, in_name);
+        seis_isegy_open(hdrs, in_name);
+        if (seis_isegy_get_error(smpls)->code ||
+            seis_isegy_get_error(hdrs)->code)
+                goto exit;
+        SeisSegyBinHdr bh = *seis_isegy_get_binary_header(hdrs);
+        bh.endianness = endianness;
+        seis_osegy_set_text_header(out, seis_isegy_get_text_header(hdrs, 0));
+        seis_osegy_set_binary_header(out, &bh);
+        if (seis_osegy_open(out, out_name))
+                goto exit;
+        while (!seis_isegy_end_of_data(hdrs)) {
+                trc = seis_isegy_read_trace(smpls);
+                if (!trc || seis_isegy_read_std_header(hdrs, &hdr) ||
+                    seis_osegy_write_trace_std(
+                        out, &hdr, seis_trace_get_samples(trc),
+                        seis_trace_get_samples_num(trc)))
+                        goto exit;
+                seis_trace_unref(&trc);
+        }
+        result = 0;
+exit:
+        seis_trace_unref(&trc);
+        seis_isegy_unref(&smpls);
+        seis_isegy_unref(&hdrs);
+        seis_osegy_unref(&out);
+        return result;
+}
+
+/* written file has same headers and samples as original one */
+static int check_copy(char const *in_name, char const *out_name) {
+        int result = 1;
+        SeisTrace *a = NULL, *b = NULL;
+        SeisSegyRawTrace raw;
+        SeisSegyStdHeader ha, hb;
+        char ba[SIZE], bb[SIZE];
+        SeisISegy *in = seis_isegy_new();
+        SeisISegy *out = seis_isegy_new();
+        SeisISegy *in_raw = seis_isegy_new();
+        SeisISegy *out_raw = seis_isegy_new();
+        if (!in || !out || !in_raw || !out_raw)
+                goto exit;
+        seis_isegy_open(in, in_name);
+        seis_isegy_open(out, out_name);
+        seis_isegy_open(in_raw, in_name);
+        seis_isegy_open(out_raw, out_name);
+        if (seis_isegy_get_error(in)->code ||
+            seis_isegy_get_error(out)->code ||
+            seis_isegy_get_error(in_raw)->code ||
+            seis_isegy_get_error(out_raw)->code)
+                goto exit;
+        while (!seis_isegy_end_of_data(in)) {
+                a = seis_isegy_read_trace(in);
+                b = seis_isegy_read_trace(out);
+                if (!a || !b ||
+                    seis_trace_get_samples_num(a) !=
+                        seis_trace_get_samples_num(b) ||
+                    memcmp(seis_trace_get_samples(a), seis_trace_get_samples(b),
+                           seis_trace_get_samples_num(a) * sizeof(double)))
+                        goto exit;
+                if (seis_isegy_read_raw_trace(in_raw, &raw) ||
+                    !seis_segy_std_header_decode(&ha, raw.headers,
+                                                 raw.headers_size,
+                                                 raw.big_endian) ||
+                    seis_isegy_read_raw_trace(out_raw, &raw) ||
+                    !seis_segy_std_header_decode(&hb, raw.headers,
+                                                 raw.headers_size,
+                                                 raw.big_endian))
+                        goto exit;
+                /* compare in one byte order */
+                seis_segy_std_header_encode(&ha, ba, SIZE, true);
+                seis_segy_std_header_encode(&hb, bb, SIZE, true);
+                if (memcmp(ba, bb, SIZE))
+                        goto exit;
+                seis_trace_unref(&a);
+                seis_trace_unref(&b);
+        }
+        if (!seis_isegy_end_of_data(out))
+                goto exit;
+        result = 0;
+exit:
+        seis_trace_unref(&a);
+        seis_trace_unref(&b);
+        seis_isegy_unref(&in);
+        seis_isegy_unref(&out);
+        seis_isegy_unref(&in_raw);
+        seis_isegy_unref(&out_raw);
+        return result;
+}
+
+/* additional header survives round trip in both byte orders */
+static int check_ext(void) {
+        SeisSegyStdHeader hdr, res;
+        char buf[2 * SIZE];
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.ffid = -7;
+        hdr.samp_num = 1000;
+        memcpy(hdr.seg00000, "SEG00000", 8);
+        hdr.has_ext = true;
+        hdr.ext_trc_seq_line = 0x0102030405060708ull;
+        hdr.ext_ffid = -123456789012ll;
+        hdr.ext_samp_num = 70000;
+        hdr.ext_cdp_x_r = 1.5;
+        hdr.ext_cdp_y_r = -2.25;
+        hdr.ext_add_trc_hdr = 1;
+        memcpy(hdr.seg00001, "SEG00001", 8);
+        for (int big = 0; big < 2; ++big) {
+                if (!seis_segy_std_header_encode(&hdr, buf, sizeof(buf), big) ||
+                    !seis_segy_std_header_decode(&res, buf, sizeof(buf), big))
+                        return 1;
+                if (!res.has_ext || res.ffid != -7 || res.samp_num != 1000 ||
+                    res.ext_trc_seq_line != hdr.ext_trc_seq_line ||
+                    res.ext_ffid != hdr.ext_ffid ||
+                    res.ext_samp_num != 70000 || res.ext_cdp_x_r != 1.5 ||
+                    res.ext_cdp_y_r != -2.25 || res.ext_add_trc_hdr != 1 ||
+                    memcmp(res.seg00000, "SEG00000", 8) ||
+                    memcmp(res.seg00001, "SEG00001", 8))
+                        return 1;
+                /* most significant byte first in big endian */
+                unsigned char const *b = (unsigned char const *)buf + SIZE;
+                if (b[big ? 0 : 7] != 0x01 || b[big ? 7 : 0] != 0x08)
+                        return 1;
+        }
+        /* single header has no additional one */
+        if (!seis_segy_std_header_decode(&res, buf, SIZE, true) ||
+            res.has_ext || res.ext_trc_seq_line ||
+            seis_segy_std_header_decode(&res, buf, SIZE - 1, true))
+                return 1;
+        return 0;
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        if (check_read(argv[1]) || check_ext())
+                return 1;
+        char const *suffix = "_tmp_std";
+        char *tmp_name = (char *)malloc(strlen(argv[1]) + strlen(suffix) + 1);
+        if (!tmp_name)
+                return 1;
+        strcpy(tmp_name, argv[1]);
+        strcat(tmp_name, suffix);
+        int32_t const orders[] = {0, 0x01020304};
+        int result = 0;
+        for (size_t i = 0; i < 2 && !result; ++i)
+                result = copy_file(argv[1], tmp_name, orders[i]) ||
+                         check_copy(argv[1], tmp_name);
+        remove(tmp_name);
+        free(tmp_name);
+        if (result)
+                printf("copy with standard headers differs\n");
+        return result;
+}
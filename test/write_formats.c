@@ -0,0 +1,237 @@
+#include "SeisISegy.h"
+#include "SeisOSegy.h"
+#include <SeisTrace.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACES_NUM 2
+
+struct format {
+        int code;
+        int size;
+        bool is_signed;
+        bool is_float;
+};
+
+static struct format const formats[] = {
+    {2, 4, true, false},   {3, 2, true, false},   {4, 4, true, false},
+    {5, 4, true, true},    {6, 8, true, true},    {7, 3, true, false},
+    {8, 1, true, false},   {9, 8, true, false},   {10, 4, false, false},
+    {11, 2, false, false}, {12, 8, false, false}, {15, 3, false, false},
+    {16, 1, false, false}};
+
+static double const edge[] = {0.0,
+                              -0.0,
+                              /* rounding ties go to even */
+                              0.5,
+                              1.5,
+                              2.5,
+                              -0.5,
+                              -1.5,
+                              -2.5,
+                              4503599627370495.5,
+                              0x1p52 + 1,
+                              -0x1p53 - 2,
+                              /* both ends of every type */
+                              127.5,
+                              -128.5,
+                              255.5,
+                              32767.5,
+                              -32768.5,
+                              65535.5,
+                              8388607.5,
+                              -8388608.5,
+                              16777215.5,
+                              2147483647.5,
+                              -2147483648.5,
+                              4294967295.5,
+                              0x1p63,
+                              -0x1p63,
+                              0x1p64,
+                              -0x1p64,
+                              1e300,
+                              -1e300,
+                              INFINITY,
+                              -INFINITY,
+                              NAN,
+                              1e-300};
+
+/* edge values followed by random ones a bit wider than range of type,
+ * fixed point mantissa is 16 bits */
+static double value(struct format const *f, size_t i, bool single) {
+        size_t edge_num = sizeof(edge) / sizeof(edge[0]);
+        double v;
+        if (i < edge_num) {
+                v = edge[i];
+        } else {
+                uint64_t x = i * 0x9e3779b97f4a7c15ull;
+                x ^= x >> 31;
+                double u = (double)(x >> 11) * 0x1p-53;
+                v = ldexp(u * 2.5 - 1.25, f->code == 4 ? 16 : f->size * 8);
+        }
+        return single ? (float)v : v;
+}
+
+/* biggest gain with rounded mantissa in 16 bits, saturated at gain 0 */
+static uint64_t reference_fixp(double v) {
+        if (isnan(v))
+                return 0;
+        for (int gain = 255; gain > 0; --gain) {
+                double r = nearbyint(ldexp(v, gain));
+                if (fabs(r) <= 32767)
+                        return (uint64_t)gain << 16 | (uint16_t)(int16_t)r;
+        }
+        double r = nearbyint(v);
+        r = r > 32767 ? 32767 : r < -32768 ? -32768 : r;
+        return (uint16_t)(int16_t)r;
+}
+
+/* expected bits of encoded value in low bytes */
+static uint64_t reference(struct format const *f, double v) {
+        if (f->code == 4)
+                return reference_fixp(v);
+        if (f->is_float) {
+                if (f->size == 4) {
+                        float flt = (float)v;
+                        uint32_t bits;
+                        memcpy(&bits, &flt, sizeof(bits));
+                        return bits;
+                }
+                uint64_t bits;
+                memcpy(&bits, &v, sizeof(bits));
+                return bits;
+        }
+        int bits = f->size * 8;
+        double lo = f->is_signed ? -ldexp(1, bits - 1) : 0;
+        double hi = f->is_signed ? ldexp(1, bits - 1) : ldexp(1, bits);
+        uint64_t mask = bits == 64 ? UINT64_MAX : (1ull << bits) - 1;
+        if (isnan(v))
+                return 0;
+        double r = nearbyint(v);
+        if (r >= hi)
+                return f->is_signed ? mask >> 1 : mask;
+        if (r <= lo)
+                return f->is_signed ? (mask >> 1) + 1 : 0;
+        if (f->is_signed)
+                return (uint64_t)(int64_t)r & mask;
+        return (uint64_t)r;
+}
+
+static int write_file(char const *in_name, char const *out_name,
+                      struct format const *f, int32_t endianness,
+                      bool single) {
+        int result = 1;
+        SeisTrace *trc = NULL;
+        SeisSegyFloatTrace *ftrc = NULL;
+        SeisISegy *isgy = seis_isegy_new();
+        SeisOSegy *osgy = seis_osegy_new();
+        if (!isgy || !osgy)
+                goto exit;
+        seis_isegy_open(isgy, in_name);
+        if (seis_isegy_get_error(isgy)->code)
+                goto exit;
+        SeisSegyBinHdr bh = *seis_isegy_get_binary_header(isgy);
+        bh.format_code = f->code;
+        bh.endianness = endianness;
+        seis_osegy_set_text_header(osgy, seis_isegy_get_text_header(isgy, 0));
+        seis_osegy_set_binary_header(osgy, &bh);
+        seis_osegy_open(osgy, out_name);
+        if (seis_osegy_get_error(osgy)->code)
+                goto exit;
+        for (size_t t = 0; t < TRACES_NUM; ++t) {
+                size_t first = t * bh.samp_per_tr;
+                if (single) {
+                        ftrc = seis_isegy_read_trace_float(isgy);
+                        if (!ftrc)
+                                goto exit;
+                        float *s = seis_segy_float_trace_get_samples(ftrc);
+                        for (long i = 0; i < bh.samp_per_tr; ++i)
+                                s[i] = (float)value(f, first + i, true);
+                        if (seis_osegy_write_trace_float(osgy, ftrc))
+                                goto exit;
+                        seis_segy_float_trace_unref(&ftrc);
+                } else {
+                        trc = seis_isegy_read_trace(isgy);
+                        if (!trc)
+                                goto exit;
+                        double *s = seis_trace_get_samples(trc);
+                        for (long i = 0; i < bh.samp_per_tr; ++i)
+                                s[i] = value(f, first + i, false);
+                        if (seis_osegy_write_trace(osgy, trc))
+                                goto exit;
+                        seis_trace_unref(&trc);
+                }
+        }
+        result = 0;
+exit:
+        if (result && osgy)
+                printf("%s\n", seis_osegy_get_error(osgy)->message);
+        seis_trace_unref(&trc);
+        seis_segy_float_trace_unref(&ftrc);
+        seis_isegy_unref(&isgy);
+        seis_osegy_unref(&osgy);
+        return result;
+}
+
+static int check_file(char const *name, struct format const *f, bool single) {
+        int result = 1;
+        SeisISegy *sgy = seis_isegy_new();
+        if (!sgy)
+                return 1;
+        seis_isegy_open(sgy, name);
+        if (seis_isegy_get_error(sgy)->code)
+                goto exit;
+        SeisSegyRawTrace raw;
+        for (size_t t = 0; t < TRACES_NUM; ++t) {
+                if (seis_isegy_read_raw_trace(sgy, &raw) ||
+                    raw.format_code != f->code)
+                        goto exit;
+                for (long long i = 0; i < raw.samp_num; ++i) {
+                        unsigned char const *b =
+                            (unsigned char const *)raw.samples + i * f->size;
+                        uint64_t bits = 0;
+                        for (int j = 0; j < f->size; ++j)
+                                bits = bits << 8 |
+                                       b[raw.big_endian ? j : f->size - 1 - j];
+                        double v = value(f, t * raw.samp_num + i, single);
+                        if (bits != reference(f, v)) {
+                                printf("format %d %a: %llx != %llx\n",
+                                       f->code, v, (unsigned long long)bits,
+                                       (unsigned long long)reference(f, v));
+                                goto exit;
+                        }
+                }
+        }
+        result = 0;
+exit:
+        seis_isegy_unref(&sgy);
+        return result;
+}
+
+int main(int argc, char *argv[]) {
+        if (argc < 2)
+                return 1;
+        char const *suffix = "_tmp_formats";
+        char *tmp_name = (char *)malloc(strlen(argv[1]) + strlen(suffix) + 1);
+        if (!tmp_name)
+                return 1;
+        strcpy(tmp_name, argv[1]);
+        strcat(tmp_name, suffix);
+        int32_t const orders[] = {0, 0x01020304};
+        int result = 0;
+        size_t formats_num = sizeof(formats) / sizeof(formats[0]);
+        for (size_t f = 0; f < formats_num && !result; ++f)
+                for (size_t i = 0; i < 4 && !result; ++i) {
+                        bool single = i % 2;
+                        result = write_file(argv[1], tmp_name, &formats[f],
+                                            orders[i / 2], single) ||
+                                 check_file(tmp_name, &formats[f], single);
+                }
+        remove(tmp_name);
+        free(tmp_name);
+        return result;
+}